@@ -0,0 +1,69 @@
+/**
+ * @file    ctrl_rate.c
+ * @brief   多速率控制的速率管理实现
+ * @date    2026-02-19
+ */
+
+#include "ctrl_rate.h"
+
+uint8_t Ctrl_Decim_Step(Ctrl_Decim_t *d)
+{
+    if (++d->cnt >= d->div) {
+        d->cnt = 0;
+        return 1;
+    }
+    return 0;
+}
+
+void Ctrl_EventRate_Init(Ctrl_EventRate_t *r, uint16_t decim, float dt_nom, float dt_max, uint32_t cycles_per_s)
+{
+    r->decim        = (decim == 0) ? 1 : decim;
+    r->cnt          = 0;
+    r->dt_nom       = dt_nom;
+    r->dt_max       = dt_max;
+    r->cycles_per_s = cycles_per_s;
+    r->last         = 0;
+    r->started      = 0;
+    r->restart      = 1;
+    r->dt           = dt_nom;
+    r->dt_meas_max  = 0.0f;
+    r->events       = 0;
+    r->runs         = 0;
+}
+
+void Ctrl_EventRate_Reset(Ctrl_EventRate_t *r)
+{
+    r->started = 0;
+    r->cnt     = 0;
+}
+
+uint8_t Ctrl_EventRate_Step(Ctrl_EventRate_t *r, uint32_t now)
+{
+    r->events++;
+
+    /* 1. 降采样：重启后的第一帧立即执行，之后每 decim 帧执行一次 */
+    if (r->started && ++r->cnt < r->decim) {
+        return 0;
+    }
+    r->cnt = 0;
+
+    /* 2. 计算与上次执行的间隔 (32 位时间戳回绕由无符号减法处理) */
+    float dt = (float)(uint32_t)(now - r->last) / (float)r->cycles_per_s;
+
+    if (!r->started || dt > r->dt_max) {
+        /* 第一次执行或数据中断过久：按标称间隔计算，并通知调用者重置状态 */
+        r->restart = 1;
+        r->dt      = r->dt_nom;
+    } else {
+        r->restart = 0;
+        r->dt      = dt;
+        if (dt > r->dt_meas_max) {
+            r->dt_meas_max = dt;
+        }
+    }
+
+    r->started = 1;
+    r->last    = now;
+    r->runs++;
+    return 1;
+}
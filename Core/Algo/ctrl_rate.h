@@ -0,0 +1,74 @@
+/**
+ * @file    ctrl_rate.h
+ * @brief   多速率控制的速率管理 (定时分频 + 事件驱动的降采样与 dt 计算)
+ * @note    - 定时回路：以最快回路 (速度环) 的定时器节拍为基准，用 Ctrl_Decim_t
+ *            分频得到较慢的周期性工作
+ *          - 事件回路：外环由视觉数据帧驱动，Ctrl_EventRate_t 负责每 N 帧执行一次，
+ *            并用 DWT 时间戳算出两次执行的实际间隔 dt；间隔过长 (丢帧) 时标记重启，
+ *            由调用者清空 PID 历史
+ * @date    2026-02-19
+ */
+
+#ifndef __CTRL_RATE_H
+#define __CTRL_RATE_H
+
+#include <stdint.h>
+
+/**
+ * @brief 定时分频器
+ */
+typedef struct {
+    uint16_t div;       // 分频系数 (每 div 个节拍触发一次)
+    uint16_t cnt;       // 当前计数
+} Ctrl_Decim_t;
+
+#define CTRL_DECIM_INIT(div)    { (div), 0 }
+
+/**
+ * @brief 事件驱动回路的速率状态
+ */
+typedef struct {
+    uint16_t decim;         // 每 decim 个事件执行一次
+    uint16_t cnt;           // 距上次执行的事件数
+    float    dt_nom;        // 标称间隔 (s)，重启后第一次执行时使用
+    float    dt_max;        // 最大允许间隔 (s)，超过视为数据中断
+    uint32_t cycles_per_s;  // 时间戳频率 (DWT 即内核时钟)
+
+    uint32_t last;          // 上次执行时的时间戳
+    uint8_t  started;       // 已经执行过至少一次
+    uint8_t  restart;       // 本次执行是中断后的第一次 (需重置回路状态)
+    float    dt;            // 本次执行使用的间隔 (s)
+    float    dt_meas_max;   // 测得的最大间隔 (不含重启)
+
+    uint32_t events;        // 收到的事件总数
+    uint32_t runs;          // 实际执行次数
+} Ctrl_EventRate_t;
+
+/**
+ * @brief 分频器步进 (每个基准节拍调用一次)
+ * @return 1 本节拍需执行；0 跳过
+ */
+uint8_t Ctrl_Decim_Step(Ctrl_Decim_t *d);
+
+/**
+ * @brief 初始化事件驱动回路
+ * @param decim        每 decim 个事件执行一次 (0 按 1 处理)
+ * @param dt_nom       标称间隔 (s)
+ * @param dt_max       最大允许间隔 (s)
+ * @param cycles_per_s 时间戳频率
+ */
+void Ctrl_EventRate_Init(Ctrl_EventRate_t *r, uint16_t decim, float dt_nom, float dt_max, uint32_t cycles_per_s);
+
+/**
+ * @brief 下一次执行视为重启 (例如模式切换、目标丢失)
+ */
+void Ctrl_EventRate_Reset(Ctrl_EventRate_t *r);
+
+/**
+ * @brief 事件到达时调用
+ * @param now 当前时间戳 (DWT->CYCCNT)
+ * @return 1 本次需执行回路，r->dt / r->restart 已更新；0 被降采样跳过
+ */
+uint8_t Ctrl_EventRate_Step(Ctrl_EventRate_t *r, uint32_t now);
+
+#endif /* __CTRL_RATE_H */
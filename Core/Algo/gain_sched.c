@@ -0,0 +1,110 @@
+/**
+ * @file    gain_sched.c
+ * @brief   PID 增益调度表实现
+ * @date    2026-02-19
+ */
+
+#include "gain_sched.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief 初始化为平坦表
+ */
+void Gain_Sched_Init(Gain_Sched_Table_t *t, Gain_Sched_Src_t src, float x_min, float x_max,
+                     float kp, float ki, float kd)
+{
+    uint32_t i;
+
+    memset(t, 0, sizeof(*t));
+    t->src = (uint8_t)src;
+    for (i = 0; i < GAIN_SCHED_POINTS; i++) {
+        t->kp[i] = kp;
+        t->ki[i] = ki;
+        t->kd[i] = kd;
+    }
+    if (Gain_Sched_SetRange(t, x_min, x_max) == 0) {
+        t->magic = GAIN_SCHED_MAGIC;
+    }
+}
+
+/**
+ * @brief 设置断点范围
+ */
+int32_t Gain_Sched_SetRange(Gain_Sched_Table_t *t, float x_min, float x_max)
+{
+    if (!(x_max > x_min)) {
+        return -1;
+    }
+    t->x_min  = x_min;
+    t->x_max  = x_max;
+    t->inv_dx = (float)(GAIN_SCHED_POINTS - 1) / (x_max - x_min);
+    return 0;
+}
+
+/**
+ * @brief 表是否有效
+ */
+uint8_t Gain_Sched_Valid(const Gain_Sched_Table_t *t)
+{
+    return (t->magic == GAIN_SCHED_MAGIC && t->x_max > t->x_min && t->inv_dx > 0.0f &&
+            t->src < GAIN_SCHED_SRC_COUNT);
+}
+
+/**
+ * @brief 查表插值
+ */
+void Gain_Sched_Eval(const Gain_Sched_Table_t *t, float x, Gain_Sched_Out_t *out)
+{
+    float u = (x - t->x_min) * t->inv_dx;
+    uint32_t k;
+    float f;
+
+    if (u <= 0.0f) {
+        k = 0;
+        f = 0.0f;
+    } else if (u >= (float)(GAIN_SCHED_POINTS - 1)) {
+        k = GAIN_SCHED_POINTS - 2;
+        f = 1.0f;
+    } else {
+        k = (uint32_t)u;
+        f = u - (float)k;
+    }
+
+    out->x    = x;
+    out->seg  = (uint8_t)k;
+    out->frac = f;
+    out->kp   = t->kp[k] + f * (t->kp[k + 1] - t->kp[k]);
+    out->ki   = t->ki[k] + f * (t->ki[k + 1] - t->ki[k]);
+    out->kd   = t->kd[k] + f * (t->kd[k + 1] - t->kd[k]);
+}
+
+float Gain_Sched_Point(const Gain_Sched_Table_t *t, uint32_t i)
+{
+    return t->x_min + (t->x_max - t->x_min) * (float)i / (float)(GAIN_SCHED_POINTS - 1);
+}
+
+const char *Gain_Sched_SrcName(uint8_t src)
+{
+    static const char *const names[GAIN_SCHED_SRC_COUNT] = { "dist", "speed" };
+    return (src < GAIN_SCHED_SRC_COUNT) ? names[src] : "?";
+}
+
+/**
+ * @brief 打印调度表
+ */
+void Gain_Sched_Print(const char *name, const Gain_Sched_Table_t *t)
+{
+    uint32_t i;
+
+    if (!Gain_Sched_Valid(t)) {
+        printf("[GS] %s: none\r\n", name);
+        return;
+    }
+    printf("[GS] %s %s by %s, %.1f..%.1f\r\n", name, t->enable ? "ON" : "OFF",
+           Gain_Sched_SrcName(t->src), t->x_min, t->x_max);
+    for (i = 0; i < GAIN_SCHED_POINTS; i++) {
+        printf("[GS]   %u x=%.1f Kp=%.3f Ki=%.3f Kd=%.3f\r\n", (unsigned)i,
+               Gain_Sched_Point(t, i), t->kp[i], t->ki[i], t->kd[i]);
+    }
+}
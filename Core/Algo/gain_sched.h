@@ -0,0 +1,95 @@
+/**
+ * @file    gain_sched.h
+ * @brief   PID 增益调度表 (按调度变量插值 Kp/Ki/Kd)
+ * @note    - 每张表 GAIN_SCHED_POINTS 个断点，在 [x_min, x_max] 上等分，
+ *            查表只需一次乘法定位区间再线性插值，耗时与断点数无关，可在中断中调用
+ *          - 调度变量超出范围时取端点增益 (不外推)
+ *          - 表随 App_Params_t 保存在 Flash 中，magic 不符视为未配置，回路使用固定增益
+ * @date    2026-02-19
+ */
+
+#ifndef __GAIN_SCHED_H
+#define __GAIN_SCHED_H
+
+#include <stdint.h>
+
+/* 配置项 */
+#define GAIN_SCHED_POINTS       5               // 每张表的断点数
+#define GAIN_SCHED_MAGIC        0x47530001U     // 表有效标志 ('GS' v1)
+
+/**
+ * @brief 调度变量
+ */
+typedef enum {
+    GAIN_SCHED_SRC_DIST = 0,    // 视觉测得的目标距离 (cm)
+    GAIN_SCHED_SRC_SPEED,       // 平均轮速幅值 (RPM)
+    GAIN_SCHED_SRC_COUNT
+} Gain_Sched_Src_t;
+
+/**
+ * @brief 单个回路的调度表
+ */
+typedef struct {
+    uint32_t magic;                     // GAIN_SCHED_MAGIC 表示有效
+    uint8_t  enable;                    // 1 按表调度，0 使用固定增益
+    uint8_t  src;                       // 调度变量 (Gain_Sched_Src_t)
+    uint8_t  reserved[2];
+    float    x_min;                     // 第一个断点
+    float    x_max;                     // 最后一个断点
+    float    inv_dx;                    // (N-1)/(x_max-x_min)，由 Gain_Sched_SetRange 计算
+    float    kp[GAIN_SCHED_POINTS];
+    float    ki[GAIN_SCHED_POINTS];
+    float    kd[GAIN_SCHED_POINTS];
+} Gain_Sched_Table_t;
+
+/**
+ * @brief 查表结果 (显示用)
+ */
+typedef struct {
+    float   x;                          // 调度变量
+    uint8_t seg;                        // 所在区间 [seg, seg+1]
+    float   frac;                       // 区间内位置 0..1
+    float   kp, ki, kd;                 // 插值后的增益
+} Gain_Sched_Out_t;
+
+/**
+ * @brief 初始化为平坦表 (所有断点取同一组增益，等效于不调度)
+ * @note  enable 置 0
+ */
+void Gain_Sched_Init(Gain_Sched_Table_t *t, Gain_Sched_Src_t src, float x_min, float x_max,
+                     float kp, float ki, float kd);
+
+/**
+ * @brief 设置断点范围
+ * @return 0 成功；-1 范围无效 (x_max <= x_min)
+ */
+int32_t Gain_Sched_SetRange(Gain_Sched_Table_t *t, float x_min, float x_max);
+
+/**
+ * @brief 表是否有效 (magic 正确且范围合法)
+ */
+uint8_t Gain_Sched_Valid(const Gain_Sched_Table_t *t);
+
+/**
+ * @brief 查表插值 (常数时间)
+ * @param x   调度变量
+ * @param out 输出增益及区间
+ */
+void Gain_Sched_Eval(const Gain_Sched_Table_t *t, float x, Gain_Sched_Out_t *out);
+
+/**
+ * @brief 断点位置
+ */
+float Gain_Sched_Point(const Gain_Sched_Table_t *t, uint32_t i);
+
+/**
+ * @brief 调度变量名称 (显示用)
+ */
+const char *Gain_Sched_SrcName(uint8_t src);
+
+/**
+ * @brief 打印调度表 (调试串口)
+ */
+void Gain_Sched_Print(const char *name, const Gain_Sched_Table_t *t);
+
+#endif /* __GAIN_SCHED_H */
@@ -0,0 +1,268 @@
+/**
+ * @file    motor_ff.c
+ * @brief   电机速度环前馈查表与斜坡辨识实现
+ * @date    2026-02-19
+ */
+
+#include "motor_ff.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 辨识内部阶段 */
+typedef enum {
+    FF_PHASE_SETTLE = 0,    // 停转等待
+    FF_PHASE_RAMP           // PWM 斜坡
+} FF_Phase_t;
+
+/* 辨识状态 (只有一组：两个电机同时辨识) */
+static struct {
+    volatile uint8_t active;
+    volatile uint8_t stop_req;
+    uint8_t  phase;
+    uint8_t  dir;                                   // 0 正转，1 反转
+    float    pwm_max;
+    float    pwm_inc;                               // 每拍 PWM 增量
+    float    pwm;                                   // 当前斜坡 PWM 幅值
+    uint32_t settle_ticks;
+    uint32_t ticks;
+    uint16_t next;                                  // 下一个记录点
+    float    start[2][2];                           // [电机][方向] 起转 PWM，0 表示尚未起转
+    float    rpm_at[2][2][MOTOR_FF_IDENT_SAMPLES];  // [电机][方向][点] 转速幅值
+    Motor_FF_Map_t map[2];
+    int32_t  result;
+} ff_id;
+
+/**
+ * @brief 清空前馈表
+ */
+void Motor_FF_Clear(Motor_FF_Map_t *map)
+{
+    memset(map, 0, sizeof(*map));
+}
+
+/**
+ * @brief 单方向查表 (转速幅值 -> PWM 幅值)
+ */
+static float FF_Dir_Eval(const Motor_FF_Dir_t *d, float a)
+{
+    float x, f, scale = 1.0f;
+    uint32_t k;
+
+    if (d->rpm_max <= 0.0f) {
+        return 0.0f;
+    }
+    if (a < MOTOR_FF_RPM_BLEND) {
+        scale = a / MOTOR_FF_RPM_BLEND;
+        a = MOTOR_FF_RPM_BLEND;
+    }
+
+    x = a * (float)(MOTOR_FF_POINTS - 1) / d->rpm_max;
+    if (x >= (float)(MOTOR_FF_POINTS - 1)) {
+        f = d->pwm[MOTOR_FF_POINTS - 1];    // 超出辨识范围不外推，余量交给 PID
+    } else {
+        k = (uint32_t)x;
+        f = d->pwm[k] + (x - (float)k) * (d->pwm[k + 1] - d->pwm[k]);
+    }
+    return f * scale;
+}
+
+/**
+ * @brief 查表计算前馈 PWM
+ */
+float Motor_FF_Eval(const Motor_FF_Map_t *map, float rpm)
+{
+    if (map->magic != MOTOR_FF_MAGIC || rpm == 0.0f) {
+        return 0.0f;
+    }
+    if (rpm > 0.0f) {
+        return FF_Dir_Eval(&map->fwd, rpm);
+    }
+    return -FF_Dir_Eval(&map->rev, -rpm);
+}
+
+/**
+ * @brief 由斜坡记录生成单方向表
+ * @param rpm_at 等间隔 PWM (0 .. pwm_max) 下的转速幅值
+ * @param start  起转 PWM (0 表示始终未起转)
+ * @return 0 成功；-1 未起转或满 PWM 转速过低
+ * @note  记录先取累计最大值保证单调，再对每个断点转速在曲线上线性反查 PWM
+ */
+static int32_t FF_Dir_Build(Motor_FF_Dir_t *d, float *rpm_at, float start, float pwm_max)
+{
+    const float pwm_step = pwm_max / (float)(MOTOR_FF_IDENT_SAMPLES - 1);
+    uint32_t j, k;
+
+    memset(d, 0, sizeof(*d));
+
+    for (j = 1; j < MOTOR_FF_IDENT_SAMPLES; j++) {
+        if (rpm_at[j] < rpm_at[j - 1]) {
+            rpm_at[j] = rpm_at[j - 1];
+        }
+    }
+    if (start <= 0.0f || rpm_at[MOTOR_FF_IDENT_SAMPLES - 1] < MOTOR_FF_IDENT_MIN_RPM) {
+        return -1;
+    }
+
+    d->rpm_max = rpm_at[MOTOR_FF_IDENT_SAMPLES - 1];
+    d->pwm[0]  = start;
+
+    j = 1;
+    for (k = 1; k < MOTOR_FF_POINTS; k++) {
+        float r = d->rpm_max * (float)k / (float)(MOTOR_FF_POINTS - 1);
+        while (j < MOTOR_FF_IDENT_SAMPLES - 1 && rpm_at[j] < r) {
+            j++;
+        }
+        float r0 = rpm_at[j - 1];
+        float r1 = rpm_at[j];
+        float p  = pwm_step * (float)(j - 1);
+        if (r1 > r0) {
+            p += pwm_step * (r - r0) / (r1 - r0);
+        }
+        /* 动摩擦小于静摩擦，低速段可以低于起转 PWM，但之后保持单调 */
+        if (k > 1 && p < d->pwm[k - 1]) {
+            p = d->pwm[k - 1];
+        }
+        d->pwm[k] = p;
+    }
+    return 0;
+}
+
+/**
+ * @brief 启动辨识
+ */
+int32_t Motor_FF_Ident_Start(float pwm_max, uint32_t step_hz)
+{
+    if (ff_id.active) {
+        return -1;
+    }
+
+    memset(&ff_id, 0, sizeof(ff_id));
+    ff_id.pwm_max      = pwm_max;
+    ff_id.pwm_inc      = pwm_max / (MOTOR_FF_IDENT_RAMP_S * (float)step_hz);
+    ff_id.settle_ticks = (uint32_t)(MOTOR_FF_IDENT_SETTLE_S * (float)step_hz);
+    ff_id.phase        = FF_PHASE_SETTLE;
+    ff_id.result       = -1;
+    ff_id.active       = 1;     // 最后置位：速度环中断从下一拍开始接管
+    return 0;
+}
+
+void Motor_FF_Ident_Stop(void)
+{
+    ff_id.stop_req = 1;
+}
+
+uint8_t Motor_FF_Ident_Active(void)
+{
+    return ff_id.active;
+}
+
+/**
+ * @brief 辨识单步
+ */
+Motor_FF_Ident_State_t Motor_FF_Ident_Step(float rpm_L, float rpm_R, float *pwm_L, float *pwm_R)
+{
+    float sgn, out;
+    uint32_t m;
+
+    *pwm_L = 0.0f;
+    *pwm_R = 0.0f;
+
+    if (!ff_id.active) {
+        return MOTOR_FF_IDENT_IDLE;
+    }
+    if (ff_id.stop_req) {
+        ff_id.active = 0;
+        return MOTOR_FF_IDENT_IDLE;
+    }
+
+    if (ff_id.phase == FF_PHASE_SETTLE) {
+        if (++ff_id.ticks >= ff_id.settle_ticks) {
+            ff_id.phase = FF_PHASE_RAMP;
+            ff_id.ticks = 0;
+            ff_id.pwm   = 0.0f;
+            ff_id.next  = 0;
+        }
+        return MOTOR_FF_IDENT_RUNNING;
+    }
+
+    /* 斜坡：记录起转点和等间隔点的转速 (按驱动方向取幅值) */
+    sgn = (ff_id.dir == 0) ? 1.0f : -1.0f;
+    {
+        float rpm[2];
+        rpm[0] = rpm_L * sgn;
+        rpm[1] = rpm_R * sgn;
+        for (m = 0; m < 2; m++) {
+            if (ff_id.start[m][ff_id.dir] == 0.0f && rpm[m] >= MOTOR_FF_IDENT_START_RPM) {
+                ff_id.start[m][ff_id.dir] = ff_id.pwm;
+            }
+        }
+        if (ff_id.pwm >= ff_id.pwm_max * (float)ff_id.next / (float)(MOTOR_FF_IDENT_SAMPLES - 1)) {
+            ff_id.rpm_at[0][ff_id.dir][ff_id.next] = rpm[0];
+            ff_id.rpm_at[1][ff_id.dir][ff_id.next] = rpm[1];
+            ff_id.next++;
+        }
+    }
+
+    if (ff_id.next >= MOTOR_FF_IDENT_SAMPLES) {
+        /* 本方向结束：停转，换向或生成结果 */
+        ff_id.phase = FF_PHASE_SETTLE;
+        ff_id.ticks = 0;
+        if (ff_id.dir == 0) {
+            ff_id.dir = 1;
+            return MOTOR_FF_IDENT_RUNNING;
+        }
+
+        ff_id.result = 0;
+        for (m = 0; m < 2; m++) {
+            int32_t ok_f = FF_Dir_Build(&ff_id.map[m].fwd, ff_id.rpm_at[m][0], ff_id.start[m][0], ff_id.pwm_max);
+            int32_t ok_r = FF_Dir_Build(&ff_id.map[m].rev, ff_id.rpm_at[m][1], ff_id.start[m][1], ff_id.pwm_max);
+            ff_id.map[m].magic = MOTOR_FF_MAGIC;
+            if (ok_f != 0 && ok_r != 0) {
+                ff_id.result = -1;
+            }
+        }
+        ff_id.active = 0;
+        return MOTOR_FF_IDENT_DONE;
+    }
+
+    out = ff_id.pwm * sgn;
+    *pwm_L = out;
+    *pwm_R = out;
+    ff_id.pwm += ff_id.pwm_inc;
+    if (ff_id.pwm > ff_id.pwm_max) {
+        ff_id.pwm = ff_id.pwm_max;  // 停在终点直到最后一个点记录完
+    }
+    return MOTOR_FF_IDENT_RUNNING;
+}
+
+/**
+ * @brief 读取最近一次辨识结果
+ */
+int32_t Motor_FF_Ident_Result(Motor_FF_Map_t *map_L, Motor_FF_Map_t *map_R)
+{
+    *map_L = ff_id.map[0];
+    *map_R = ff_id.map[1];
+    return ff_id.result;
+}
+
+/**
+ * @brief 打印前馈表
+ */
+void Motor_FF_Print(const char *name, const Motor_FF_Map_t *map)
+{
+    const Motor_FF_Dir_t *dirs[2] = { &map->fwd, &map->rev };
+    uint32_t i, k;
+
+    if (map->magic != MOTOR_FF_MAGIC) {
+        printf("[FF] %s: none\r\n", name);
+        return;
+    }
+    for (i = 0; i < 2; i++) {
+        printf("[FF] %s %s rpm_max=%.1f pwm:", name, (i == 0) ? "fwd" : "rev", dirs[i]->rpm_max);
+        for (k = 0; k < MOTOR_FF_POINTS; k++) {
+            printf(" %.0f", dirs[i]->pwm[k]);
+        }
+        printf("\r\n");
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    motor_ff.h
+ * @brief   电机速度环前馈 (目标转速 -> PWM 查表) 及其斜坡辨识
+ * @note    - 每个电机正反转各一张表：rpm_max 按 MOTOR_FF_POINTS 等分，
+ *            pwm[k] 为达到 k*rpm_max/(N-1) 所需的 PWM 幅值，pwm[0] 为起转 PWM
+ *            (驱动死区 + 静摩擦)，速度环把查表结果加在 PID 输出上
+ *          - 辨识：车轮离地后两个电机同时做慢速 PWM 斜坡 (先正转后反转)，
+ *            记录起转 PWM 和各 PWM 下的稳态转速，反查得到表；
+ *            由速度环中断逐拍调用 Motor_FF_Ident_Step
+ *          - 表随 App_Params_t 保存在 Flash 中，magic 不符视为未辨识，前馈为 0
+ * @date    2026-02-19
+ */
+
+#ifndef __MOTOR_FF_H
+#define __MOTOR_FF_H
+
+#include <stdint.h>
+
+/* 配置项 */
+#define MOTOR_FF_POINTS         9           // 每个方向的转速断点数 (含 0)
+#define MOTOR_FF_MAGIC          0x46460001U // 表有效标志 ('FF' v1)
+#define MOTOR_FF_RPM_BLEND      5.0f        // 目标转速低于该值 (RPM) 时前馈按比例减小，避免过零跳变
+
+#define MOTOR_FF_IDENT_SAMPLES  33          // 斜坡上等间隔记录的转速点数
+#define MOTOR_FF_IDENT_RAMP_S   4.0f        // 单方向斜坡时间 (s)，越慢越接近稳态
+#define MOTOR_FF_IDENT_SETTLE_S 1.0f        // 开始前及换向时停转等待时间 (s)
+#define MOTOR_FF_IDENT_START_RPM 5.0f       // 判定起转的转速 (RPM)，需高于测速分辨率
+#define MOTOR_FF_IDENT_MIN_RPM  20.0f       // 满 PWM 时低于该转速视为堵转，该方向辨识失败
+
+/**
+ * @brief 单方向前馈表
+ */
+typedef struct {
+    float rpm_max;                  // 最后一个断点的转速 (RPM)，0 表示该方向无数据
+    float pwm[MOTOR_FF_POINTS];     // 各断点所需 PWM 幅值，pwm[0] 为起转 PWM
+} Motor_FF_Dir_t;
+
+/**
+ * @brief 单个电机的前馈表
+ */
+typedef struct {
+    uint32_t       magic;           // MOTOR_FF_MAGIC 表示有效
+    Motor_FF_Dir_t fwd;             // 正转 (PWM > 0)
+    Motor_FF_Dir_t rev;             // 反转 (PWM < 0)，幅值存储
+} Motor_FF_Map_t;
+
+/**
+ * @brief 辨识状态
+ */
+typedef enum {
+    MOTOR_FF_IDENT_IDLE = 0,        // 未运行
+    MOTOR_FF_IDENT_RUNNING,         // 运行中，电机由辨识接管
+    MOTOR_FF_IDENT_DONE             // 本拍刚结束，可读取结果
+} Motor_FF_Ident_State_t;
+
+/**
+ * @brief 清空前馈表 (前馈为 0)
+ */
+void Motor_FF_Clear(Motor_FF_Map_t *map);
+
+/**
+ * @brief 查表计算前馈 PWM
+ * @param rpm 目标转速 (RPM，带符号)
+ * @return 带符号的前馈 PWM；表无效时为 0
+ */
+float Motor_FF_Eval(const Motor_FF_Map_t *map, float rpm);
+
+/**
+ * @brief 启动辨识 (任务上下文调用)
+ * @param pwm_max 斜坡终点 PWM
+ * @param step_hz Motor_FF_Ident_Step 的调用频率 (Hz)
+ * @return 0 成功；-1 已在运行
+ */
+int32_t Motor_FF_Ident_Start(float pwm_max, uint32_t step_hz);
+
+/**
+ * @brief 中止辨识 (下一拍电机输出 0 并退出)
+ */
+void Motor_FF_Ident_Stop(void);
+
+/**
+ * @brief 辨识是否在运行
+ */
+uint8_t Motor_FF_Ident_Active(void);
+
+/**
+ * @brief 辨识单步 (速度环中断中调用)
+ * @param rpm_L/rpm_R 左右电机当前转速
+ * @param pwm_L/pwm_R 输出本拍 PWM
+ * @return 当前状态；返回 MOTOR_FF_IDENT_DONE 的那一拍已生成新表
+ */
+Motor_FF_Ident_State_t Motor_FF_Ident_Step(float rpm_L, float rpm_R, float *pwm_L, float *pwm_R);
+
+/**
+ * @brief 读取最近一次辨识结果
+ * @return 0 两个电机都至少有一个方向辨识成功；-1 失败 (表仍按实际结果输出)
+ */
+int32_t Motor_FF_Ident_Result(Motor_FF_Map_t *map_L, Motor_FF_Map_t *map_R);
+
+/**
+ * @brief 打印前馈表 (调试串口)
+ */
+void Motor_FF_Print(const char *name, const Motor_FF_Map_t *map);
+
+#endif /* __MOTOR_FF_H */
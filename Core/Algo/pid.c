@@ -5,272 +5,91 @@
  */
 
 #include "pid.h"
-#include "bsp_openmv.h"
-#include "bsp_encoder.h"
-#include "bsp_tb6612.h"
-#include "app_comm.h"
-#include "../Bsp/Bsp_Flash.h"
 
-#include <stdio.h> // Ensure printf is available
-
-/* --- 宏定义 --- */
-#define FOLLOW_TARGET_DIST      20.0f   // 目标跟随距离 (cm)
-#define FOLLOW_TARGET_X_CENTER  80.0f   // 图像中心 X 坐标 (假设分辨率 160x120)
-#define LOSS_TIMEOUT_SLOW       10      // 丢包减速阈值 (10 * 50ms = 500ms)
-#define LOSS_TIMEOUT_STOP       20      // 丢包急停阈值 (40 * 50ms = 2s)
-
-/* --- 全局变量 --- */
-/* 外环：视觉位置环 */
-PID_Controller_t pid_dist;      // 距离环 (输出线速度 v_linear)
-PID_Controller_t pid_angle;     // 角度环 (输出角速度 v_angular)
-
-/* 内环：电机速度环 */
-PID_Controller_t pid_speed_L;   // 左电机速度环
-PID_Controller_t pid_speed_R;   // 右电机速度环
-
-/* 状态变量 */
-static uint32_t loss_counter = 0;   // 丢包计数器
-static float target_speed_L = 0.0f; // 左轮目标速度 (RPM)
-static float target_speed_R = 0.0f; // 右轮目标速度 (RPM)
+/* PID 计算后端 (PID_CFG_BACKEND) 对应的 CMSIS-DSP 接口 */
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_F32
+#define PID_DSP_INIT(S)     arm_pid_init_f32((S), 0)
+#define PID_DSP_RESET(S)    arm_pid_reset_f32(S)
+#define PID_DSP_GAIN(k)     (k)
+#elif PID_CFG_BACKEND == PID_BACKEND_ARM_Q31
+#define PID_DSP_INIT(S)     arm_pid_init_q31((S), 0)
+#define PID_DSP_RESET(S)    arm_pid_reset_q31(S)
+#define PID_DSP_GAIN(k)     PID_ToQ31(k)
+#endif
 
 /**
- * @brief 更新 PID 参数（从全局配置 g_app_params 加载）
+ * @brief 初始化 PID 控制器
+ * @note  扩展项取默认值：比例项完整跟随设定值 (b=1)，微分只对测量值 (c=0)，
+ *        微分不滤波，抗饱和跟踪时间自动取积分时间
  */
-void App_Follow_Update_PID_Params(void)
+void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, float max_out, float max_int)
 {
-    /* 距离环 */
-    pid_dist.Kp = g_app_params.dist_kp;
-    pid_dist.Ki = g_app_params.dist_ki;
-    pid_dist.Kd = g_app_params.dist_kd;
+    pid->Kp = kp;
+    pid->Ki = ki;
+    pid->Kd = kd;
     
-    /* 角度环 */
-    pid_angle.Kp = g_app_params.angle_kp;
-    pid_angle.Ki = g_app_params.angle_ki;
-    pid_angle.Kd = g_app_params.angle_kd;
+    pid->max_output = max_out;
+    pid->max_integral = max_int;
     
-    /* 速度环 (左轮) */
-    pid_speed_L.Kp = g_app_params.speed_L_kp;
-    pid_speed_L.Ki = g_app_params.speed_L_ki;
-    pid_speed_L.Kd = g_app_params.speed_L_kd;
+    pid->sp_weight_p = 1.0f;
+    pid->sp_weight_d = 0.0f;
+    pid->d_filter_tf = 0.0f;
+    pid->aw_tt = 0.0f;
+    pid->ff = 0.0f;
     
-    /* 速度环 (右轮) */
-    pid_speed_R.Kp = g_app_params.speed_R_kp;
-    pid_speed_R.Ki = g_app_params.speed_R_ki;
-    pid_speed_R.Kd = g_app_params.speed_R_kd;
+    PID_Reset(pid);
 }
 
 /**
- * @brief 初始化跟随控制相关的 PID 控制器
- * @note  参数需要根据实际机械结构进行整定
+ * @brief 设置设定值权重
  */
-void App_Follow_Init(void)
+void PID_SetWeights(PID_Controller_t *pid, float b, float c)
 {
-    /* 1. 加载 Flash 参数 */
-    App_Flash_Init();
-    
-    /* 2. 初始化 PID 对象 (先使用 Flash 参数) */
-    
-    /* 初始化距离环 (目标: 保持距离) */
-    /* 输出限幅 100 RPM */
-    PID_Init(&pid_dist, g_app_params.dist_kp, g_app_params.dist_ki, g_app_params.dist_kd, 150.0f, 50.0f);
-
-    /* 初始化角度环 (目标: 保持中心) */
-    /* 输出限幅 50 RPM (差速) */
-    PID_Init(&pid_angle, g_app_params.angle_kp, g_app_params.angle_ki, g_app_params.angle_kd, 80.0f, 30.0f);
-
-    /* 初始化左电机速度环 */
-    /* 输出限幅 PWM满占空比 (假设 4200) */
-    printf("[PID_Init] Speed_L: Kp=%.2f, Ki=%.2f, Kd=%.2f\r\n", g_app_params.speed_L_kp, g_app_params.speed_L_ki, g_app_params.speed_L_kd);
-    PID_Init(&pid_speed_L, g_app_params.speed_L_kp, g_app_params.speed_L_ki, g_app_params.speed_L_kd, 4200.0f, 2000.0f);
-
-    /* 初始化右电机速度环 */
-    printf("[PID_Init] Speed_R: Kp=%.2f, Ki=%.2f, Kd=%.2f\r\n", g_app_params.speed_R_kp, g_app_params.speed_R_ki, g_app_params.speed_R_kd);
-    PID_Init(&pid_speed_R, g_app_params.speed_R_kp, g_app_params.speed_R_ki, g_app_params.speed_R_kd, 4200.0f, 2000.0f);
+    pid->sp_weight_p = b;
+    pid->sp_weight_d = c;
 }
 
 /**
- * @brief 跟随控制循环 (10ms 周期调用)
- * @note  包含：手动/自动模式切换、丢包保护、外环视觉控制、运动学解算、内环速度控制
+ * @brief 设置微分项一阶低通滤波时间常数
  */
-void App_Follow_Control_Loop(void)
+void PID_SetDFilter(PID_Controller_t *pid, float tf)
 {
-    static Robot_Mode_t last_mode = MODE_MANUAL;
-    
-    static uint8_t loop_debug_div = 0;
-    if (++loop_debug_div >= 20) { // 1s alive check
-        loop_debug_div = 0;
-        printf("Loop Alive. Mode=%d, Cmd=%d\r\n", g_robot_mode, g_remote_cmd);
-    }
-    
-    /* 1. 全局急停检查 (优先级最高) */
-    /* 仅在手动模式或收到明确停止指令时生效？ */
-    /* 目前逻辑：只要是 CMD_STOP，无论什么模式都停车 */
-    /* 如果自动模式下 g_remote_cmd 默认为 CMD_STOP，就会导致无法运行 */
-    if (g_robot_mode == MODE_MANUAL && g_remote_cmd == CMD_STOP) {
-        /* 停止电机 */
-        TB6612_Motor_SetSpeed(&motorL, 0);
-        TB6612_Motor_SetSpeed(&motorR, 0);
-        
-        /* 重置所有 PID 防止积分饱和 */
-        PID_Reset(&pid_dist);
-        PID_Reset(&pid_angle);
-        PID_Reset(&pid_speed_L);
-        PID_Reset(&pid_speed_R);
-        
-        /* 重置丢包计数器 */
-        loss_counter = 0;
-        
-        /* 记录当前模式，防止恢复时误触发切换逻辑 */
-        last_mode = g_robot_mode;
-        return;
-    }
-
-    /* 2. 模式切换检测 */
-    if (g_robot_mode != last_mode) {
-        /* 切换模式时重置 PID */
-        PID_Reset(&pid_dist);
-        PID_Reset(&pid_angle);
-        PID_Reset(&pid_speed_L);
-        PID_Reset(&pid_speed_R);
-        
-        /* 重置丢包计数器 */
-        loss_counter = 0;
-        
-        last_mode = g_robot_mode;
-    }
-
-    /* 3. 分模式控制 */
-    if (g_robot_mode == MODE_MANUAL)
-    {
-        /* ---------------- 手动模式 ---------------- */
-        float pwm_L = 0.0f;
-        float pwm_R = 0.0f;
-        const float MANUAL_PWM = 1000.0f; // 手动模式直接 PWM (0~4200)
-
-        switch (g_remote_cmd) {
-            case CMD_FORWARD:
-                pwm_L = MANUAL_PWM;
-                pwm_R = MANUAL_PWM;
-                break;
-            case CMD_BACKWARD:
-                pwm_L = -MANUAL_PWM;
-                pwm_R = -MANUAL_PWM;
-                break;
-            case CMD_LEFT: // 原地左转
-                pwm_L = -MANUAL_PWM;
-                pwm_R = MANUAL_PWM;
-                break;
-            case CMD_RIGHT: // 原地右转
-                pwm_L = MANUAL_PWM;
-                pwm_R = -MANUAL_PWM;
-                break;
-            default:
-                pwm_L = 0.0f;
-                pwm_R = 0.0f;
-                break;
-        }
-        
-        TB6612_Motor_SetSpeed(&motorL, (int32_t)pwm_L);
-        TB6612_Motor_SetSpeed(&motorR, (int32_t)pwm_R);
-    }
-    else
-    {
-        /* ---------------- 自动模式 (OpenMV 跟随) ---------------- */
-        float v_linear = 0.0f;
-        float v_angular = 0.0f;
-
-        /* 4.1 丢包检测与保护 */
-        /* 检查 FIFO 计数是否变化... (同前) */
-        
-        /* 临时：每次进入增加计数... */
-        loss_counter++;
-        
-        /* 4.2 外环：视觉位置控制 (PD) */
-        if (loss_counter < LOSS_TIMEOUT_STOP)
-        {
-					if (openmv_data.x == 0 && openmv_data.dist == 0) 
-            {
-                /* 目标完全丢失，立刻原地立正，不要乱转！ */
-                v_linear = 0.0f;
-                v_angular = 0.0f;
-                
-                /* 清理历史误差，防止再次看到目标时猛冲 */
-                PID_Reset(&pid_angle);
-                PID_Reset(&pid_dist);
-            }else{
-            /* 计算距离误差 -> 线速度 */
-            v_linear = PID_Compute(&pid_dist, openmv_data.dist, FOLLOW_TARGET_DIST);
-            //v_linear=0.0f;
-            /* 计算角度误差 -> 角速度 */
-						v_angular = PID_Compute(&pid_angle, FOLLOW_TARGET_X_CENTER, openmv_data.x);
-						}
-        }
-        else
-        {
-            /* 急停 */
-            v_linear = 0.0f;
-            v_angular = 0.0f;
-            
-            /* 重置积分项 */
-            pid_dist.integral = 0;
-            pid_angle.integral = 0;
-        }
-        
-        /* 4.3 运动学解算 (差速模型) */
-				target_speed_L = v_linear - v_angular;
-        target_speed_R = v_linear + v_angular;
-//        target_speed_L = 50.0f; // 目标 50 RPM
-//				target_speed_R = 50.0f;
-//        /* 4.4 丢包保护 (减速) */
-        if (loss_counter > LOSS_TIMEOUT_SLOW && loss_counter < LOSS_TIMEOUT_STOP)
-        {
-            target_speed_L *= 0.5f;
-            target_speed_R *= 0.5f;
-        }
-        
-        /* 4.5 内环：电机速度控制 (PI) */
-        float pwm_L = PID_Compute(&pid_speed_L, target_speed_L, motor1.speed_rpm);
-        float pwm_R = PID_Compute(&pid_speed_R, target_speed_R, motor2.speed_rpm);
-        
-        /* 4.6 执行输出 */
-        TB6612_Motor_SetSpeed(&motorL, (int32_t)pwm_L);
-        TB6612_Motor_SetSpeed(&motorR, (int32_t)pwm_R);
+    pid->d_filter_tf = (tf > 0.0f) ? tf : 0.0f;
+}
 
-        static uint8_t debug_div = 0;
-        if (++debug_div >= 10) { // 每500ms打印一次
-            debug_div = 0;
-//            /* 打印详细调试信息：目标/实际/PWM/误差/当前Kp/丢包数 */
-//            printf("AUTO: Tgt=%.1f Act=%.1f PWM=%.0f Err=%.1f Kp=%.2f Ki=%.2f | Loss=%u\r\n", 
-//                   target_speed_L, motor1.speed_rpm, pwm_L,
-//                   target_speed_L - motor1.speed_rpm,
-//                   pid_speed_L.Kp, pid_speed_L.Ki,
-//                   loss_counter);
-        }
-    }
+/**
+ * @brief 设置反算抗饱和的跟踪时间常数
+ */
+void PID_SetAntiWindup(PID_Controller_t *pid, float tt)
+{
+    pid->aw_tt = (tt > 0.0f) ? tt : 0.0f;
 }
 
 /**
- * @brief 供外部调用的丢包计数器重置函数
- * @note  应在 OpenMV 解析成功时调用
+ * @brief 设置前馈量 (加在限幅之前)
  */
-void App_Follow_Reset_Loss_Counter(void)
+void PID_SetFeedforward(PID_Controller_t *pid, float ff)
 {
-    loss_counter = 0;
+    pid->ff = ff;
 }
 
 /**
- * @brief 初始化 PID 控制器
+ * @brief 运行中修改增益 (无扰切换)
+ * @note  积分项输出为 Ki * integral，Ki 改变时按比例换算累积量，使积分项输出不跳变
  */
-void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, float max_out, float max_int)
+void PID_SetGains(PID_Controller_t *pid, float kp, float ki, float kd)
 {
+    if (ki != 0.0f && pid->Ki != 0.0f && ki != pid->Ki) {
+        pid->integral *= pid->Ki / ki;
+        if (pid->integral > pid->max_integral) {
+            pid->integral = pid->max_integral;
+        } else if (pid->integral < -pid->max_integral) {
+            pid->integral = -pid->max_integral;
+        }
+    }
     pid->Kp = kp;
     pid->Ki = ki;
     pid->Kd = kd;
-    
-    pid->max_output = max_out;
-    pid->max_integral = max_int;
-    
-    PID_Reset(pid);
 }
 
 /**
@@ -284,41 +103,96 @@ void PID_Reset(PID_Controller_t *pid)
     pid->prev_error = 0;
     pid->integral = 0;
     pid->output = 0;
+    pid->d_term = 0;
+    pid->prev_d_input = 0;
+    pid->first = 1;
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+    PID_DSP_RESET(&pid->dsp);
+#endif
 }
 
 /**
- * @brief 计算 PID 输出
- * @note  这是一个位置式 PID 实现
+ * @brief 计算 PID 输出 (兼容接口，按参考周期 PID_REF_DT)
  */
 float PID_Compute(PID_Controller_t *pid, float target, float actual)
 {
+    return PID_Update(pid, target, actual, PID_REF_DT);
+}
+
+/**
+ * @brief 按实际周期计算 PID 输出 (兼容接口)
+ */
+float PID_Compute_Dt(PID_Controller_t *pid, float target, float actual, float dt)
+{
+    return PID_Update(pid, target, actual, dt);
+}
+
+/**
+ * @brief 按实际周期计算 PID 输出
+ * @note  位置式 PID。Ki、Kd 按 PID_REF_DT 周期整定，换算成连续时间增益
+ *        Ki/PID_REF_DT、Kd*PID_REF_DT 后按 dt 离散，同一组参数在不同回路频率下等效：
+ *          P = Kp * (b*r - y)
+ *          D = 对 (c*r - y) 微分，经时间常数 Tf 的一阶低通 (后向差分)
+ *          u = sat(FF + P + Ki*integral + D)
+ *          积分按误差累加，并按 (u - v)/Tt 反算回退，输出饱和时不再继续累积；
+ *          integral 仍以参考周期为单位，max_integral 作为附加硬限幅
+ */
+float PID_Update(PID_Controller_t *pid, float target, float actual, float dt)
+{
+    float k = dt / PID_REF_DT;
+    
+    if (k <= 0.0f) {
+        return pid->output; // 间隔为 0 (同一时刻重复调用)：保持上次输出
+    }
+    
     pid->target = target;
     pid->actual = actual;
     
     /* 计算误差 */
     pid->error = pid->target - pid->actual;
     
-    /* 积分项 (带限幅) */
-    pid->integral += pid->error;
-    if (pid->integral > pid->max_integral) {
-        pid->integral = pid->max_integral;
-    } else if (pid->integral < -pid->max_integral) {
-        pid->integral = -pid->max_integral;
-    }
+    /* 比例项 (设定值加权) */
+    float p_term = pid->Kp * (pid->sp_weight_p * target - actual);
     
-    /* 微分项 */
-    float derivative = pid->error - pid->prev_error;
+    /* 微分项 (设定值加权，一阶低通)：D = (Tf*D + Kd_c*Δ) / (Tf + dt) */
+    float d_input = pid->sp_weight_d * target - actual;
+    if (pid->first) {
+        pid->prev_d_input = d_input;    // 复位后第一次没有历史，不产生微分冲击
+        pid->d_term = 0.0f;
+        pid->first = 0;
+    }
+    pid->d_term = (pid->d_filter_tf * pid->d_term +
+                   pid->Kd * PID_REF_DT * (d_input - pid->prev_d_input)) /
+                  (pid->d_filter_tf + dt);
+    pid->prev_d_input = d_input;
     
-    /* 计算输出 */
-    pid->output = (pid->Kp * pid->error) + 
-                  (pid->Ki * pid->integral) + 
-                  (pid->Kd * derivative);
+    /* 计算输出并限幅 */
+    float v = pid->ff + p_term + pid->Ki * pid->integral + pid->d_term;
+    float u = v;
+    if (u > pid->max_output) {
+        u = pid->max_output;
+    } else if (u < -pid->max_output) {
+        u = -pid->max_output;
+    }
+    pid->output = u;
     
-    /* 输出限幅 */
-    if (pid->output > pid->max_output) {
-        pid->output = pid->max_output;
-    } else if (pid->output < -pid->max_output) {
-        pid->output = -pid->max_output;
+    /* 积分项：误差累积 + 饱和反算 (跟踪时间默认取积分时间 Ti = Kp/Ki_c) */
+    if (pid->Ki != 0.0f) {
+        float tt = pid->aw_tt;
+        if (tt <= 0.0f) {
+            tt = (pid->Kp > 0.0f) ? (pid->Kp * PID_REF_DT / pid->Ki) : dt;
+        }
+        float g = dt / tt;
+        if (g > 1.0f) {
+            g = 1.0f;   // 跟踪时间短于周期时一步回退到饱和边界
+        }
+        pid->integral += pid->error * k + g * (u - v) / pid->Ki;
+        
+        if (pid->integral > pid->max_integral) {
+            pid->integral = pid->max_integral;
+        } else if (pid->integral < -pid->max_integral) {
+            pid->integral = -pid->max_integral;
+        }
     }
     
     /* 更新历史误差 */
@@ -326,3 +200,96 @@ float PID_Compute(PID_Controller_t *pid, float target, float actual)
     
     return pid->output;
 }
+
+/* ---------------- PID 计算后端 (CMSIS-DSP) ---------------- */
+
+/* 定点后端的量化：输入满量程取单步 A0 增量为 IN 倍限幅的误差，输出满量程取 OUT 倍限幅，
+ * 于是 |A0| + |A1| + |A2| <= 4*IN/OUT = 1/2，再加上已限幅的 y[n-1] (1/16) 也不会溢出；
+ * 超出输入满量程的误差按饱和处理，此时单比例项就已远超限幅 */
+#define PID_DSP_IN_FS_RATIO     2.0f
+#define PID_DSP_OUT_FS_RATIO    16.0f
+#define PID_Q31_SCALE           2147483648.0f
+
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_Q31
+/**
+ * @brief 浮点转 Q31 (饱和到 [-1, 1))
+ */
+static q31_t PID_ToQ31(float x)
+{
+    if (x >= 0.99999994f) return 0x7FFFFFFF;
+    if (x <= -1.0f)       return (q31_t)0x80000000;
+    return (q31_t)(x * PID_Q31_SCALE);
+}
+#endif
+
+/**
+ * @brief 按固定周期生成后端系数
+ * @note  Kp、Ki、Kd 按 PID_REF_DT 换算成每周期增益，定点后端再统一缩放到 Q 格式；
+ *        只更新系数不清状态 (状态由 PID_Reset 清零)，运行中改参数输出不会跳变
+ */
+void PID_Kernel_Init(PID_Controller_t *pid, float dt)
+{
+#if PID_CFG_BACKEND == PID_BACKEND_FLOAT
+    (void)pid;
+    (void)dt;
+#else
+    float kp = pid->Kp;
+    float ki = pid->Ki * dt / PID_REF_DT;
+    float kd = pid->Kd * PID_REF_DT / dt;
+    float g  = 1.0f;
+
+#if PID_CFG_BACKEND != PID_BACKEND_ARM_F32
+    float a0 = fabsf(kp) + fabsf(ki) + fabsf(kd);
+    if (a0 <= 0.0f) {
+        a0 = 1.0f;
+    }
+    pid->dsp_in_scale  = a0 / (PID_DSP_IN_FS_RATIO * pid->max_output);
+    pid->dsp_out_scale = PID_DSP_OUT_FS_RATIO * pid->max_output;
+    g = PID_DSP_IN_FS_RATIO / (PID_DSP_OUT_FS_RATIO * a0);
+#endif
+
+    pid->dsp.Kp = PID_DSP_GAIN(kp * g);
+    pid->dsp.Ki = PID_DSP_GAIN(ki * g);
+    pid->dsp.Kd = PID_DSP_GAIN(kd * g);
+    PID_DSP_INIT(&pid->dsp);
+#endif
+}
+
+/**
+ * @brief 用编译时选择的后端计算 PID 输出
+ */
+float PID_Kernel_Run(PID_Controller_t *pid, float target, float actual, float dt)
+{
+#if PID_CFG_BACKEND == PID_BACKEND_FLOAT
+    return PID_Update(pid, target, actual, dt);
+#else
+    float u;
+    (void)dt;   // 按 PID_Kernel_Init 时的固定周期计算
+
+    pid->target = target;
+    pid->actual = actual;
+    pid->error  = target - actual;
+
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_F32
+    u = arm_pid_f32(&pid->dsp, pid->error);
+#else
+    u = (float)arm_pid_q31(&pid->dsp, PID_ToQ31(pid->error * pid->dsp_in_scale)) *
+        (pid->dsp_out_scale / PID_Q31_SCALE);
+#endif
+
+    /* 加上前馈后限幅，并把限幅后扣除前馈的值写回 y[n-1]：增量式下即为抗积分饱和 */
+    u += pid->ff;
+    if (u > pid->max_output || u < -pid->max_output) {
+        u = (u > 0.0f) ? pid->max_output : -pid->max_output;
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_F32
+        pid->dsp.state[2] = u - pid->ff;
+#else
+        pid->dsp.state[2] = PID_DSP_GAIN((u - pid->ff) / pid->dsp_out_scale);
+#endif
+    }
+
+    pid->output     = u;
+    pid->prev_error = pid->error;
+    return u;
+#endif
+}
@@ -9,6 +9,35 @@
 
 #include <stdint.h>
 
+#define PID_REF_DT  0.05f   // 参数整定的参考周期 (s)：Ki、Kd 均按每 50ms 一次计算标定
+
+/* PID 计算后端 (PID Kernel Backend)，编译时选择，用于 PID_Kernel_Run */
+#define PID_BACKEND_FLOAT    0  // PID_Update：浮点，支持变周期、设定值加权、微分滤波、反算抗饱和
+#define PID_BACKEND_ARM_F32  1  // CMSIS-DSP arm_pid_f32：增量式，固定周期，对误差微分
+#define PID_BACKEND_ARM_Q31  2  // CMSIS-DSP arm_pid_q31：同上，Q31 定点
+#define PID_BACKEND_ARM_Q15  3  // CMSIS-DSP arm_pid_q15：不支持，见下
+
+#ifndef PID_CFG_BACKEND
+#define PID_CFG_BACKEND      PID_BACKEND_FLOAT
+#endif
+
+/* arm_pid_q15 是增量式，每周期把 y[n-1] + 增量截断到输出的 1 LSB (约 2 PWM)：1kHz 速度环
+ * 每步的积分增量 (Flash 默认增益下每 RPM 误差 0.05 PWM) 被整个丢弃，截断偏差还逐周期累积，
+ * 比例项也随之漂移；在库外另存积分也消不掉比例、微分增量的截断，故不提供该后端 */
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_Q15
+#error "PID_BACKEND_ARM_Q15 is not supported: arm_pid_q15 truncates every step, use PID_BACKEND_ARM_Q31"
+#endif
+
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+#include "arm_math.h"
+#endif
+
+#if PID_CFG_BACKEND == PID_BACKEND_ARM_F32
+typedef arm_pid_instance_f32 PID_Dsp_t;
+#elif PID_CFG_BACKEND == PID_BACKEND_ARM_Q31
+typedef arm_pid_instance_q31 PID_Dsp_t;
+#endif
+
 /**
  * @brief PID 控制器结构体 (PID Controller Structure)
  */
@@ -26,6 +55,23 @@ typedef struct {
     float output;       // PID 输出 (PID Output)
     float max_output;   // 输出限幅 (Output Limit)
     float max_integral; // 积分限幅 (Integral Limit)
+
+    /* PID_Update 扩展项 (Extended Terms) */
+    float sp_weight_p;  // 比例项设定值权重 b (Setpoint Weight for P)，1 为标准 PID
+    float sp_weight_d;  // 微分项设定值权重 c (Setpoint Weight for D)，0 只对测量值微分
+    float d_filter_tf;  // 微分低通时间常数 (D Filter Time Constant, s)，0 不滤波
+    float aw_tt;        // 抗饱和跟踪时间常数 (Anti-windup Tracking Time, s)，0 自动取积分时间
+    float d_term;       // 滤波后的微分项 (Filtered D Term)
+    float prev_d_input; // 上一次微分输入 c*target - actual (Previous D Input)
+    float ff;           // 前馈量 (Feedforward)，加在输出限幅之前，由 PID_SetFeedforward 每周期设置
+    uint8_t first;      // 复位后第一次计算 (First Update after Reset)
+
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+    /* CMSIS-DSP 后端 (由 PID_Kernel_Init 按固定周期生成) */
+    PID_Dsp_t dsp;      // arm_pid 实例 (DSP Instance)
+    float dsp_in_scale; // 误差 -> 定点输入的比例 (1 / 输入满量程)
+    float dsp_out_scale;// 定点输出 -> 实际输出的比例 (输出满量程)
+#endif
 } PID_Controller_t;
 
 /**
@@ -46,7 +92,74 @@ void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, float max_out
 void PID_Reset(PID_Controller_t *pid);
 
 /**
- * @brief 计算 PID 输出 (Compute PID Output)
+ * @brief 设置设定值权重 (Set Setpoint Weights)
+ * @param pid PID 对象指针
+ * @param b   比例项权重 (1: 标准；<1 减小设定值阶跃时的超调)
+ * @param c   微分项权重 (0: 对测量值微分，设定值阶跃无冲击；1: 对误差微分)
+ */
+void PID_SetWeights(PID_Controller_t *pid, float b, float c);
+
+/**
+ * @brief 设置微分项一阶低通滤波 (Set D Filter)
+ * @param pid PID 对象指针
+ * @param tf  时间常数 (s)，0 不滤波
+ */
+void PID_SetDFilter(PID_Controller_t *pid, float tf);
+
+/**
+ * @brief 设置反算抗饱和跟踪时间常数 (Set Anti-windup Tracking Time)
+ * @param pid PID 对象指针
+ * @param tt  时间常数 (s)，越小退出饱和越快；0 自动取积分时间 Kp/Ki
+ */
+void PID_SetAntiWindup(PID_Controller_t *pid, float tt);
+
+/**
+ * @brief 设置前馈量 (Set Feedforward)
+ * @param pid PID 对象指针
+ * @param ff  前馈量，与 PID 项相加后再限幅，输出和抗饱和都按总量计算；每次计算前设置
+ * @note  前馈在控制器外相加时，控制器自己的限幅看不到总量的饱和，积分会在总输出饱和时继续累积
+ */
+void PID_SetFeedforward(PID_Controller_t *pid, float ff);
+
+/**
+ * @brief 运行中修改增益 (Bumpless Gain Change)
+ * @param pid PID 对象指针
+ * @note  换算积分累积量使积分项输出连续；CMSIS-DSP 后端还需调用 PID_Kernel_Init
+ */
+void PID_SetGains(PID_Controller_t *pid, float kp, float ki, float kd);
+
+/**
+ * @brief 按实际周期计算 PID 输出 (Time-aware PID Update)
+ * @param pid    PID 对象指针
+ * @param target 目标值
+ * @param actual 实际值
+ * @param dt     距上次计算的时间 (s)
+ * @return float PID 输出值 (含前馈，已限幅)
+ * @note  设定值加权、微分滤波、反算抗饱和，参数按 PID_REF_DT 周期整定
+ */
+float PID_Update(PID_Controller_t *pid, float target, float actual, float dt);
+
+/**
+ * @brief 按固定周期生成后端系数 (Init Kernel Backend)
+ * @param pid PID 对象指针
+ * @param dt  回路周期 (s)
+ * @note  PID_Init 之后、以及修改 Kp/Ki/Kd/max_output 后需调用；浮点后端为空操作
+ */
+void PID_Kernel_Init(PID_Controller_t *pid, float dt);
+
+/**
+ * @brief 用编译时选择的后端计算 PID 输出 (Run Kernel Backend)
+ * @param pid    PID 对象指针
+ * @param target 目标值
+ * @param actual 实际值
+ * @param dt     距上次计算的时间 (s)，仅浮点后端使用，其余后端按 PID_Kernel_Init 的周期
+ * @return float PID 输出值 (含前馈，已限幅)
+ * @note  DSP 后端为增量式：输出限幅后写回状态，天然不积分饱和；不支持设定值加权和微分滤波
+ */
+float PID_Kernel_Run(PID_Controller_t *pid, float target, float actual, float dt);
+
+/**
+ * @brief 计算 PID 输出 (Compute PID Output)，兼容接口，等同 dt = PID_REF_DT 的 PID_Update
  * @param pid    PID 对象指针
  * @param target 目标值
  * @param actual 实际值
@@ -54,10 +167,14 @@ void PID_Reset(PID_Controller_t *pid);
  */
 float PID_Compute(PID_Controller_t *pid, float target, float actual);
 
-/* 应用层跟随控制接口 (Application Layer Follow Control Interface) */
-void App_Follow_Init(void);
-void App_Follow_Control_Loop(void);
-void App_Follow_Reset_Loss_Counter(void);
-void App_Follow_Update_PID_Params(void);
+/**
+ * @brief 按实际周期计算 PID 输出 (Compute PID Output with Sample Time)，兼容接口，等同 PID_Update
+ * @param pid    PID 对象指针
+ * @param target 目标值
+ * @param actual 实际值
+ * @param dt     距上次计算的时间 (s)
+ * @return float PID 输出值
+ */
+float PID_Compute_Dt(PID_Controller_t *pid, float target, float actual, float dt);
 
 #endif /* __PID_H */
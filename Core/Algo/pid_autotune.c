@@ -0,0 +1,203 @@
+/**
+ * @file    pid_autotune.c
+ * @brief   继电反馈 PID 自整定实现
+ * @date    2026-02-19
+ */
+
+#include "pid_autotune.h"
+#include "pid.h"
+#include <math.h>
+#include <string.h>
+
+#define PID_AT_PI   3.14159265f
+
+/**
+ * @brief 初始化并启动自整定
+ */
+void PID_AT_Init(PID_AT_t *at, float setpoint, float bias, float relay, float hyst,
+                 float out_min, float out_max, float dt, float timeout, PID_AT_Rule_t rule)
+{
+    memset(at, 0, sizeof(*at));
+    at->setpoint  = setpoint;
+    at->bias      = bias;
+    at->relay     = relay;
+    at->hyst      = hyst;
+    at->out_min   = out_min;
+    at->out_max   = out_max;
+    at->dt        = dt;
+    at->max_ticks = (uint32_t)(timeout / dt);
+    at->stall_ticks = (uint32_t)(PID_AT_STALL_S / dt);
+    at->rule      = rule;
+    at->out_sign  = 1;
+    at->y_max     = -1.0e30f;
+    at->y_min     = 1.0e30f;
+    at->state     = PID_AT_RUNNING;
+}
+
+/**
+ * @brief 输出限幅
+ */
+static float PID_AT_Clamp(const PID_AT_t *at, float out)
+{
+    if (out > at->out_max) out = at->out_max;
+    if (out < at->out_min) out = at->out_min;
+    return out;
+}
+
+/**
+ * @brief 当前 bias 下的继电幅值：靠近限幅时两侧同时收窄，保持高低电平对称
+ */
+static float PID_AT_Relay(const PID_AT_t *at)
+{
+    float d = at->relay;
+    if (at->out_max - at->bias < d) d = at->out_max - at->bias;
+    if (at->bias - at->out_min < d) d = at->bias - at->out_min;
+    return (d > 0.0f) ? d : 0.0f;
+}
+
+/**
+ * @brief 最近 PID_AT_STABLE_PERIODS 个值的均值与相对极差
+ */
+static float PID_AT_Spread(const float *v, float *mean)
+{
+    float lo = v[0], hi = v[0], sum = 0.0f;
+    uint32_t i;
+
+    for (i = 0; i < PID_AT_STABLE_PERIODS; i++) {
+        sum += v[i];
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    *mean = sum / (float)PID_AT_STABLE_PERIODS;
+    return (*mean > 0.0f) ? (hi - lo) / *mean : 1.0f;
+}
+
+/**
+ * @brief 一个完整周期结束 (上升切换时调用)
+ * @return 1 已收敛
+ */
+static uint8_t PID_AT_Period(PID_AT_t *at)
+{
+    uint32_t len = at->ticks - at->last_rise;
+    float frac_high = (float)at->high_ticks / (float)len;
+    float tu, amp;
+
+    /* 本周期的实际继电幅值 (bias 更新前) */
+    at->relay_eff = PID_AT_Relay(at);
+
+    /* bias 取上一周期的平均输出：振荡不对称说明 bias 偏离稳态输出 */
+    at->bias = at->out_sum / (float)len;
+
+    if (fabsf(frac_high * 2.0f - 1.0f) > PID_AT_SYM_TOL) {
+        at->periods = 0;    // 还在调整 bias，重新计数
+        return 0;
+    }
+
+    tu  = (float)len * at->dt;
+    amp = 0.5f * (at->y_max - at->y_min);
+    at->tu_hist[at->periods % PID_AT_STABLE_PERIODS]  = tu;
+    at->amp_hist[at->periods % PID_AT_STABLE_PERIODS] = amp;
+    at->periods++;
+
+    if (at->periods >= PID_AT_STABLE_PERIODS) {
+        float tu_mean, amp_mean;
+        if (PID_AT_Spread(at->tu_hist, &tu_mean) < PID_AT_TU_TOL &&
+            PID_AT_Spread(at->amp_hist, &amp_mean) < PID_AT_AMP_TOL) {
+            at->Tu  = tu_mean;
+            at->amp = amp_mean;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 自整定单步
+ */
+PID_AT_State_t PID_AT_Step(PID_AT_t *at, float y, float *u)
+{
+    float e, out;
+
+    *u = 0.0f;
+    if (at->state != PID_AT_RUNNING) {
+        return at->state;
+    }
+    if (++at->ticks > at->max_ticks) {
+        at->state = PID_AT_FAILED;
+        return at->state;
+    }
+
+    /* 带回差的继电器 */
+    e = at->setpoint - y;
+    if (at->out_sign > 0 && e < -at->hyst) {
+        at->out_sign = -1;
+        at->last_switch = at->ticks;
+    } else if (at->out_sign < 0 && e > at->hyst) {
+        at->out_sign = 1;
+        at->last_switch = at->ticks;
+
+        /* 上升切换：一个周期结束 */
+        if (at->started && PID_AT_Period(at)) {
+            float a2 = at->amp * at->amp - at->hyst * at->hyst;
+            if (a2 <= 0.0f) {
+                at->state = PID_AT_FAILED;  // 振幅淹没在回差里，需加大继电幅值
+                return at->state;
+            }
+            at->Ku = 4.0f * at->relay_eff / (PID_AT_PI * sqrtf(a2));
+            PID_AT_Compute(at, at->rule);
+            at->state = PID_AT_DONE;
+            return at->state;
+        }
+        at->started    = 1;
+        at->last_rise  = at->ticks;
+        at->high_ticks = 0;
+        at->out_sum    = 0.0f;
+        at->y_max      = -1.0e30f;
+        at->y_min      = 1.0e30f;
+    } else if (at->ticks - at->last_switch > at->stall_ticks) {
+        /* 长时间不切换：当前继电电平到不了设定值，bias 向该方向移动并重新开始计周期 */
+        at->bias = PID_AT_Clamp(at, at->bias + (float)at->out_sign * 0.5f * at->relay);
+        at->last_switch = at->ticks;
+        at->started = 0;
+        at->periods = 0;
+    }
+
+    out = at->bias + (float)at->out_sign * PID_AT_Relay(at);
+
+    if (y > at->y_max) at->y_max = y;
+    if (y < at->y_min) at->y_min = y;
+    if (at->out_sign > 0) at->high_ticks++;
+    at->out_sum += out;
+
+    *u = out;
+    return at->state;
+}
+
+/**
+ * @brief 按规则计算增益
+ * @note  连续形式 u = Kp*(e + 1/Ti*∫e + Td*de/dt)；本工程 Ki、Kd 按 PID_REF_DT 标定，
+ *        即 Ki = Kp*PID_REF_DT/Ti，Kd = Kp*Td/PID_REF_DT
+ */
+void PID_AT_Compute(PID_AT_t *at, PID_AT_Rule_t rule)
+{
+    float kp, ti, td = 0.0f;
+
+    switch (rule) {
+        case PID_AT_RULE_PI_ZN:     kp = 0.45f * at->Ku; ti = at->Tu / 1.2f;              break;
+        case PID_AT_RULE_PID_ZN:    kp = 0.6f * at->Ku;  ti = 0.5f * at->Tu; td = 0.125f * at->Tu; break;
+        case PID_AT_RULE_PID_NO_OS: kp = 0.2f * at->Ku;  ti = 0.5f * at->Tu; td = at->Tu / 3.0f;   break;
+        case PID_AT_RULE_PI_TL:
+        default:                    kp = at->Ku / 3.2f;  ti = 2.2f * at->Tu;              break;
+    }
+
+    at->rule = rule;
+    at->Kp = kp;
+    at->Ki = (ti > 0.0f) ? kp * PID_REF_DT / ti : 0.0f;
+    at->Kd = kp * td / PID_REF_DT;
+}
+
+const char *PID_AT_RuleName(PID_AT_Rule_t rule)
+{
+    static const char *const names[PID_AT_RULE_COUNT] = { "PI TL", "PI ZN", "PID ZN", "PID NoOS" };
+    return (rule < PID_AT_RULE_COUNT) ? names[rule] : "?";
+}
@@ -0,0 +1,118 @@
+/**
+ * @file    pid_autotune.h
+ * @brief   继电反馈 PID 自整定 (Astrom-Hagglund)
+ * @note    - 在设定值附近用带回差的继电器代替控制器：误差 > h 输出 bias + d，
+ *            误差 < -h 输出 bias - d，回路进入极限环振荡
+ *          - 每个周期测振荡周期 Tu 和半峰峰值 a，按描述函数得临界增益
+ *            Ku = 4d / (pi * sqrt(a^2 - h^2))，bias 靠近输出限幅时 d 两侧同时收窄；
+ *            bias 每周期取上一周期的平均输出，使振荡对称 (即自动找到设定值所需的
+ *            稳态输出)；初始 bias 不足以越过设定值时按 PID_AT_STALL_S 逐步抬高
+ *          - 连续 PID_AT_STABLE_PERIODS 个对称周期的 Tu、a 都稳定后按所选规则
+ *            计算增益，换算成本工程按 PID_REF_DT 标定的 Kp/Ki/Kd
+ *          - 纯计算模块，无硬件依赖，上位机仿真 tools/autotune_sim.c 直接链接
+ * @date    2026-02-19
+ */
+
+#ifndef __PID_AUTOTUNE_H
+#define __PID_AUTOTUNE_H
+
+#include <stdint.h>
+
+/* 配置项 */
+#define PID_AT_STABLE_PERIODS   3       // 判定收敛所需的连续稳定周期数
+#define PID_AT_TU_TOL           0.05f   // 周期相对偏差容限
+#define PID_AT_AMP_TOL          0.10f   // 振幅相对偏差容限
+#define PID_AT_SYM_TOL          0.10f   // 对称性容限 (|高电平占比*2 - 1|)
+#define PID_AT_STALL_S          0.5f    // 继电器持续该时间 (s) 未切换：bias 向该方向移动 d/2
+
+/**
+ * @brief 整定规则
+ */
+typedef enum {
+    PID_AT_RULE_PI_TL = 0,  // PI，Tyreus-Luyben：Kp = Ku/3.2，Ti = 2.2Tu (稳健，默认)
+    PID_AT_RULE_PI_ZN,      // PI，Ziegler-Nichols：Kp = 0.45Ku，Ti = Tu/1.2
+    PID_AT_RULE_PID_ZN,     // PID，Ziegler-Nichols：Kp = 0.6Ku，Ti = Tu/2，Td = Tu/8
+    PID_AT_RULE_PID_NO_OS,  // PID，无超调：Kp = 0.2Ku，Ti = Tu/2，Td = Tu/3
+    PID_AT_RULE_COUNT
+} PID_AT_Rule_t;
+
+/**
+ * @brief 整定状态
+ */
+typedef enum {
+    PID_AT_IDLE = 0,
+    PID_AT_RUNNING,
+    PID_AT_DONE,            // 收敛，结果有效
+    PID_AT_FAILED           // 超时或振幅不足
+} PID_AT_State_t;
+
+/**
+ * @brief 自整定实例
+ */
+typedef struct {
+    /* 配置 */
+    float setpoint;         // 设定值
+    float relay;            // 继电幅值 d
+    float hyst;             // 回差 h
+    float out_min;          // 输出下限
+    float out_max;          // 输出上限
+    float dt;               // 调用周期 (s)
+    uint32_t max_ticks;     // 超时节拍数
+    PID_AT_Rule_t rule;
+
+    /* 过程 */
+    PID_AT_State_t state;
+    float bias;             // 继电中心 (自适应)
+    int8_t out_sign;        // +1 高 / -1 低
+    uint8_t started;        // 已出现过一次上升切换
+    uint32_t ticks;
+    uint32_t last_rise;     // 上次上升切换的节拍
+    uint32_t last_switch;   // 上次切换 (或 bias 调整) 的节拍
+    uint32_t stall_ticks;   // 未切换判定节拍数
+    uint32_t high_ticks;    // 本周期高电平节拍数
+    float y_max, y_min;     // 本周期测量极值
+    float out_sum;          // 本周期输出累加
+    uint8_t periods;        // 已记录的对称周期数 (环形)
+    float tu_hist[PID_AT_STABLE_PERIODS];
+    float amp_hist[PID_AT_STABLE_PERIODS];
+
+    /* 结果 */
+    float Ku;               // 临界增益
+    float Tu;               // 临界周期 (s)
+    float amp;              // 振幅 a
+    float relay_eff;        // 收敛周期内的实际继电幅值 (可能因限幅小于 relay)
+    float Kp, Ki, Kd;       // 按 PID_REF_DT 标定的增益 (可直接写入 App_Params_t)
+} PID_AT_t;
+
+/**
+ * @brief 初始化并启动自整定
+ * @param setpoint 设定值
+ * @param bias     初始继电中心 (设定值所需输出的估计，未知可取 relay)
+ * @param relay    继电幅值 d (振幅需明显大于测量噪声)
+ * @param hyst     回差 h (取测量噪声峰值左右)
+ * @param out_min/out_max 输出限幅
+ * @param dt       调用周期 (s)
+ * @param timeout  超时 (s)
+ */
+void PID_AT_Init(PID_AT_t *at, float setpoint, float bias, float relay, float hyst,
+                 float out_min, float out_max, float dt, float timeout, PID_AT_Rule_t rule);
+
+/**
+ * @brief 自整定单步
+ * @param y 当前测量值
+ * @param u 输出本拍控制量 (结束后为 0)
+ * @return 当前状态
+ */
+PID_AT_State_t PID_AT_Step(PID_AT_t *at, float y, float *u);
+
+/**
+ * @brief 按规则由 Ku、Tu 计算增益 (结果写入 at->Kp/Ki/Kd)
+ */
+void PID_AT_Compute(PID_AT_t *at, PID_AT_Rule_t rule);
+
+/**
+ * @brief 规则名称 (显示用)
+ */
+const char *PID_AT_RuleName(PID_AT_Rule_t rule);
+
+#endif /* __PID_AUTOTUNE_H */
@@ -0,0 +1,109 @@
+/**
+ * @file    pid_bank.c
+ * @brief   PID 控制器组实现
+ * @date    2026-02-19
+ */
+
+#include "pid_bank.h"
+#include <string.h>
+
+#define PID_BANK_TT_MIN_INV     1.0e30f     // 跟踪时间取 0 (一步回退到饱和边界)
+
+/**
+ * @brief 初始化控制器组
+ */
+void PID_Bank_Init(PID_Bank_t *bank, uint8_t n)
+{
+    memset(bank, 0, sizeof(*bank));
+    bank->n = (n > PID_BANK_MAX) ? PID_BANK_MAX : n;
+}
+
+/**
+ * @brief 设置单个通道的参数
+ * @note  跟踪时间与 PID_Update 的默认值相同：Tt = Kp*PID_REF_DT/Ki；
+ *        Kp <= 0 时 PID_Update 取 Tt = dt，即每次回退量系数为 1
+ */
+void PID_Bank_SetGains(PID_Bank_t *bank, uint8_t ch, float kp, float ki, float kd, float max_out, float max_int)
+{
+    if (ch >= bank->n) {
+        return;
+    }
+
+    bank->Kp[ch] = kp;
+    bank->Ki[ch] = ki;
+    bank->Kd[ch] = kd;
+    bank->max_output[ch] = max_out;
+    bank->max_i_term[ch] = ((ki >= 0.0f) ? ki : -ki) * max_int;
+
+    if (ki == 0.0f) {
+        bank->inv_tt[ch] = 0.0f;
+    } else if (kp > 0.0f) {
+        bank->inv_tt[ch] = ki / (kp * PID_REF_DT);
+    } else {
+        bank->inv_tt[ch] = PID_BANK_TT_MIN_INV;
+    }
+}
+
+/**
+ * @brief 从 PID_Controller_t 复制参数
+ */
+void PID_Bank_Load(PID_Bank_t *bank, uint8_t ch, const PID_Controller_t *pid)
+{
+    PID_Bank_SetGains(bank, ch, pid->Kp, pid->Ki, pid->Kd, pid->max_output, pid->max_integral);
+
+    if (ch < bank->n && pid->Ki != 0.0f && pid->aw_tt > 0.0f) {
+        bank->inv_tt[ch] = 1.0f / pid->aw_tt;
+    }
+}
+
+/**
+ * @brief 复位所有通道的状态
+ */
+void PID_Bank_Reset(PID_Bank_t *bank)
+{
+    memset(bank->i_term, 0, sizeof(bank->i_term));
+    memset(bank->prev_actual, 0, sizeof(bank->prev_actual));
+    memset(bank->d_gate, 0, sizeof(bank->d_gate));
+    memset(bank->output, 0, sizeof(bank->output));
+}
+
+/**
+ * @brief 一次更新全部通道
+ * @note  每个通道：
+ *          u = sat(Kp*e + I + gate * Kd*PID_REF_DT/dt * (y[n-1] - y))
+ *          I = sat(I + Ki*dt/PID_REF_DT * e + min(dt/Tt, 1) * (u - v))
+ *        循环体只有乘加和比较选择，没有除法 (1/dt 在循环外算一次)
+ */
+void PID_Bank_Update(PID_Bank_t *bank, const float *target, const float *actual, float dt)
+{
+    uint32_t i;
+    uint32_t n = bank->n;
+    float k, kd_dt;
+
+    if (dt <= 0.0f) {
+        return;
+    }
+    k     = dt / PID_REF_DT;
+    kd_dt = PID_REF_DT / dt;
+
+    for (i = 0; i < n; i++) {
+        float y = actual[i];
+        float e = target[i] - y;
+        float d = bank->d_gate[i] * bank->Kd[i] * kd_dt * (bank->prev_actual[i] - y);
+        float v = bank->Kp[i] * e + bank->i_term[i] + d;
+        float lim = bank->max_output[i];
+        float u = (v > lim) ? lim : ((v < -lim) ? -lim : v);
+        float g = dt * bank->inv_tt[i];
+        float it, ilim;
+
+        g = (g > 1.0f) ? 1.0f : g;
+        it = bank->i_term[i] + bank->Ki[i] * k * e + g * (u - v);
+        ilim = bank->max_i_term[i];
+        it = (it > ilim) ? ilim : ((it < -ilim) ? -ilim : it);
+
+        bank->i_term[i]      = it;
+        bank->prev_actual[i] = y;
+        bank->d_gate[i]      = 1.0f;
+        bank->output[i]      = u;
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file    pid_bank.h
+ * @brief   PID 控制器组 (结构体数组转数组结构体，一次更新 N 个回路)
+ * @note    - 每个字段按通道连续存放 (SoA)，更新循环里没有分支和函数调用，
+ *            便于 FPU 流水线连续执行，主机编译时也能被自动向量化
+ *          - 算法与默认配置的 PID_Update 一致 (b = 1、c = 0、无微分滤波、
+ *            反算抗饱和跟踪时间自动取积分时间)，积分以 Ki*integral 的形式保存，
+ *            省掉每次的乘法；同一组内的通道共用同一个 dt，不同速率的回路应分组
+ * @date    2026-02-19
+ */
+
+#ifndef __PID_BANK_H
+#define __PID_BANK_H
+
+#include <stdint.h>
+#include "pid.h"
+
+#define PID_BANK_MAX    4       // 单组最大通道数
+
+/**
+ * @brief PID 控制器组
+ */
+typedef struct {
+    uint8_t n;                          // 通道数
+
+    /* 参数 */
+    float Kp[PID_BANK_MAX];             // 比例系数
+    float Ki[PID_BANK_MAX];             // 积分系数 (按 PID_REF_DT 整定)
+    float Kd[PID_BANK_MAX];             // 微分系数 (按 PID_REF_DT 整定)
+    float max_output[PID_BANK_MAX];     // 输出限幅
+    float max_i_term[PID_BANK_MAX];     // 积分项限幅 (|Ki| * max_integral)
+    float inv_tt[PID_BANK_MAX];         // 抗饱和跟踪时间的倒数 (1/s)，0 不积分
+
+    /* 状态 */
+    float i_term[PID_BANK_MAX];         // 积分项 (Ki * integral)
+    float prev_actual[PID_BANK_MAX];    // 上一次实际值 (对测量值微分)
+    float d_gate[PID_BANK_MAX];         // 复位后第一次为 0，屏蔽微分冲击
+    float output[PID_BANK_MAX];         // 输出 (已限幅)
+} PID_Bank_t;
+
+/**
+ * @brief 初始化控制器组 (参数清零，状态复位)
+ * @param n 通道数 (超过 PID_BANK_MAX 按 PID_BANK_MAX 处理)
+ */
+void PID_Bank_Init(PID_Bank_t *bank, uint8_t n);
+
+/**
+ * @brief 设置单个通道的参数 (与 PID_Init 含义相同)
+ */
+void PID_Bank_SetGains(PID_Bank_t *bank, uint8_t ch, float kp, float ki, float kd, float max_out, float max_int);
+
+/**
+ * @brief 从 PID_Controller_t 复制参数到单个通道 (含 aw_tt；b、c、Tf 不支持，忽略)
+ */
+void PID_Bank_Load(PID_Bank_t *bank, uint8_t ch, const PID_Controller_t *pid);
+
+/**
+ * @brief 复位所有通道的状态
+ */
+void PID_Bank_Reset(PID_Bank_t *bank);
+
+/**
+ * @brief 一次更新全部通道
+ * @param target 各通道目标值 (n 个)
+ * @param actual 各通道实际值 (n 个)
+ * @param dt     距上次更新的时间 (s)，<= 0 时保持上次输出
+ * @note  结果在 bank->output[]
+ */
+void PID_Bank_Update(PID_Bank_t *bank, const float *target, const float *actual, float dt);
+
+#endif /* __PID_BANK_H */
@@ -0,0 +1,99 @@
+/**
+ * @file    target_track.c
+ * @brief   视觉目标的匀速模型卡尔曼跟踪器实现
+ * @date    2026-02-19
+ */
+
+#include "target_track.h"
+#include <string.h>
+
+/**
+ * @brief 以测量 z 初始化：位置取测量，速度未知
+ */
+static void Track_Start(Track_1D_t *t, float z)
+{
+    t->valid      = 1;
+    t->reject_run = 0;
+    t->p          = z;
+    t->v          = 0.0f;
+    t->P00        = t->cfg.r;
+    t->P01        = 0.0f;
+    t->P11        = t->cfg.v0_var;
+    t->inits++;
+}
+
+void Track_Init(Track_1D_t *t, const Track_Cfg_t *cfg)
+{
+    memset(t, 0, sizeof(*t));
+    t->cfg = *cfg;
+}
+
+void Track_Reset(Track_1D_t *t)
+{
+    t->valid      = 0;
+    t->reject_run = 0;
+}
+
+/**
+ * @brief 时间更新
+ * @note  F = [1 dt; 0 1]，Q = q * [dt³/3 dt²/2; dt²/2 dt]，P = F P F' + Q
+ */
+void Track_Predict(Track_1D_t *t, float dt)
+{
+    float dt2, q;
+
+    if (!t->valid || dt <= 0.0f) {
+        return;
+    }
+    dt2 = dt * dt;
+    q   = t->cfg.q;
+
+    t->p   += t->v * dt;
+    t->P00 += dt * (2.0f * t->P01 + dt * t->P11) + q * dt2 * dt * (1.0f / 3.0f);
+    t->P01 += dt * t->P11 + q * dt2 * 0.5f;
+    t->P11 += q * dt;
+}
+
+/**
+ * @brief 测量更新
+ * @note  H = [1 0]：S = P00 + r，K = [P00 P01] / S，P = (I - K H) P
+ */
+Track_Result_t Track_Update(Track_1D_t *t, float z)
+{
+    float y, s, k0, k1;
+
+    if (!t->valid) {
+        Track_Start(t, z);
+        return TRACK_INIT;
+    }
+
+    /* 1. 新息门限 */
+    y = z - t->p;
+    s = t->P00 + t->cfg.r;
+    t->nis = y * y / s;
+    if (t->nis > t->cfg.gate) {
+        t->rejects++;
+        if (++t->reject_run >= t->cfg.max_reject) {
+            Track_Start(t, z);
+            return TRACK_INIT;
+        }
+        return TRACK_REJECT;
+    }
+    t->reject_run = 0;
+
+    /* 2. 状态与协方差更新 (先算 P11 再改 P01) */
+    k0 = t->P00 / s;
+    k1 = t->P01 / s;
+    t->p   += k0 * y;
+    t->v   += k1 * y;
+    t->P11 -= k1 * t->P01;
+    t->P01 -= k0 * t->P01;
+    t->P00 -= k0 * t->P00;
+    t->updates++;
+    return TRACK_ACCEPT;
+}
+
+float Track_Predict_At(const Track_1D_t *t, float dt)
+{
+    return t->p + t->v * dt;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file    target_track.h
+ * @brief   视觉目标的匀速模型卡尔曼跟踪器 (单轴：位置 + 速度)
+ * @note    - 每个坐标 (目标 X、距离) 各用一个实例，互不耦合
+ *          - 状态 [p, v]，过程噪声为白噪声加速度 (谱密度 q)，测量只有位置 (方差 r)；
+ *            2x2 协方差按对称展开计算，不调用矩阵库，可在任务中每帧调用
+ *          - 新息门限：新息平方 / 新息方差 (NIS，1 自由度卡方) 超过 gate 的测量视为
+ *            野值丢弃，只做预测；连续 max_reject 次被拒说明目标确实跳变 (换目标等)，
+ *            以最新测量重新初始化
+ *          - 两帧之间用 Track_Predict_At 外推到任意时刻，不改变滤波状态
+ * @date    2026-02-19
+ */
+
+#ifndef __TARGET_TRACK_H
+#define __TARGET_TRACK_H
+
+#include <stdint.h>
+
+/**
+ * @brief 跟踪器参数
+ */
+typedef struct {
+    float   q;              // 过程噪声：加速度谱密度 (单位²/s³)，越大越跟得上机动、越不平滑
+    float   r;              // 测量噪声方差 (单位²)
+    float   v0_var;         // 初始化时的速度方差 (单位²/s²)
+    float   gate;           // NIS 门限 (9 约为 3σ)
+    uint8_t max_reject;     // 连续被拒次数达到该值时重新初始化
+} Track_Cfg_t;
+
+/**
+ * @brief Track_Update 结果
+ */
+typedef enum {
+    TRACK_ACCEPT = 0,       // 测量被采用
+    TRACK_REJECT,           // 野值，已丢弃
+    TRACK_INIT              // 以本次测量 (重新) 初始化
+} Track_Result_t;
+
+/**
+ * @brief 单轴跟踪器
+ */
+typedef struct {
+    Track_Cfg_t cfg;
+    uint8_t  valid;         // 已初始化
+    uint8_t  reject_run;    // 连续被拒次数
+    float    p;             // 位置估计
+    float    v;             // 速度估计 (单位/s)
+    float    P00, P01, P11; // 协方差 (对称)
+    float    nis;           // 最近一次测量的 NIS
+
+    uint32_t updates;       // 采用的测量数
+    uint32_t rejects;       // 丢弃的野值数
+    uint32_t inits;         // (重新) 初始化次数
+} Track_1D_t;
+
+/**
+ * @brief 初始化 (清空状态和统计)
+ */
+void Track_Init(Track_1D_t *t, const Track_Cfg_t *cfg);
+
+/**
+ * @brief 丢弃估计，下一次测量重新初始化 (统计保留)
+ */
+void Track_Reset(Track_1D_t *t);
+
+/**
+ * @brief 时间更新：状态推进 dt 秒
+ * @note  未初始化时为空操作；dt <= 0 忽略
+ */
+void Track_Predict(Track_1D_t *t, float dt);
+
+/**
+ * @brief 测量更新
+ * @param z 位置测量
+ * @return Track_Result_t
+ */
+Track_Result_t Track_Update(Track_1D_t *t, float z);
+
+/**
+ * @brief dt 秒后的位置预测 (不改变状态)
+ */
+float Track_Predict_At(const Track_1D_t *t, float dt);
+
+#endif /* __TARGET_TRACK_H */
@@ -2,38 +2,68 @@
  * @file    app_comm.c
  * @brief   ESP8266 WiFi 通信模块实现
  * @note    使用 UART2 中断 (IT) 接收不定长数据
- *          - 中断回调负责将数据复制到处理缓冲区
- *          - 主任务负责解析处理缓冲区的数据
+ *          - 直接接收到命令环 (os_ring.h) 的空闲槽位中，空闲中断时发布该槽位，不拷贝
+ *          - 通信任务阻塞在事件上，被唤醒后就地解析环中的所有命令
  * @date    2026-02-19
  */
 
 #include "app_comm.h"
 #include "usart.h"
+#include "os.h"
+#include "os_ring.h"
+#include "app_trace.h"
+#include "app_follow.h"
+#include "../Bsp/Bsp_Flash.h"
+#include "../Bsp/Bsp_OpenMV.h"
 #include <string.h>
 #include <stdio.h>
 
 /* 配置项 */
 #define WIFI_UART       huart2
 #define RX_BUFFER_SIZE  128
+#define CMD_QUEUE_DEPTH 4       // 命令队列深度 (帧，必须为 2 的幂)
+#define CMD_EVT_RX      0x01U
+
+/* 命令消息：一帧不定长数据 */
+typedef struct {
+    uint16_t len;
+    char     data[RX_BUFFER_SIZE];
+} Comm_Msg_t;
 
 /* 全局变量定义 */
 volatile Robot_Command_t g_remote_cmd = CMD_STOP;
 volatile Robot_Mode_t    g_robot_mode = MODE_MANUAL;
 
 /* 私有变量 */
-static uint8_t rx_buffer[RX_BUFFER_SIZE];
-static uint8_t process_buffer[RX_BUFFER_SIZE];
-static volatile uint16_t process_len = 0;
-static volatile uint8_t  process_ready = 0;
+static Comm_Msg_t cmd_ring_buf[CMD_QUEUE_DEPTH];
+static OS_Ring_t  cmd_ring;
+static OS_Event_t cmd_event;
+static Comm_Msg_t rx_discard;   // 命令环满时接收到这里 (丢弃该帧)
+static Comm_Msg_t *rx_msg;      // 正在接收的槽位 (ISR 所有)
+
+/**
+ * @brief 取下一个接收槽位并启动接收 (ISR 上下文或初始化时调用)
+ */
+static void App_Comm_Start_Rx(void)
+{
+    rx_msg = (Comm_Msg_t *)OS_Ring_WriteSlot(&cmd_ring);
+    if (rx_msg == NULL) {
+        rx_msg = &rx_discard;
+    }
+    HAL_UARTEx_ReceiveToIdle_IT(&WIFI_UART, (uint8_t *)rx_msg->data, RX_BUFFER_SIZE);
+}
 
 /**
  * @brief 通信模块初始化
  */
 void App_Comm_Init(void)
 {
+    OS_Ring_Init(&cmd_ring, cmd_ring_buf, sizeof(Comm_Msg_t), CMD_QUEUE_DEPTH);
+    OS_EventInit(&cmd_event);
+
     /* 启动 UART 接收 (中断模式) */
     /* 使用 HAL_UARTEx_ReceiveToIdle_IT 实现不定长接收 */
-    HAL_UARTEx_ReceiveToIdle_IT(&WIFI_UART, rx_buffer, RX_BUFFER_SIZE);
+    App_Comm_Start_Rx();
 }
 
 /**
@@ -68,20 +98,120 @@ static void App_Comm_Parse_Internal(char *data, uint16_t len)
             g_remote_cmd = CMD_STOP; // 切换回手动时先停止
         }
     }
+    /* 查询任务执行统计: STATS (结果从调试串口 USART1 打印) */
+    else if (strncmp(data, "STATS", 5) == 0) {
+        OS_PrintTaskStats();
+    }
+    /* trace 与文本日志耗时对比: TRACEBENCH (结果从调试串口 USART1 打印) */
+    else if (strncmp(data, "TRACEBENCH", 10) == 0) {
+        App_Trace_Bench();
+    }
+    /* 速度环前馈: FFIDENT 辨识 (车轮须离地)，FFSTOP 中止，FFSHOW 打印，FFCLEAR 清除 */
+    else if (strncmp(data, "FFIDENT", 7) == 0) {
+        printf("[FF] ident %s\r\n", (App_Follow_FF_Ident_Start() == 0) ? "started, wheels must be off the ground" : "busy");
+    }
+    else if (strncmp(data, "FFSTOP", 6) == 0) {
+        App_Follow_FF_Ident_Stop();
+    }
+    else if (strncmp(data, "FFSHOW", 6) == 0) {
+        App_Follow_FF_Print();
+    }
+    else if (strncmp(data, "FFCLEAR", 7) == 0) {
+        App_Follow_FF_Clear();
+        printf("[FF] cleared\r\n");
+    }
+    /* 速度环自整定: ATUNE 或 ATUNE:n (n 为 PID_AT_Rule_t，默认 0 = PI TL，车轮须离地)，ATSTOP 中止 */
+    else if (strncmp(data, "ATUNE", 5) == 0) {
+        PID_AT_Rule_t rule = PID_AT_RULE_PI_TL;
+        if (data[5] == ':' && data[6] >= '0' && data[6] < '0' + PID_AT_RULE_COUNT) {
+            rule = (PID_AT_Rule_t)(data[6] - '0');
+        }
+        printf("[AT] %s %s\r\n", PID_AT_RuleName(rule),
+               (App_Follow_AutoTune_Start(rule) == 0) ? "started, wheels must be off the ground" : "busy");
+    }
+    else if (strncmp(data, "ATSTOP", 6) == 0) {
+        App_Follow_AutoTune_Stop();
+    }
+    /* 外环增益调度 (L 为 D 距离环 / A 角度环，修改只在 RAM 中生效，GSSAVE 写入 Flash):
+     *   GS:L,ON | GS:L,OFF            启用/停用
+     *   GS:L,R,src,min,max            调度变量 (0 距离 cm，1 平均轮速 RPM) 与断点范围
+     *   GS:L,i,kp,ki,kd               第 i 个断点的增益
+     *   GSSHOW / GSSAVE */
+    else if (strncmp(data, "GS:", 3) == 0 && (data[3] == 'D' || data[3] == 'A') && data[4] == ',') {
+        uint8_t loop = (data[3] == 'A') ? FOLLOW_LOOP_ANGLE : FOLLOW_LOOP_DIST;
+        const char *arg = &data[5];
+        int n;
+        float a, b, c;
+        int32_t ret = -1;
+
+        if (strncmp(arg, "ON", 2) == 0) {
+            App_Follow_GS_Enable(loop, 1);
+            ret = 0;
+        } else if (strncmp(arg, "OFF", 3) == 0) {
+            App_Follow_GS_Enable(loop, 0);
+            ret = 0;
+        } else if (arg[0] == 'R' && sscanf(&arg[1], ",%d,%f,%f", &n, &a, &b) == 3) {
+            ret = App_Follow_GS_SetRange(loop, (uint8_t)n, a, b);
+        } else if (sscanf(arg, "%d,%f,%f,%f", &n, &a, &b, &c) == 4 && n >= 0) {
+            ret = App_Follow_GS_SetPoint(loop, (uint8_t)n, a, b, c);
+        }
+        printf("[GS] %s\r\n", (ret == 0) ? "ok" : "bad args");
+    }
+    else if (strncmp(data, "GSSHOW", 6) == 0) {
+        App_Follow_GS_Print();
+    }
+    else if (strncmp(data, "GSSAVE", 6) == 0) {
+        App_Flash_Save();
+        printf("[GS] saved\r\n");
+    }
+    /* OpenMV 协议解码统计: OMVSTAT (结果从调试串口 USART1 打印) */
+    else if (strncmp(data, "OMVSTAT", 7) == 0) {
+        const OMV_Proto_Stats_t *st = OpenMV_Get_Stats();
+        printf("[OMV] v1 %lu v2 %lu crc_err %lu bad %lu lost %lu dup %lu fallback %lu overrun %lu\r\n",
+               (unsigned long)st->frames_v1, (unsigned long)st->frames_v2, (unsigned long)st->crc_err,
+               (unsigned long)st->bad, (unsigned long)st->lost, (unsigned long)st->dup,
+               (unsigned long)st->fallback, (unsigned long)OpenMV_Get_Overruns());
+    }
+    /* 视觉延迟与目标跟踪器: VLAT (结果从调试串口 USART1 打印) */
+    else if (strncmp(data, "VLAT", 4) == 0) {
+        static const char *const name[FOLLOW_LOOP_COUNT] = { "dist", "x" };
+        const Follow_Latency_t *lat = App_Follow_Latency_Get();
+        uint8_t i;
+        printf("[VLAT] age %.1f jitter %.1f total %.1f (max %.1f) ms, x_rate %.1f px/s, comp %.1f px\r\n",
+               lat->age_ms, lat->jitter_ms, lat->total_ms, lat->total_max_ms, lat->x_rate, lat->x_comp);
+        for (i = 0; i < FOLLOW_LOOP_COUNT; i++) {
+            const Track_1D_t *t = App_Follow_Track_Get(i);
+            printf("[VLAT] track %s: p %.1f v %.1f nis %.2f, updates %lu rejects %lu inits %lu\r\n",
+                   name[i], t->p, t->v, t->nis, (unsigned long)t->updates,
+                   (unsigned long)t->rejects, (unsigned long)t->inits);
+        }
+    }
+    /* 逐帧视觉数据记录: VLOG:1 开，VLOG:0 关 (trace 输出，供 tools/target_track_replay.c 回放) */
+    else if (strncmp(data, "VLOG:", 5) == 0) {
+        App_Follow_Vision_Log(data[5] == '1');
+        printf("[VLOG] %s\r\n", (data[5] == '1') ? "on" : "off");
+    }
+    /* PID 各计算后端耗时对比: PIDBENCH (结果从调试串口 USART1 打印) */
+    else if (strncmp(data, "PIDBENCH", 8) == 0) {
+        PID_Bench();
+    }
 }
 
 /**
- * @brief 处理任务 (在主循环中调用)
+ * @brief 处理任务 (在通信任务中调用)
+ * @note  取完环中的所有命令后阻塞在事件上，直到下一帧到达才会再次被调度
  */
 void App_Comm_ProcessTask(void)
 {
-    if (process_ready) {
-        /* 处理数据 */
-        App_Comm_Parse_Internal((char *)process_buffer, process_len);
-        
-        /* 清除标志 */
-        process_ready = 0;
-    }
+    Comm_Msg_t *msg;
+
+    do {
+        while ((msg = (Comm_Msg_t *)OS_Ring_ReadSlot(&cmd_ring)) != NULL) {
+            App_Comm_Parse_Internal(msg->data, msg->len);
+            OS_Ring_ReadRelease(&cmd_ring);
+        }
+        // 检查为空之后才到达的帧会留下事件标志，Wait 直接返回 OK 再取一轮
+    } while (OS_EventWait(&cmd_event, CMD_EVT_RX, OS_WAIT_FOREVER, NULL) == OS_OK);
 }
 
 /**
@@ -91,14 +221,16 @@ void App_Comm_ProcessTask(void)
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 {
     if (huart->Instance == WIFI_UART.Instance) {
-        /* 将数据复制到处理缓冲区 (如果上一次还没处理完，会覆盖，保证实时性) */
+        /* 发布接收完的槽位，唤醒通信任务 (环满时收在丢弃缓冲里，该帧丢弃) */
         if (Size > RX_BUFFER_SIZE) Size = RX_BUFFER_SIZE;
-        memcpy(process_buffer, rx_buffer, Size);
-        process_len = Size;
-        process_ready = 1;
+        if (rx_msg != &rx_discard && Size > 0) {
+            rx_msg->len = Size;
+            OS_Ring_WriteCommit(&cmd_ring);
+            OS_EventSet(&cmd_event, CMD_EVT_RX);
+        }
 
         /* 重新启动接收 (中断模式) */
-        HAL_UARTEx_ReceiveToIdle_IT(&WIFI_UART, rx_buffer, RX_BUFFER_SIZE);
+        App_Comm_Start_Rx();
     }
 }
 
@@ -106,7 +238,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
     if (huart->Instance == WIFI_UART.Instance) {
-        /* 发生错误时尝试重启接收 */
-        HAL_UARTEx_ReceiveToIdle_IT(&WIFI_UART, rx_buffer, RX_BUFFER_SIZE);
+        /* 发生错误时尝试重启接收 (槽位未发布，仍可复用) */
+        App_Comm_Start_Rx();
     }
 }
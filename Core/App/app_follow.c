@@ -0,0 +1,923 @@
+/**
+ * @file    app_follow.c
+ * @brief   视觉跟随控制：视觉外环 (距离/角度) + 电机速度环，及其整定与调试接口
+ * @date    2026-02-19
+ */
+
+#include "app_follow.h"
+#include "bsp_openmv.h"
+#include "bsp_encoder.h"
+#include "bsp_tb6612.h"
+#include "app_comm.h"
+#include "app_trace.h"
+#include "ctrl_rate.h"
+#include "pid_bank.h"
+#include "motor_ff.h"
+#include "os.h"
+#include "../Bsp/Bsp_Flash.h"
+#include "arm_math.h"
+
+#include <stdio.h> // Ensure printf is available
+
+/* --- 宏定义 --- */
+#define FOLLOW_TARGET_DIST      20.0f   // 目标跟随距离 (cm)
+#define FOLLOW_TARGET_X_CENTER  80.0f   // 图像中心 X 坐标 (假设分辨率 160x120)
+#define LOSS_TIMEOUT_SLOW_MS    500     // 丢包减速阈值 (ms)
+#define LOSS_TIMEOUT_STOP_MS    1000    // 丢包急停阈值 (ms)
+
+/* 多速率配置：速度环频率由 TIM14 决定 (ENCODER_SAMPLE_HZ)，外环由视觉帧驱动 */
+#define VISION_DECIM            1       // 每 N 帧视觉数据执行一次外环
+#define VISION_DT_NOM           0.033f  // 外环标称周期 (s)，OpenMV 约 30 帧/秒
+#define VISION_DT_MAX           0.2f    // 帧间隔超过该值 (s) 视为中断，外环重新开始
+#define VISION_D_FILTER_TF      0.066f  // 外环微分低通时间常数 (s)，约两帧
+
+/* 视觉延迟补偿：角度环按 "相机曝光 -> 本次计算" 的总延迟把目标 X 外推到当前时刻 */
+#define VISION_LAT_COMP         1       // 1: 角度环使用延迟补偿后的 X
+#define VISION_LAT_CAM_MS       25.0f   // 曝光到开始发送的固定延迟 (ms)，约一帧图像处理时间，不可测
+#define VISION_LAT_MAX_MS       150.0f  // 参与补偿的总延迟上限 (ms)
+#define VISION_LAT_MIN_LEAK_MS  0.01f   // 传输延迟下界每帧上浮量 (ms)，跟随两边晶振漂移
+
+/* 视觉目标跟踪：X 与距离各一个匀速模型卡尔曼跟踪器 (参数见 track_cfg_*) */
+#define TRACK_COAST_MS          150.0f  // 目标短暂丢失时按预测继续跟随的时间 (ms)，超过则停车
+#define LOOP_TICKS(ms)          ((uint32_t)(ms) * ENCODER_SAMPLE_HZ / 1000U)  // 毫秒换算为速度环节拍数
+
+/* 速度环自整定 (车轮离地，与 tools/autotune_sim.c 保持一致) */
+#define AT_SETPOINT_RPM         120.0f  // 继电振荡中心转速
+#define AT_RELAY_PWM            1200.0f // 继电幅值 d
+#define AT_HYST_RPM             3.0f    // 回差，约一个编码器计数对应的转速分辨率
+#define AT_TIMEOUT_S            10.0f   // 超时
+
+/* --- 全局变量 --- */
+/* 外环：视觉位置环 */
+PID_Controller_t pid_dist;      // 距离环 (输出线速度 v_linear)
+PID_Controller_t pid_angle;     // 角度环 (输出角速度 v_angular)
+
+/* 内环：电机速度环 */
+PID_Controller_t pid_speed_L;   // 左电机速度环
+PID_Controller_t pid_speed_R;   // 右电机速度环
+
+/* 状态变量 */
+static volatile uint32_t vision_rx_cyc = 0; // 最近一帧视觉数据的接收时刻 (DWT)，丢包计时起点
+static volatile uint8_t vision_fresh = 0;   // 0 未收到数据或已超时 (超时后锁存，不受 DWT 约 25s 回绕影响)
+static uint32_t cyc_per_ms = 1;             // DWT 每毫秒周期数
+static volatile float target_speed_L = 0.0f; // 左轮目标速度 (RPM)，外环写、速度环读
+static volatile float target_speed_R = 0.0f; // 右轮目标速度 (RPM)
+static volatile uint8_t outer_reset_req = 1; // 速度环请求外环重置 (模式切换/急停/丢包)
+
+/* 速度环自整定：左右电机各一个实例，同时运行 */
+static PID_AT_t at_L, at_R;
+static volatile uint8_t at_active = 0;
+static volatile uint8_t at_stop_req = 0;
+
+/* 视觉目标跟踪器 (只在视觉外环中修改)
+ * 参数 {q, r, v0_var, gate, max_reject} 用 tools/target_track_replay.c 回放整定，两边保持一致：
+ * X 测量噪声约 2 像素，目标可在 0.5s 内横移半个画面；距离噪声约 2cm，变化慢 */
+static const Track_Cfg_t track_cfg_x    = { 20000.0f, 4.0f, 10000.0f, 9.0f, 3 };
+static const Track_Cfg_t track_cfg_dist = { 400.0f,   4.0f, 400.0f,   9.0f, 3 };
+static Track_1D_t track[FOLLOW_LOOP_COUNT];     // 按 Follow_Loop_t 索引：距离、X (角度环)
+static uint8_t vision_log = 0;                  // 1: 每帧记录 TR_VISION_FRAME (回放用)
+
+/* 外环增益调度：最近一次查表结果 (显示用) */
+static Gain_Sched_Out_t gs_out[FOLLOW_LOOP_COUNT];
+
+/* 视觉延迟测量 (只在视觉外环中修改) */
+static Follow_Latency_t vision_lat;
+static struct {
+    uint8_t  valid;         // 有上一帧 (找到目标的帧)
+    uint16_t ts_ms;         // 上一帧相机时间戳 (v2)
+    uint32_t rx_cyc;        // 上一帧接收时刻
+    uint32_t rx_tick;       // 上一帧处理时的 OS tick (判定过期用，约 49 天才回绕)
+    float    rel_delay;     // 传输延迟相对第一帧的变化 (ms，v2)
+    float    min_delay;     // rel_delay 的下界 (缓慢上浮)
+} lat_prev;
+
+/* 速率管理 */
+static Ctrl_EventRate_t vision_rate;                                    // 外环：帧驱动
+static Ctrl_Decim_t alive_decim = CTRL_DECIM_INIT(LOOP_TICKS(1000));    // 1s 心跳
+static Ctrl_Decim_t debug_decim = CTRL_DECIM_INIT(LOOP_TICKS(500));     // 500ms 调试输出
+
+/**
+ * @brief 丢包计时从 rx_cyc 开始
+ * @note  先写时间戳再置位，速度环中断不会用旧时间戳判定超时
+ */
+static void App_Follow_Loss_Restart(uint32_t rx_cyc)
+{
+    vision_rx_cyc = rx_cyc;
+    vision_fresh = 1;
+}
+
+/**
+ * @brief 最近一帧视觉数据的时效 (ms，速度环中断中调用)
+ * @return 超时或从未收到数据时返回 LOSS_TIMEOUT_STOP_MS
+ */
+static uint32_t App_Follow_Sample_Age_Ms(void)
+{
+    uint32_t age;
+
+    if (!vision_fresh) {
+        return LOSS_TIMEOUT_STOP_MS;
+    }
+    age = (DWT->CYCCNT - vision_rx_cyc) / cyc_per_ms;
+    if (age >= LOSS_TIMEOUT_STOP_MS) {
+        vision_fresh = 0;       // 锁存，直到收到新帧
+        age = LOSS_TIMEOUT_STOP_MS;
+    }
+    return age;
+}
+
+/**
+ * @brief 按各回路周期生成 PID 后端系数 (浮点后端为空操作)
+ * @note  关中断写入，避免速度环用到一半新一半旧的系数
+ */
+static void App_Follow_Kernel_Init(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    PID_Kernel_Init(&pid_dist, VISION_DT_NOM);
+    PID_Kernel_Init(&pid_angle, VISION_DT_NOM);
+    PID_Kernel_Init(&pid_speed_L, SAMPLE_TIME_S);
+    PID_Kernel_Init(&pid_speed_R, SAMPLE_TIME_S);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 更新 PID 参数（从全局配置 g_app_params 加载）
+ */
+void App_Follow_Update_PID_Params(void)
+{
+    /* 距离环 */
+    pid_dist.Kp = g_app_params.dist_kp;
+    pid_dist.Ki = g_app_params.dist_ki;
+    pid_dist.Kd = g_app_params.dist_kd;
+    
+    /* 角度环 */
+    pid_angle.Kp = g_app_params.angle_kp;
+    pid_angle.Ki = g_app_params.angle_ki;
+    pid_angle.Kd = g_app_params.angle_kd;
+    
+    /* 速度环 (左轮) */
+    pid_speed_L.Kp = g_app_params.speed_L_kp;
+    pid_speed_L.Ki = g_app_params.speed_L_ki;
+    pid_speed_L.Kd = g_app_params.speed_L_kd;
+    
+    /* 速度环 (右轮) */
+    pid_speed_R.Kp = g_app_params.speed_R_kp;
+    pid_speed_R.Ki = g_app_params.speed_R_ki;
+    pid_speed_R.Kd = g_app_params.speed_R_kd;
+    
+    App_Follow_Kernel_Init();
+}
+
+/**
+ * @brief 初始化跟随控制相关的 PID 控制器
+ * @note  参数需要根据实际机械结构进行整定
+ */
+void App_Follow_Init(void)
+{
+    /* 1. 加载 Flash 参数 */
+    App_Flash_Init();
+    
+    /* 2. 初始化 PID 对象 (先使用 Flash 参数) */
+    
+    /* 初始化距离环 (目标: 保持距离) */
+    /* 输出限幅 100 RPM */
+    PID_Init(&pid_dist, g_app_params.dist_kp, g_app_params.dist_ki, g_app_params.dist_kd, 150.0f, 50.0f);
+
+    /* 初始化角度环 (目标: 保持中心) */
+    /* 输出限幅 50 RPM (差速) */
+    PID_Init(&pid_angle, g_app_params.angle_kp, g_app_params.angle_ki, g_app_params.angle_kd, 80.0f, 30.0f);
+
+    /* 初始化左电机速度环 */
+    /* 输出限幅 PWM满占空比 (假设 4200) */
+    printf("[PID_Init] Speed_L: Kp=%.2f, Ki=%.2f, Kd=%.2f\r\n", g_app_params.speed_L_kp, g_app_params.speed_L_ki, g_app_params.speed_L_kd);
+    PID_Init(&pid_speed_L, g_app_params.speed_L_kp, g_app_params.speed_L_ki, g_app_params.speed_L_kd, 4200.0f, 2000.0f);
+
+    /* 初始化右电机速度环 */
+    printf("[PID_Init] Speed_R: Kp=%.2f, Ki=%.2f, Kd=%.2f\r\n", g_app_params.speed_R_kp, g_app_params.speed_R_ki, g_app_params.speed_R_kd);
+    PID_Init(&pid_speed_R, g_app_params.speed_R_kp, g_app_params.speed_R_ki, g_app_params.speed_R_kd, 4200.0f, 2000.0f);
+
+    /* 外环微分对测量值求导并滤波，抑制图像坐标跳动 */
+    PID_SetDFilter(&pid_dist, VISION_D_FILTER_TF);
+    PID_SetDFilter(&pid_angle, VISION_D_FILTER_TF);
+    App_Follow_Kernel_Init();
+
+    /* 3. 外环由视觉帧驱动，按每帧的接收时间戳 (DWT) 计算帧间隔和样本时效 */
+    Ctrl_EventRate_Init(&vision_rate, VISION_DECIM, VISION_DT_NOM, VISION_DT_MAX, SystemCoreClock);
+    cyc_per_ms = SystemCoreClock / 1000U;
+
+    /* 4. 视觉目标跟踪器 */
+    Track_Init(&track[FOLLOW_LOOP_DIST], &track_cfg_dist);
+    Track_Init(&track[FOLLOW_LOOP_ANGLE], &track_cfg_x);
+}
+
+/**
+ * @brief 前馈辨识结束 (延后处理任务中执行)：装入新表并保存到 Flash
+ */
+static void App_Follow_FF_Ident_Done(void *arg)
+{
+    static Motor_FF_Map_t map_L, map_R;     // 静态：主栈只有 1KB
+    int32_t ret = Motor_FF_Ident_Result(&map_L, &map_R);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    g_app_params.ff_L = map_L;
+    g_app_params.ff_R = map_R;
+    __set_PRIMASK(primask);
+
+    App_Flash_Save();
+    printf("[FF] ident %s, saved\r\n", (ret == 0) ? "done" : "FAILED (stalled or no motion)");
+    App_Follow_FF_Print();
+}
+
+/**
+ * @brief 启动速度环前馈辨识
+ * @return 0 成功；-1 已在运行
+ * @note  车轮须离地：两个电机同时先正转后反转，各做一次 0 ~ 速度环限幅的 PWM 斜坡
+ */
+int32_t App_Follow_FF_Ident_Start(void)
+{
+    if (at_active) {
+        return -1;
+    }
+    return Motor_FF_Ident_Start(pid_speed_L.max_output, ENCODER_SAMPLE_HZ);
+}
+
+void App_Follow_FF_Ident_Stop(void)
+{
+    Motor_FF_Ident_Stop();
+}
+
+/**
+ * @brief 清除并保存前馈表
+ */
+void App_Follow_FF_Clear(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Motor_FF_Clear(&g_app_params.ff_L);
+    Motor_FF_Clear(&g_app_params.ff_R);
+    __set_PRIMASK(primask);
+
+    App_Flash_Save();
+}
+
+void App_Follow_FF_Print(void)
+{
+    Motor_FF_Print("L", &g_app_params.ff_L);
+    Motor_FF_Print("R", &g_app_params.ff_R);
+}
+
+static void App_Follow_AutoTune_Report(const char *name, const PID_AT_t *at)
+{
+    if (at->state == PID_AT_DONE) {
+        printf("[AT] %s Ku=%.1f Tu=%.1fms -> Kp=%.2f Ki=%.2f Kd=%.2f\r\n",
+               name, at->Ku, at->Tu * 1000.0f, at->Kp, at->Ki, at->Kd);
+    } else {
+        printf("[AT] %s FAILED (no stable oscillation)\r\n", name);
+    }
+}
+
+/**
+ * @brief 自整定结束 (延后处理任务中执行)：成功的一侧写入参数并保存到 Flash
+ */
+static void App_Follow_AutoTune_Done(void *arg)
+{
+    uint8_t ok_L = (at_L.state == PID_AT_DONE);
+    uint8_t ok_R = (at_R.state == PID_AT_DONE);
+
+    if (ok_L) {
+        g_app_params.speed_L_kp = at_L.Kp;
+        g_app_params.speed_L_ki = at_L.Ki;
+        g_app_params.speed_L_kd = at_L.Kd;
+    }
+    if (ok_R) {
+        g_app_params.speed_R_kp = at_R.Kp;
+        g_app_params.speed_R_ki = at_R.Ki;
+        g_app_params.speed_R_kd = at_R.Kd;
+    }
+    App_Follow_AutoTune_Report("L", &at_L);
+    App_Follow_AutoTune_Report("R", &at_R);
+
+    if (ok_L || ok_R) {
+        App_Follow_Update_PID_Params();
+        App_Flash_Save();
+        printf("[AT] %s gains saved\r\n", PID_AT_RuleName(at_L.rule));
+    }
+}
+
+/**
+ * @brief 启动速度环继电自整定
+ * @return 0 成功；-1 自整定或前馈辨识正在运行
+ * @note  车轮须离地：两个电机在 AT_SETPOINT_RPM 附近各自做继电振荡，
+ *        初始继电中心取前馈表在该转速的值 (未辨识时取继电幅值，由自整定逐步调整)
+ */
+int32_t App_Follow_AutoTune_Start(PID_AT_Rule_t rule)
+{
+    float bias_L, bias_R;
+
+    if (at_active || Motor_FF_Ident_Active()) {
+        return -1;
+    }
+
+    bias_L = Motor_FF_Eval(&g_app_params.ff_L, AT_SETPOINT_RPM);
+    bias_R = Motor_FF_Eval(&g_app_params.ff_R, AT_SETPOINT_RPM);
+    if (bias_L <= 0.0f) bias_L = AT_RELAY_PWM;
+    if (bias_R <= 0.0f) bias_R = AT_RELAY_PWM;
+
+    PID_AT_Init(&at_L, AT_SETPOINT_RPM, bias_L, AT_RELAY_PWM, AT_HYST_RPM,
+                0.0f, pid_speed_L.max_output, SAMPLE_TIME_S, AT_TIMEOUT_S, rule);
+    PID_AT_Init(&at_R, AT_SETPOINT_RPM, bias_R, AT_RELAY_PWM, AT_HYST_RPM,
+                0.0f, pid_speed_R.max_output, SAMPLE_TIME_S, AT_TIMEOUT_S, rule);
+    at_stop_req = 0;
+    at_active = 1;      // 最后置位：速度环中断从下一拍开始接管
+    return 0;
+}
+
+void App_Follow_AutoTune_Stop(void)
+{
+    at_stop_req = 1;
+}
+
+uint8_t App_Follow_AutoTune_Active(void)
+{
+    return at_active;
+}
+
+/**
+ * @brief 读取自整定实例 (显示用)
+ * @param ch 0 左电机，1 右电机
+ */
+const PID_AT_t *App_Follow_AutoTune_Get(uint8_t ch)
+{
+    return (ch == 0) ? &at_L : &at_R;
+}
+
+/**
+ * @brief 速度环 (TIM14 中断中调用，ENCODER_SAMPLE_HZ 频率)
+ * @note  包含：测速、手动/自动模式切换、丢包保护、内环速度控制；
+ *        外环由视觉数据帧驱动 (App_Follow_Vision_Loop)，这里只读取它给出的目标轮速
+ */
+void App_Follow_Speed_Loop(void)
+{
+    static Robot_Mode_t last_mode = MODE_MANUAL;
+    
+    /* 0. 测速：锁存编码器计数，按滑动窗口更新转速 */
+    Encoder_Sample(&motor1, &motor2);
+    Encoder_Compute_Speed(&motor1, &motor2);
+    
+    if (Ctrl_Decim_Step(&alive_decim)) { // 1s alive check
+        APP_TRACE(TR_LOOP_ALIVE, TRACE_I(g_robot_mode), TRACE_I(g_remote_cmd));   // 二进制 trace，由上位机解码
+    }
+    
+    /* 0.1 前馈辨识：电机由辨识斜坡接管，结果在任务中保存 */
+    if (Motor_FF_Ident_Active()) {
+        float ff_pwm_L, ff_pwm_R;
+        if (Motor_FF_Ident_Step(motor1.speed_rpm, motor2.speed_rpm, &ff_pwm_L, &ff_pwm_R) == MOTOR_FF_IDENT_DONE) {
+            OS_DeferPost(App_Follow_FF_Ident_Done, NULL);
+        }
+        TB6612_Motor_SetSpeed(&motorL, (int32_t)ff_pwm_L);
+        TB6612_Motor_SetSpeed(&motorR, (int32_t)ff_pwm_R);
+        
+        PID_Reset(&pid_speed_L);
+        PID_Reset(&pid_speed_R);
+        outer_reset_req = 1;
+        App_Follow_Reset_Loss_Counter();
+        return;
+    }
+
+    /* 0.2 自整定：左右电机各自继电振荡，都结束后在任务中写入参数 */
+    if (at_active) {
+        float at_pwm_L, at_pwm_R;
+        PID_AT_State_t st_L = PID_AT_Step(&at_L, motor1.speed_rpm, &at_pwm_L);
+        PID_AT_State_t st_R = PID_AT_Step(&at_R, motor2.speed_rpm, &at_pwm_R);
+        if (at_stop_req) {
+            at_L.state = PID_AT_IDLE;
+            at_R.state = PID_AT_IDLE;
+            at_pwm_L = 0.0f;
+            at_pwm_R = 0.0f;
+            at_active = 0;
+        } else if (st_L != PID_AT_RUNNING && st_R != PID_AT_RUNNING) {
+            at_active = 0;
+            OS_DeferPost(App_Follow_AutoTune_Done, NULL);
+        }
+        TB6612_Motor_SetSpeed(&motorL, (int32_t)at_pwm_L);
+        TB6612_Motor_SetSpeed(&motorR, (int32_t)at_pwm_R);
+        
+        PID_Reset(&pid_speed_L);
+        PID_Reset(&pid_speed_R);
+        outer_reset_req = 1;
+        App_Follow_Reset_Loss_Counter();
+        return;
+    }
+
+    /* 1. 全局急停检查 (优先级最高) */
+    /* 目前逻辑：只在手动模式收到 CMD_STOP 时停车 */
+    /* 如果自动模式下 g_remote_cmd 默认为 CMD_STOP，就会导致无法运行 */
+    if (g_robot_mode == MODE_MANUAL && g_remote_cmd == CMD_STOP) {
+        /* 停止电机 */
+        TB6612_Motor_SetSpeed(&motorL, 0);
+        TB6612_Motor_SetSpeed(&motorR, 0);
+        
+        /* 重置速度环防止积分饱和，外环在下一帧视觉数据时重置 */
+        PID_Reset(&pid_speed_L);
+        PID_Reset(&pid_speed_R);
+        outer_reset_req = 1;
+        
+        /* 丢包计时重新开始 */
+        App_Follow_Reset_Loss_Counter();
+        
+        /* 记录当前模式，防止恢复时误触发切换逻辑 */
+        last_mode = g_robot_mode;
+        return;
+    }
+
+    /* 2. 模式切换检测 */
+    if (g_robot_mode != last_mode) {
+        /* 切换模式时重置 PID 与目标轮速 */
+        PID_Reset(&pid_speed_L);
+        PID_Reset(&pid_speed_R);
+        outer_reset_req = 1;
+        target_speed_L = 0.0f;
+        target_speed_R = 0.0f;
+        
+        /* 丢包计时重新开始 */
+        App_Follow_Reset_Loss_Counter();
+        
+        last_mode = g_robot_mode;
+    }
+
+    /* 3. 分模式控制 */
+    if (g_robot_mode == MODE_MANUAL)
+    {
+        /* ---------------- 手动模式 ---------------- */
+        float pwm_L = 0.0f;
+        float pwm_R = 0.0f;
+        const float MANUAL_PWM = 1000.0f; // 手动模式直接 PWM (0~4200)
+
+        switch (g_remote_cmd) {
+            case CMD_FORWARD:
+                pwm_L = MANUAL_PWM;
+                pwm_R = MANUAL_PWM;
+                break;
+            case CMD_BACKWARD:
+                pwm_L = -MANUAL_PWM;
+                pwm_R = -MANUAL_PWM;
+                break;
+            case CMD_LEFT: // 原地左转
+                pwm_L = -MANUAL_PWM;
+                pwm_R = MANUAL_PWM;
+                break;
+            case CMD_RIGHT: // 原地右转
+                pwm_L = MANUAL_PWM;
+                pwm_R = -MANUAL_PWM;
+                break;
+            default:
+                pwm_L = 0.0f;
+                pwm_R = 0.0f;
+                break;
+        }
+        
+        TB6612_Motor_SetSpeed(&motorL, (int32_t)pwm_L);
+        TB6612_Motor_SetSpeed(&motorR, (int32_t)pwm_R);
+    }
+    else
+    {
+        /* ---------------- 自动模式 (OpenMV 跟随) ---------------- */
+        
+        /* 4.1 样本时效：距最近一帧视觉数据接收的毫秒数 */
+        uint32_t age_ms = App_Follow_Sample_Age_Ms();
+        
+        /* 4.2 取外环给出的目标轮速 (外环写入时关中断，两轮一致) */
+        float tgt_L = target_speed_L;
+        float tgt_R = target_speed_R;
+        
+        /* 4.3 丢包保护 */
+        if (age_ms >= LOSS_TIMEOUT_STOP_MS)
+        {
+            /* 急停，外环在重新收到数据时从头开始 */
+            tgt_L = 0.0f;
+            tgt_R = 0.0f;
+            outer_reset_req = 1;
+        }
+        else if (age_ms > LOSS_TIMEOUT_SLOW_MS)
+        {
+            /* 减速 */
+            tgt_L *= 0.5f;
+            tgt_R *= 0.5f;
+        }
+        
+        /* 4.4 内环：电机速度控制 (前馈查表 + PI 修正)
+         *     前馈交给控制器在限幅前相加，抗饱和按总 PWM 的饱和回退积分 */
+        PID_SetFeedforward(&pid_speed_L, Motor_FF_Eval(&g_app_params.ff_L, tgt_L));
+        PID_SetFeedforward(&pid_speed_R, Motor_FF_Eval(&g_app_params.ff_R, tgt_R));
+        float pwm_L = PID_Kernel_Run(&pid_speed_L, tgt_L, motor1.speed_rpm, SAMPLE_TIME_S);
+        float pwm_R = PID_Kernel_Run(&pid_speed_R, tgt_R, motor2.speed_rpm, SAMPLE_TIME_S);
+        
+        /* 4.5 执行输出 */
+        TB6612_Motor_SetSpeed(&motorL, (int32_t)pwm_L);
+        TB6612_Motor_SetSpeed(&motorR, (int32_t)pwm_R);
+
+        if (Ctrl_Decim_Step(&debug_decim)) { // 每500ms打印一次
+            /* 详细调试信息：目标/实际/PWM/误差/当前Kp/样本时效 (只记录原始数据，不在 MCU 上格式化浮点) */
+            APP_TRACE(TR_FOLLOW_AUTO_AGE,
+                      TRACE_F(tgt_L), TRACE_F(motor1.speed_rpm), TRACE_F(pwm_L),
+                      TRACE_F(tgt_L - motor1.speed_rpm),
+                      TRACE_F(pid_speed_L.Kp), TRACE_F(pid_speed_L.Ki),
+                      TRACE_U(age_ms));
+        }
+    }
+}
+
+/**
+ * @brief 外环增益调度：按调度变量插值增益并装入 PID (调度未启用时不改动)
+ * @param dist 本帧目标距离 (cm)
+ */
+static void App_Follow_Schedule(PID_Controller_t *pid, const Gain_Sched_Table_t *t,
+                                Gain_Sched_Out_t *out, float dist)
+{
+    float x;
+
+    if (!t->enable || !Gain_Sched_Valid(t)) {
+        return;
+    }
+    if (t->src == GAIN_SCHED_SRC_SPEED) {
+        x = 0.5f * fabsf(motor1.speed_rpm + motor2.speed_rpm);
+    } else {
+        x = dist;
+    }
+    Gain_Sched_Eval(t, x, out);
+    PID_SetGains(pid, out->kp, out->ki, out->kd);
+    PID_Kernel_Init(pid, VISION_DT_NOM);
+}
+
+/**
+ * @brief 读取增益调度最近一次查表结果
+ * @param loop FOLLOW_LOOP_DIST / FOLLOW_LOOP_ANGLE
+ */
+const Gain_Sched_Out_t *App_Follow_GS_Get(uint8_t loop)
+{
+    return &gs_out[(loop < FOLLOW_LOOP_COUNT) ? loop : 0];
+}
+
+static Gain_Sched_Table_t *App_Follow_GS_Table(uint8_t loop)
+{
+    return (loop == FOLLOW_LOOP_ANGLE) ? &g_app_params.gs_angle : &g_app_params.gs_dist;
+}
+
+/**
+ * @brief 启用/停用增益调度 (停用后恢复固定增益)
+ * @note  与调度时一样经 PID_SetGains 换算积分累积量，切换无扰；只改动该回路
+ */
+void App_Follow_GS_Enable(uint8_t loop, uint8_t en)
+{
+    App_Follow_GS_Table(loop)->enable = en ? 1 : 0;
+    if (!en) {
+        if (loop == FOLLOW_LOOP_ANGLE) {
+            PID_SetGains(&pid_angle, g_app_params.angle_kp, g_app_params.angle_ki, g_app_params.angle_kd);
+            PID_Kernel_Init(&pid_angle, VISION_DT_NOM);
+        } else {
+            PID_SetGains(&pid_dist, g_app_params.dist_kp, g_app_params.dist_ki, g_app_params.dist_kd);
+            PID_Kernel_Init(&pid_dist, VISION_DT_NOM);
+        }
+    }
+}
+
+/**
+ * @brief 设置调度变量与断点范围
+ * @return 0 成功；-1 参数无效
+ */
+int32_t App_Follow_GS_SetRange(uint8_t loop, uint8_t src, float x_min, float x_max)
+{
+    Gain_Sched_Table_t *t = App_Follow_GS_Table(loop);
+    int32_t ret = -1;
+
+    if (src >= GAIN_SCHED_SRC_COUNT) {
+        return -1;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (Gain_Sched_SetRange(t, x_min, x_max) == 0) {
+        t->src = src;
+        ret = 0;
+    }
+    __set_PRIMASK(primask);
+    return ret;
+}
+
+/**
+ * @brief 设置一个断点的增益
+ * @return 0 成功；-1 断点序号无效
+ */
+int32_t App_Follow_GS_SetPoint(uint8_t loop, uint8_t i, float kp, float ki, float kd)
+{
+    Gain_Sched_Table_t *t = App_Follow_GS_Table(loop);
+
+    if (i >= GAIN_SCHED_POINTS || kp < 0.0f || ki < 0.0f || kd < 0.0f) {
+        return -1;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    t->kp[i] = kp;
+    t->ki[i] = ki;
+    t->kd[i] = kd;
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+void App_Follow_GS_Print(void)
+{
+    Gain_Sched_Print("dist", &g_app_params.gs_dist);
+    Gain_Sched_Print("angle", &g_app_params.gs_angle);
+}
+
+/**
+ * @brief 更新视觉延迟测量和目标跟踪器 (每帧调用)
+ * @param now 本次计算时刻 (DWT)
+ * @note  总延迟 = 固定的相机处理延迟 + 传输抖动 + 最近一次测量的接收到本次计算的时间：
+ *        - 后者由帧的接收时间戳直接测得 (包含解析投递和任务调度的等待)
+ *        - 传输抖动只对 v2 可测：两边时钟不同步，但相邻帧 "接收间隔 - 相机时间戳间隔"
+ *          就是传输延迟的变化量，累加后减去其下界即得本帧比最快一帧多出的延迟
+ *        跟踪器先按相邻两帧的间隔预测再用本帧测量更新，v2 用相机时间戳间隔 (不受传输抖动影响)；
+ *        未找到目标的帧不更新跟踪器，估计停在最后一次测量，由调用者决定是否继续外推；
+ *        超过 VISION_DT_MAX 未找到目标则估计作废，下一次找到目标时重新初始化
+ */
+static void App_Follow_Latency_Update(const OpenMV_Data_t *d, uint32_t now)
+{
+    Follow_Latency_t *lat = &vision_lat;
+    const Track_1D_t *tx = &track[FOLLOW_LOOP_ANGLE];
+    uint32_t i;
+
+    /* 距上一次找到目标过久 (相机持续发 conf=0 帧或停发)：估计作废并锁存到再次找到目标。
+     * 按 OS tick 判定，不用 DWT 时间戳之差：DWT 约 25s 回绕，旧时间戳的差值会绕回到很小 */
+    if (lat_prev.valid &&
+        (uint32_t)(OS_GetTickCount() - lat_prev.rx_tick) * OS_TICK_MS >= (uint32_t)(VISION_DT_MAX * 1000.0f)) {
+        lat_prev.valid = 0;
+        for (i = 0; i < FOLLOW_LOOP_COUNT; i++) {
+            Track_Reset(&track[i]);
+        }
+    }
+
+    lat->age_ms = (float)(uint32_t)(now - d->rx_cyc) / (float)cyc_per_ms;
+
+    if (d->conf != 0) {
+        float rx_dt_ms = (float)(uint32_t)(d->rx_cyc - lat_prev.rx_cyc) / (float)cyc_per_ms;
+        float cam_dt_ms = rx_dt_ms;
+        float z[FOLLOW_LOOP_COUNT];
+
+        z[FOLLOW_LOOP_DIST]  = d->dist;
+        z[FOLLOW_LOOP_ANGLE] = d->x;
+
+        if (!lat_prev.valid || rx_dt_ms >= VISION_DT_MAX * 1000.0f) {
+            /* 第一帧或中断过久：重新开始估计 */
+            lat_prev.rel_delay = 0.0f;
+            lat_prev.min_delay = 0.0f;
+            lat->jitter_ms = 0.0f;
+            for (i = 0; i < FOLLOW_LOOP_COUNT; i++) {
+                Track_Reset(&track[i]);
+            }
+        } else if (d->ver >= 2) {
+            cam_dt_ms = (float)(uint16_t)(d->ts_ms - lat_prev.ts_ms);
+            lat_prev.rel_delay += rx_dt_ms - cam_dt_ms;
+            lat_prev.min_delay += VISION_LAT_MIN_LEAK_MS;
+            if (lat_prev.rel_delay < lat_prev.min_delay) {
+                lat_prev.min_delay = lat_prev.rel_delay;
+            }
+            lat->jitter_ms = lat_prev.rel_delay - lat_prev.min_delay;
+        }
+
+        /* 预测到本帧再更新 (重置后直接以本帧初始化)；野值由新息门限丢弃 */
+        for (i = 0; i < FOLLOW_LOOP_COUNT; i++) {
+            Track_Predict(&track[i], cam_dt_ms * 0.001f);
+            Track_Update(&track[i], z[i]);
+        }
+
+        lat_prev.valid   = 1;
+        lat_prev.ts_ms   = d->ts_ms;
+        lat_prev.rx_cyc  = d->rx_cyc;
+        lat_prev.rx_tick = OS_GetTickCount();
+    }
+
+    lat->total_ms = VISION_LAT_CAM_MS + lat->jitter_ms +
+                    (float)(uint32_t)(now - (lat_prev.valid ? lat_prev.rx_cyc : d->rx_cyc)) /
+                    (float)cyc_per_ms;
+    if (lat->total_ms > lat->total_max_ms) {
+        lat->total_max_ms = lat->total_ms;
+    }
+    lat->x_rate = tx->valid ? tx->v : 0.0f;
+    lat->x_comp = lat->x_rate * fminf(lat->total_ms, VISION_LAT_MAX_MS) * 0.001f;
+    if (lat->x_comp > FOLLOW_TARGET_X_CENTER)  lat->x_comp = FOLLOW_TARGET_X_CENTER;
+    if (lat->x_comp < -FOLLOW_TARGET_X_CENTER) lat->x_comp = -FOLLOW_TARGET_X_CENTER;
+}
+
+/**
+ * @brief 跟踪器给出的本次计算时刻的目标位置
+ * @param now 本次计算时刻 (DWT)
+ * @return 1 有效；0 尚未跟踪到目标或目标已丢失超过 TRACK_COAST_MS
+ * @note  距离外推到当前时刻；X 在 VISION_LAT_COMP 打开时再加上相机延迟的补偿量
+ */
+static uint8_t App_Follow_Track_Output(uint32_t now, float *x, float *dist)
+{
+    const Track_1D_t *tx = &track[FOLLOW_LOOP_ANGLE];
+    const Track_1D_t *td = &track[FOLLOW_LOOP_DIST];
+    float since_ms;
+
+    /* lat_prev 有效时距上一帧不到 VISION_DT_MAX (过期已在 App_Follow_Latency_Update 中锁存)，
+     * DWT 时间戳之差不会回绕 */
+    if (!lat_prev.valid || !tx->valid || !td->valid) {
+        return 0;
+    }
+    since_ms = (float)(uint32_t)(now - lat_prev.rx_cyc) / (float)cyc_per_ms;
+    if (since_ms > TRACK_COAST_MS) {
+        return 0;
+    }
+    *dist = Track_Predict_At(td, since_ms * 0.001f);
+    if (*dist < 0.0f) {
+        *dist = 0.0f;
+    }
+#if VISION_LAT_COMP
+    *x = tx->p + vision_lat.x_comp;
+#else
+    *x = Track_Predict_At(tx, since_ms * 0.001f);
+#endif
+    return 1;
+}
+
+/**
+ * @brief 读取视觉目标跟踪器
+ * @param loop Follow_Loop_t：距离环对应距离跟踪器，角度环对应 X 跟踪器
+ */
+const Track_1D_t *App_Follow_Track_Get(uint8_t loop)
+{
+    return &track[(loop < FOLLOW_LOOP_COUNT) ? loop : 0];
+}
+
+/**
+ * @brief 开关逐帧视觉数据记录 (TR_VISION_FRAME，供 tools/target_track_replay.c 回放)
+ */
+void App_Follow_Vision_Log(uint8_t on)
+{
+    vision_log = on;
+}
+
+/**
+ * @brief 读取视觉延迟测量结果
+ */
+const Follow_Latency_t *App_Follow_Latency_Get(void)
+{
+    return &vision_lat;
+}
+
+/**
+ * @brief 视觉外环 (每收到一帧 OpenMV 数据调用一次，任务上下文)
+ * @param data 解码后的一帧，rx_cyc 为接收时间戳；conf 为 0 表示未找到目标
+ * @note  每 VISION_DECIM 帧执行一次，PID 按相邻接收时间戳之差 dt 计算；
+ *        X 与距离先经跟踪器滤波 (丢弃野值)，角度环再按测得的总延迟补偿目标 X (VISION_LAT_COMP)；
+ *        输出经差速运动学解算为左右轮目标速度，交给速度环
+ */
+void App_Follow_Vision_Loop(const OpenMV_Data_t *data)
+{
+    float v_linear = 0.0f;
+    float v_angular = 0.0f;
+    float x, dist;
+    uint32_t now = DWT->CYCCNT;
+
+    /* 丢包计时从本帧的接收时刻开始；跟踪器每帧更新 (无论本帧是否被降采样) */
+    App_Follow_Loss_Restart(data->rx_cyc);
+    App_Follow_Latency_Update(data, now);
+    if (vision_log) {
+        APP_TRACE(TR_VISION_FRAME, TRACE_U(data->ver), TRACE_U(data->seq), TRACE_U(data->ts_ms),
+                  TRACE_U(data->x), TRACE_U(data->dist), TRACE_U(data->conf), TRACE_U(vision_lat.age_ms));
+    }
+
+    if (g_robot_mode != MODE_AUTO) {
+        return;
+    }
+
+    /* 速度环请求重置 (模式切换/急停/丢包)：下一次执行按重启处理 */
+    if (outer_reset_req) {
+        outer_reset_req = 0;
+        Ctrl_EventRate_Reset(&vision_rate);
+    }
+
+    /* 降采样并计算帧间隔 */
+    if (!Ctrl_EventRate_Step(&vision_rate, data->rx_cyc)) {
+        return;
+    }
+    if (vision_rate.restart) {
+        /* 重新开始：清理历史误差，防止看到目标时猛冲 */
+        PID_Reset(&pid_dist);
+        PID_Reset(&pid_angle);
+    }
+
+    /* 外环：视觉位置控制 (PD)，输入为跟踪器的估计 (目标短暂丢失时按预测继续) */
+    if (!App_Follow_Track_Output(now, &x, &dist))
+    {
+        /* 目标完全丢失，立刻原地立正，不要乱转！ */
+        PID_Reset(&pid_angle);
+        PID_Reset(&pid_dist);
+    }
+    else
+    {
+        /* 增益调度 (近距离缓慢跟随、远距离快速追赶) */
+        App_Follow_Schedule(&pid_dist, &g_app_params.gs_dist, &gs_out[FOLLOW_LOOP_DIST], dist);
+        App_Follow_Schedule(&pid_angle, &g_app_params.gs_angle, &gs_out[FOLLOW_LOOP_ANGLE], dist);
+
+        /* 计算距离误差 -> 线速度 (距离大于目标时前进，故取反) */
+        v_linear = -PID_Kernel_Run(&pid_dist, FOLLOW_TARGET_DIST, dist, vision_rate.dt);
+        /* 计算角度误差 -> 角速度 (X 已外推到当前时刻，抵消相机到执行器的延迟) */
+        v_angular = PID_Kernel_Run(&pid_angle, FOLLOW_TARGET_X_CENTER, x, vision_rate.dt);
+    }
+
+    /* 运动学解算 (差速模型)，两轮目标一起更新，避免速度环读到一新一旧 */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    target_speed_L = v_linear - v_angular;
+    target_speed_R = v_linear + v_angular;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 丢包计时从当前时刻重新开始
+ * @note  模式切换、急停等场合调用，给相机 LOSS_TIMEOUT_SLOW_MS 的时间送来新帧；
+ *        视觉外环按帧的接收时间戳重新计时，不经过这里
+ */
+void App_Follow_Reset_Loss_Counter(void)
+{
+    App_Follow_Loss_Restart(DWT->CYCCNT);
+}
+
+/**
+ * @brief 测量各 PID 后端单次计算的周期数
+ * @note  浮点实现走完整的 PID_Compute / PID_Update；arm_pid_xxx 只计内核本身，
+ *        定点的格式转换另计在 PID_Kernel_Run (当前编译的后端) 中；
+ *        最后对比四个跟随回路逐个 PID_Compute 与 PID_Bank 一次更新 (参数取当前值，不含微分滤波)
+ */
+void PID_Bench(void)
+{
+    PID_Controller_t pid;
+    arm_pid_instance_f32 s_f32;
+    arm_pid_instance_q31 s_q31;
+    arm_pid_instance_q15 s_q15;
+    volatile float    in_f = 12.5f;     // volatile：防止编译器把计算提前
+    volatile q31_t    in_q31 = 0x01000000;
+    volatile q15_t    in_q15 = 0x0100;
+    volatile float    sink_f;
+    volatile q31_t    sink_q31;
+    volatile q15_t    sink_q15;
+    static PID_Controller_t loops[PID_BANK_MAX];    // 静态：主栈只有 1KB
+    static PID_Bank_t bank;
+    float tgt[PID_BANK_MAX] = { FOLLOW_TARGET_DIST, FOLLOW_TARGET_X_CENTER, 100.0f, 100.0f };
+    float act[PID_BANK_MAX] = { 25.0f, 70.0f, 90.0f, 95.0f };
+    uint32_t t0, dt;
+    uint32_t best[8] = { 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU,
+                         0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU };
+    uint32_t i;
+
+    PID_Init(&pid, 5.0f, 2.5f, 0.1f, 4200.0f, 2000.0f);
+    PID_Kernel_Init(&pid, SAMPLE_TIME_S);
+    s_f32.Kp = 5.0f;  s_f32.Ki = 0.05f;  s_f32.Kd = 5.0f;
+    s_q31.Kp = 0x02000000; s_q31.Ki = 0x00100000; s_q31.Kd = 0x01000000;
+    s_q15.Kp = 0x0200; s_q15.Ki = 0x0010; s_q15.Kd = 0x0100;
+    arm_pid_init_f32(&s_f32, 1);
+    arm_pid_init_q31(&s_q31, 1);
+    arm_pid_init_q15(&s_q15, 1);
+
+    loops[0] = pid_dist;
+    loops[1] = pid_angle;
+    loops[2] = pid_speed_L;
+    loops[3] = pid_speed_R;
+    PID_Bank_Init(&bank, PID_BANK_MAX);
+    for (i = 0; i < PID_BANK_MAX; i++) {
+        PID_SetDFilter(&loops[i], 0.0f);
+        PID_Reset(&loops[i]);
+        PID_Bank_Load(&bank, (uint8_t)i, &loops[i]);
+    }
+
+    for (i = 0; i < 16; i++) {
+        t0 = DWT->CYCCNT; sink_f = PID_Compute(&pid, in_f, 0.0f);                    dt = DWT->CYCCNT - t0; if (dt < best[0]) best[0] = dt;
+        t0 = DWT->CYCCNT; sink_f = PID_Update(&pid, in_f, 0.0f, SAMPLE_TIME_S);      dt = DWT->CYCCNT - t0; if (dt < best[1]) best[1] = dt;
+        t0 = DWT->CYCCNT; sink_f = PID_Kernel_Run(&pid, in_f, 0.0f, SAMPLE_TIME_S);  dt = DWT->CYCCNT - t0; if (dt < best[2]) best[2] = dt;
+        t0 = DWT->CYCCNT; sink_f = arm_pid_f32(&s_f32, in_f);                        dt = DWT->CYCCNT - t0; if (dt < best[3]) best[3] = dt;
+        t0 = DWT->CYCCNT; sink_q31 = arm_pid_q31(&s_q31, in_q31);                    dt = DWT->CYCCNT - t0; if (dt < best[4]) best[4] = dt;
+        t0 = DWT->CYCCNT; sink_q15 = arm_pid_q15(&s_q15, in_q15);                    dt = DWT->CYCCNT - t0; if (dt < best[5]) best[5] = dt;
+
+        t0 = DWT->CYCCNT;
+        PID_Compute(&loops[0], tgt[0], act[0]);
+        PID_Compute(&loops[1], tgt[1], act[1]);
+        PID_Compute(&loops[2], tgt[2], act[2]);
+        PID_Compute(&loops[3], tgt[3], act[3]);
+        dt = DWT->CYCCNT - t0; if (dt < best[6]) best[6] = dt;
+        t0 = DWT->CYCCNT; PID_Bank_Update(&bank, tgt, act, PID_REF_DT);              dt = DWT->CYCCNT - t0; if (dt < best[7]) best[7] = dt;
+    }
+    (void)sink_f; (void)sink_q31; (void)sink_q15;
+
+    printf("[PID] cycles, min of 16 runs (incl. DWT read)\r\n");
+    printf("[PID] PID_Compute    %4lu\r\n", (unsigned long)best[0]);
+    printf("[PID] PID_Update     %4lu\r\n", (unsigned long)best[1]);
+    printf("[PID] Kernel_Run(%u)  %4lu\r\n", (unsigned)PID_CFG_BACKEND, (unsigned long)best[2]);
+    printf("[PID] arm_pid_f32    %4lu\r\n", (unsigned long)best[3]);
+    printf("[PID] arm_pid_q31    %4lu\r\n", (unsigned long)best[4]);
+    printf("[PID] arm_pid_q15    %4lu\r\n", (unsigned long)best[5]);
+    printf("[PID] 4x PID_Compute %4lu\r\n", (unsigned long)best[6]);
+    printf("[PID] PID_Bank (4)   %4lu\r\n", (unsigned long)best[7]);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file    app_follow.h
+ * @brief   视觉跟随控制接口：视觉外环 (距离/角度) + 电机速度环
+ * @note    依赖 OpenMV 数据格式等 BSP 定义，放在应用层；Core/Algo 下的 pid.h 只保留算法本身
+ * @date    2026-02-19
+ */
+
+#ifndef __APP_FOLLOW_H
+#define __APP_FOLLOW_H
+
+#include <stdint.h>
+#include "pid.h"
+#include "pid_autotune.h"
+#include "gain_sched.h"
+#include "target_track.h"
+#include "Bsp_OpenMV_Proto.h"
+
+/* 跟随回路 (Follow Loop) */
+typedef enum {
+    FOLLOW_LOOP_DIST = 0,   // 距离环
+    FOLLOW_LOOP_ANGLE,      // 角度环
+    FOLLOW_LOOP_COUNT
+} Follow_Loop_t;
+
+/* 视觉延迟测量 (每帧更新，显示/调试用) */
+typedef struct {
+    float age_ms;           // 接收到外环计算的时效 (ms)
+    float jitter_ms;        // 传输延迟比最快一帧多出的部分 (ms，仅 v2 可测)
+    float total_ms;         // 曝光到外环计算的总延迟估计 (ms)
+    float total_max_ms;     // total_ms 最大值
+    float x_rate;           // 目标 X 速度 (像素/s，跟踪器估计)
+    float x_comp;           // 角度环 X 补偿量 (像素)
+} Follow_Latency_t;
+
+void App_Follow_Init(void);
+void App_Follow_Speed_Loop(void);                        // 速度环 (TIM14 中断)
+void App_Follow_Vision_Loop(const OpenMV_Data_t *data);  // 视觉外环 (每帧 OpenMV 数据)
+void App_Follow_Reset_Loss_Counter(void);                // 丢包计时从当前时刻重新开始
+const Follow_Latency_t *App_Follow_Latency_Get(void);    // 视觉延迟测量结果
+const Track_1D_t *App_Follow_Track_Get(uint8_t loop);    // 视觉目标跟踪器 (Follow_Loop_t：距离 / X)
+void App_Follow_Vision_Log(uint8_t on);                  // 开关逐帧视觉数据记录 (TR_VISION_FRAME)
+void App_Follow_Update_PID_Params(void);
+int32_t App_Follow_FF_Ident_Start(void);                 // 启动速度环前馈辨识 (车轮需离地)，结束后自动保存
+void App_Follow_FF_Ident_Stop(void);                     // 中止前馈辨识
+void App_Follow_FF_Clear(void);                          // 清除并保存前馈表 (前馈为 0)
+void App_Follow_FF_Print(void);                          // 打印前馈表
+int32_t App_Follow_AutoTune_Start(PID_AT_Rule_t rule);   // 启动速度环继电自整定 (车轮需离地)，成功后自动写入并保存
+void App_Follow_AutoTune_Stop(void);                     // 中止自整定 (参数不变)
+uint8_t App_Follow_AutoTune_Active(void);                // 自整定是否在运行
+const PID_AT_t *App_Follow_AutoTune_Get(uint8_t ch);     // 读取自整定实例 (0 左，1 右)
+const Gain_Sched_Out_t *App_Follow_GS_Get(uint8_t loop); // 外环增益调度最近一次查表结果 (Follow_Loop_t)
+void App_Follow_GS_Enable(uint8_t loop, uint8_t en);     // 启用/停用增益调度 (不保存)
+int32_t App_Follow_GS_SetRange(uint8_t loop, uint8_t src, float x_min, float x_max); // 设置调度变量与断点范围 (不保存)
+int32_t App_Follow_GS_SetPoint(uint8_t loop, uint8_t i, float kp, float ki, float kd); // 设置断点增益 (不保存)
+void App_Follow_GS_Print(void);                          // 打印增益调度表
+
+/**
+ * @brief 测量各 PID 后端单次计算的周期数，结果打印到 USART1 (Benchmark Backends)
+ * @note  需已调用 delay_init 使能 DWT；最后一项用当前的跟随回路参数对比 PID_Bank
+ */
+void PID_Bench(void);
+
+#endif /* __APP_FOLLOW_H */
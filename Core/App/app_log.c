@@ -0,0 +1,271 @@
+/**
+ * @file    app_log.c
+ * @brief   无锁日志环形缓冲区实现
+ * @note    固定槽位的多生产者 / 单消费者队列 (按 Vyukov 有界队列的序号法)：
+ *          - 生产者 (任务或中断) 用 LDREX/STREX 抢占写位置，格式化到自己的
+ *            槽中，写完后更新槽序号发布；槽满则丢弃并计数，不会等待
+ *          - 单个低优先级任务按序取出已发布的槽，拼成一块后用 USART1 DMA
+ *            发送，发送完成中断再唤醒它继续
+ *          单核上 STREX 失败只可能是被更高优先级的生产者打断，而打断者
+ *          会完整写完自己那一条，所以重试次数有界
+ *          printf 经 App_Log_Putc 按行缓冲后同样写入环形缓冲区；任务是协同式
+ *          调度的，线程模式下的调用者可以临时充当输出方直接推动 DMA
+ * @date    2026-02-19
+ */
+
+#include "app_log.h"
+#include "usart.h"
+#include "os.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_SLOT_MASK   (LOG_SLOT_COUNT - 1U)
+
+#define LOG_EVT_DATA    0x01U   // 有新日志
+#define LOG_EVT_TXDONE  0x02U   // DMA 发送完成
+
+/* 日志槽
+ * seq 存的是 "序号 - 槽下标"，这样全零的初始状态就是合法的空队列，
+ * 在 App_Log_Init 之前 (甚至 main 之前) 写日志也不会出错 */
+typedef struct {
+    volatile uint32_t seq;
+    uint16_t          len;
+    char              text[LOG_SLOT_SIZE];
+} Log_Slot_t;
+
+/* 私有变量 */
+static Log_Slot_t        log_slots[LOG_SLOT_COUNT];
+static volatile uint32_t log_enq_pos;       // 生产者共享的写位置
+static uint32_t          log_deq_pos;       // 仅输出任务使用
+static volatile uint32_t log_dropped;
+static uint8_t           log_tx_buf[LOG_TX_BUF_SIZE];
+static OS_Event_t        log_event = { 0, OS_INVALID_TASK };
+
+/* printf 行缓冲：[0] 线程模式，[1] 中断 (外设中断同为最高优先级，不会互相嵌套) */
+static char              log_line[2][LOG_SLOT_SIZE];
+static uint16_t          log_line_len[2];
+
+static void App_Log_Task(void *arg);
+static void App_Log_Flush(void);
+
+/**
+ * @brief 原子加一 (LDREX/STREX)
+ */
+static void Log_AtomicInc(volatile uint32_t *p)
+{
+    uint32_t v;
+    do {
+        v = __LDREXW(p);
+    } while (__STREXW(v + 1U, p) != 0U);
+}
+
+/**
+ * @brief 预留一个空槽
+ * @param pos 输出预留到的序号
+ * @return 槽指针；缓冲区满返回 NULL (由调用者决定是否计入丢弃)
+ */
+static Log_Slot_t *Log_Reserve(uint32_t *pos)
+{
+    for (;;) {
+        uint32_t    p   = __LDREXW(&log_enq_pos);
+        Log_Slot_t *s   = &log_slots[p & LOG_SLOT_MASK];
+        int32_t     dif = (int32_t)(s->seq + (p & LOG_SLOT_MASK) - p);
+
+        if (dif == 0) {
+            /* 槽空闲：抢占写位置，失败说明被打断，重试 */
+            if (__STREXW(p + 1U, &log_enq_pos) == 0U) {
+                *pos = p;
+                return s;
+            }
+        } else if (dif < 0) {
+            /* 槽还没被输出任务取走：缓冲区满 */
+            __CLREX();
+            return NULL;
+        } else {
+            /* 其他生产者已推进写位置，重新读取 */
+            __CLREX();
+        }
+    }
+}
+
+/**
+ * @brief 发布已写好的槽
+ */
+static void Log_Publish(Log_Slot_t *s, uint32_t pos)
+{
+    __DMB();                                            // 先写完内容再发布
+    s->seq = pos + 1U - (pos & LOG_SLOT_MASK);
+    OS_EventSet(&log_event, LOG_EVT_DATA);
+}
+
+/**
+ * @brief 日志模块初始化
+ */
+void App_Log_Init(uint8_t priority)
+{
+    OS_SetTaskName(OS_CreateTask(App_Log_Task, NULL, priority), "Log");
+}
+
+int32_t App_Log(const char *fmt, ...)
+{
+    uint32_t pos;
+    Log_Slot_t *s = Log_Reserve(&pos);
+    if (s == NULL) {
+        Log_AtomicInc(&log_dropped);
+        return -1;
+    }
+
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s->text, LOG_SLOT_SIZE, fmt, ap);
+    va_end(ap);
+
+    if (n < 0) n = 0;
+    if (n >= LOG_SLOT_SIZE) n = LOG_SLOT_SIZE - 1;     // 截断
+    s->len = (uint16_t)n;
+
+    Log_Publish(s, pos);
+    return 0;
+}
+
+/**
+ * @brief 写入一段原始数据，缓冲区满时不计入丢弃
+ */
+static int32_t Log_WriteRaw(const char *data, uint16_t len)
+{
+    uint32_t pos;
+    Log_Slot_t *s = Log_Reserve(&pos);
+    if (s == NULL) return -1;
+
+    if (len > LOG_SLOT_SIZE) len = LOG_SLOT_SIZE;
+    memcpy(s->text, data, len);
+    s->len = len;
+
+    Log_Publish(s, pos);
+    return 0;
+}
+
+int32_t App_Log_Write(const char *data, uint16_t len)
+{
+    if (Log_WriteRaw(data, len) != 0) {
+        Log_AtomicInc(&log_dropped);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 故障异常中的轮询输出：停掉 DMA 请求，直接写数据寄存器
+ */
+static void Log_PutcPolled(int ch)
+{
+    CLEAR_BIT(huart1.Instance->CR3, USART_CR3_DMAT);
+    while ((huart1.Instance->SR & USART_SR_TXE) == 0U) {
+    }
+    huart1.Instance->DR = (uint8_t)ch;
+    while ((huart1.Instance->SR & USART_SR_TC) == 0U) {
+    }
+}
+
+/**
+ * @brief 把一行 printf 输出写入环形缓冲区
+ * @note  线程模式且未关中断时，缓冲区满就自己推动 DMA 并等待空位，保证不丢；
+ *        随后顺带启动一次发送，调度器启动前 (启动打印) 也能及时输出
+ */
+static void Log_LineFlush(uint32_t ctx)
+{
+    uint8_t canWait = (ctx == 0U && __get_PRIMASK() == 0U);
+
+    while (Log_WriteRaw(log_line[ctx], log_line_len[ctx]) != 0) {
+        if (!canWait) {
+            Log_AtomicInc(&log_dropped);
+            break;
+        }
+        App_Log_Flush();
+    }
+    log_line_len[ctx] = 0;
+
+    if (canWait) {
+        App_Log_Flush();
+    }
+}
+
+void App_Log_Putc(int ch)
+{
+    uint32_t ipsr = __get_IPSR();
+
+    /* NMI / HardFault / MemManage / BusFault / UsageFault：调度器和 DMA 都不可信 */
+    if (ipsr >= 2U && ipsr <= 6U) {
+        Log_PutcPolled(ch);
+        return;
+    }
+
+    uint32_t ctx = (ipsr != 0U) ? 1U : 0U;
+    log_line[ctx][log_line_len[ctx]++] = (char)ch;
+    if (ch == '\n' || log_line_len[ctx] >= LOG_SLOT_SIZE) {
+        Log_LineFlush(ctx);
+    }
+}
+
+uint32_t App_Log_GetDropped(void)
+{
+    return log_dropped;
+}
+
+/**
+ * @brief 把已发布的日志拼到发送缓冲区并启动 DMA (串口忙时直接返回)
+ * @note  只能在线程模式调用：协同式调度下同一时刻只有一个调用者
+ */
+static void App_Log_Flush(void)
+{
+    uint16_t n = 0;
+
+    if (huart1.gState != HAL_UART_STATE_READY) {
+        return;     // 上一块还在发送，完成中断会再次唤醒
+    }
+
+    for (;;) {
+        Log_Slot_t *s = &log_slots[log_deq_pos & LOG_SLOT_MASK];
+        if (s->seq + (log_deq_pos & LOG_SLOT_MASK) != log_deq_pos + 1U) {
+            break;  // 下一条尚未发布 (或队列已空)
+        }
+        __DMB();
+        if (n + s->len > LOG_TX_BUF_SIZE) {
+            break;  // 留到下一块
+        }
+
+        memcpy(&log_tx_buf[n], s->text, s->len);
+        n += s->len;
+
+        __DMB();    // 读完内容再归还槽
+        s->seq = log_deq_pos + LOG_SLOT_COUNT - (log_deq_pos & LOG_SLOT_MASK);
+        log_deq_pos++;
+    }
+
+    if (n > 0) {
+        HAL_UART_Transmit_DMA(&huart1, log_tx_buf, n);
+    }
+}
+
+/**
+ * @brief 日志输出任务：等待新日志或发送完成事件
+ */
+static void App_Log_Task(void *arg)
+{
+    while (OS_EventWait(&log_event, LOG_EVT_DATA | LOG_EVT_TXDONE,
+                        OS_WAIT_FOREVER, NULL) == OS_OK) {
+        App_Log_Flush();
+    }
+}
+
+/**
+ * @brief HAL 库 UART 发送完成回调
+ * @note  ISR 上下文，只唤醒输出任务
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART1) {
+        OS_EventSet(&log_event, LOG_EVT_TXDONE);
+    }
+}
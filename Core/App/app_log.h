@@ -0,0 +1,51 @@
+/**
+ * @file    app_log.h
+ * @brief   无锁日志环形缓冲区 (多生产者，USART1 DMA 输出)
+ * @date    2026-02-19
+ */
+
+#ifndef __APP_LOG_H
+#define __APP_LOG_H
+
+#include "main.h"
+#include <stdint.h>
+
+/* 配置项 */
+#define LOG_SLOT_COUNT   32     // 日志槽数量 (必须为 2 的幂)
+#define LOG_SLOT_SIZE    64     // 单条日志最大长度 (含结尾，超长截断)
+#define LOG_TX_BUF_SIZE  256    // 单次 DMA 发送的最大字节数
+
+/* 函数声明 */
+
+/**
+ * @brief 日志模块初始化 (创建输出任务，需在 OS_Init 之后调用)
+ * @param priority 输出任务优先级 (建议最低)
+ */
+void App_Log_Init(uint8_t priority);
+
+/**
+ * @brief 格式化写入一条日志 (任务和中断中均可调用)
+ * @return 0 成功；-1 缓冲区满，该条被丢弃并计数
+ * @note  只格式化到预留的槽中，不等待串口，耗时与 LOG_SLOT_SIZE 成正比
+ */
+int32_t App_Log(const char *fmt, ...);
+
+/**
+ * @brief 写入一段原始数据 (超过 LOG_SLOT_SIZE 部分截断)
+ * @return 0 成功；-1 缓冲区满
+ */
+int32_t App_Log_Write(const char *data, uint16_t len);
+
+/**
+ * @brief printf 重定向的输出函数 (由 usart.c 中的 fputc 调用)
+ * @note  按行缓冲，遇到换行或满 LOG_SLOT_SIZE 字节时写入环形缓冲区，经 DMA 发送；
+ *        故障异常 (HardFault 等) 中改为轮询方式直接发送
+ */
+void App_Log_Putc(int ch);
+
+/**
+ * @brief 获取因缓冲区满而丢弃的日志条数
+ */
+uint32_t App_Log_GetDropped(void);
+
+#endif /* __APP_LOG_H */
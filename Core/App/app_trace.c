@@ -0,0 +1,105 @@
+/**
+ * @file    app_trace.c
+ * @brief   二进制延迟格式化 trace 实现
+ * @note    帧写入 app_log 的无锁环形缓冲区，与文本日志按序交错输出；
+ *          单帧最长 TRACE_FRAME_LEN(TRACE_MAX_ARGS) 字节，不会被截断
+ * @date    2026-02-19
+ */
+
+#include "app_trace.h"
+#include "app_log.h"
+#include "usart.h"
+#include "os.h"
+#include <stdio.h>
+
+#define TRACE_BENCH_RUNS    4
+
+/**
+ * @brief 按小端写入 32 位数并累加校验和
+ */
+static uint8_t *Trace_Put32(uint8_t *p, uint32_t v, uint8_t *sum)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    *sum += p[0] + p[1] + p[2] + p[3];
+    return p + 4;
+}
+
+int32_t App_Trace(uint16_t id, uint8_t argc, const uint32_t *argv)
+{
+    uint8_t  frame[TRACE_FRAME_LEN(TRACE_MAX_ARGS)];
+    uint8_t *p   = frame;
+    uint8_t  sum = 0;
+    uint8_t  i;
+
+    if (id >= TR_FMT_COUNT || argc > TRACE_MAX_ARGS) {
+        return -1;
+    }
+
+    *p++ = TRACE_SYNC;
+    *p++ = (uint8_t)id;
+    *p++ = (uint8_t)(id >> 8);
+    *p++ = argc;
+    sum  = (uint8_t)(frame[1] + frame[2] + argc);
+
+    p = Trace_Put32(p, OS_CYCLE_COUNT(), &sum);
+    for (i = 0; i < argc; i++) {
+        p = Trace_Put32(p, argv[i], &sum);
+    }
+    *p++ = sum;
+
+    return App_Log_Write((const char *)frame, (uint16_t)(p - frame));
+}
+
+/**
+ * @brief 测量一条 4 参数消息在三种路径下的耗时 (取最小/最大值)
+ * @note  printf 还要阻塞等串口发完，其额外耗时按字节数和波特率折算
+ */
+void App_Trace_Bench(void)
+{
+    char     text[LOG_SLOT_SIZE];
+    uint32_t tr_min = 0xFFFFFFFFU, tr_max = 0;
+    uint32_t lg_min = 0xFFFFFFFFU, lg_max = 0;
+    uint32_t sn_min = 0xFFFFFFFFU, sn_max = 0;
+    uint32_t t0, dt;
+    int      len = 0;
+    uint32_t i;
+
+    volatile int32_t  a = -42;          // volatile：防止编译器预先算好参数
+    volatile uint32_t b = 1234U;
+    volatile float    c = 3.14159f;
+    volatile float    d = -0.5f;
+
+    for (i = 0; i < TRACE_BENCH_RUNS; i++) {
+        t0 = OS_CYCLE_COUNT();
+        APP_TRACE(TR_BENCH, TRACE_I(a), TRACE_U(b), TRACE_F(c), TRACE_F(d));
+        dt = OS_CYCLE_COUNT() - t0;
+        if (dt < tr_min) tr_min = dt;
+        if (dt > tr_max) tr_max = dt;
+
+        t0 = OS_CYCLE_COUNT();
+        App_Log("Bench: a=%d b=%u c=%.2f d=%.2f\r\n", (int)a, (unsigned)b, c, d);
+        dt = OS_CYCLE_COUNT() - t0;
+        if (dt < lg_min) lg_min = dt;
+        if (dt > lg_max) lg_max = dt;
+
+        t0 = OS_CYCLE_COUNT();
+        len = snprintf(text, sizeof(text), "Bench: a=%d b=%u c=%.2f d=%.2f\r\n", (int)a, (unsigned)b, c, d);
+        dt = OS_CYCLE_COUNT() - t0;
+        if (dt < sn_min) sn_min = dt;
+        if (dt > sn_max) sn_max = dt;
+    }
+
+    /* 8N1：每字节 10 bit */
+    uint32_t uart_cycles = (uint32_t)((uint64_t)len * 10U * SystemCoreClock / huart1.Init.BaudRate);
+
+    printf("[TRACE] path      cycles(min/max)   bytes\r\n");
+    printf("[TRACE] trace     %6lu/%-6lu      %3u\r\n",
+           (unsigned long)tr_min, (unsigned long)tr_max, (unsigned)TRACE_FRAME_LEN(4));
+    printf("[TRACE] log text  %6lu/%-6lu      %3d\r\n",
+           (unsigned long)lg_min, (unsigned long)lg_max, len);
+    printf("[TRACE] snprintf  %6lu/%-6lu      %3d  (+%lu cycles blocking on UART)\r\n",
+           (unsigned long)sn_min, (unsigned long)sn_max, len, (unsigned long)uart_cycles);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file    app_trace.h
+ * @brief   二进制延迟格式化 trace (格式 ID + DWT 时间戳 + 原始参数)
+ * @note    记录时不做任何格式化，只把 ID 和参数拷进日志环形缓冲区，
+ *          由上位机 tools/trace_decode 按 app_trace_fmt.h 还原成文本。
+ *          帧格式 (小端)：
+ *            0xA5 | id(2) | argc(1) | 时间戳 DWT->CYCCNT(4) | 参数(4*argc) | sum(1)
+ *          sum 为 id 起到参数结束所有字节之和的低 8 位。帧与普通文本日志
+ *          共用 USART1，解码工具把校验不通过的字节原样当作文本输出。
+ * @date    2026-02-19
+ */
+
+#ifndef __APP_TRACE_H
+#define __APP_TRACE_H
+
+#include "main.h"
+#include "app_trace_fmt.h"
+#include <stdint.h>
+
+/* 配置项 */
+#define TRACE_MAX_ARGS      8       // 单帧最多参数个数 (帧长需 <= LOG_SLOT_SIZE)
+
+#define TRACE_SYNC          0xA5U
+#define TRACE_FRAME_LEN(n)  (9U + 4U * (n))
+
+/* 格式 ID (由 app_trace_fmt.h 生成) */
+#define TRACE_FMT_ENUM(id, fmt) id,
+typedef enum {
+    TRACE_FMT_TABLE(TRACE_FMT_ENUM)
+    TR_FMT_COUNT
+} Trace_Id_t;
+#undef TRACE_FMT_ENUM
+
+/* 参数转换 */
+#define TRACE_I(x)  ((uint32_t)(int32_t)(x))
+#define TRACE_U(x)  ((uint32_t)(x))
+
+__STATIC_INLINE uint32_t TRACE_F(float f)
+{
+    union { float f; uint32_t u; } c;
+    c.f = f;
+    return c.u;
+}
+
+/**
+ * @brief 记录一条 trace (参数须已用 TRACE_I/TRACE_U/TRACE_F 转换)
+ * @example APP_TRACE(TR_LOOP_ALIVE, TRACE_I(mode), TRACE_I(cmd));
+ */
+#define APP_TRACE(id, ...) \
+    do { \
+        const uint32_t tr_args_[] = { __VA_ARGS__ }; \
+        App_Trace((uint16_t)(id), (uint8_t)(sizeof(tr_args_) / sizeof(tr_args_[0])), tr_args_); \
+    } while (0)
+
+#define APP_TRACE0(id)  App_Trace((uint16_t)(id), 0, NULL)
+
+/* 函数声明 */
+
+/**
+ * @brief 组帧并写入日志环形缓冲区 (任务和中断中均可调用)
+ * @return 0 成功；-1 参数错误或缓冲区满
+ */
+int32_t App_Trace(uint16_t id, uint8_t argc, const uint32_t *argv);
+
+/**
+ * @brief 对比 App_Trace 与 snprintf 文本格式化的耗时和字节数，结果打印到 USART1
+ * @note  需已调用 delay_init 使能 DWT
+ */
+void App_Trace_Bench(void);
+
+#endif /* __APP_TRACE_H */
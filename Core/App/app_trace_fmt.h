@@ -0,0 +1,23 @@
+/**
+ * @file    app_trace_fmt.h
+ * @brief   二进制 trace 的格式串表 (固件与上位机解码工具共用)
+ * @note    固件只用表生成的 ID 枚举，格式串不会编进 Flash；
+ *          tools/trace_decode.c 包含同一个文件，按 ID 还原成文本。
+ *          - 只能在表尾追加新条目，改动顺序会让旧日志解码错位
+ *          - 每个参数按 32 位传递：%d/%i/%c 有符号，%u/%x/%X/%o 无符号，
+ *            %f/%e/%g 需用 TRACE_F() 传入 float 的位模式；不支持 %s
+ *          - 本文件只能包含宏，不要引入任何固件头文件
+ */
+
+#ifndef __APP_TRACE_FMT_H
+#define __APP_TRACE_FMT_H
+
+/* X(ID, 格式串) */
+#define TRACE_FMT_TABLE(X) \
+    X(TR_LOOP_ALIVE,   "Loop Alive. Mode=%d, Cmd=%d\r\n") \
+    X(TR_FOLLOW_AUTO,  "AUTO: Tgt=%.1f Act=%.1f PWM=%.0f Err=%.1f Kp=%.2f Ki=%.2f | Loss=%u\r\n") \
+    X(TR_BENCH,        "Bench: a=%d b=%u c=%.2f d=%.2f\r\n") \
+    X(TR_VISION_FRAME, "VIS: v%u seq=%u ts=%u x=%u dist=%u conf=%u age=%u\r\n") \
+    X(TR_FOLLOW_AUTO_AGE, "AUTO: Tgt=%.1f Act=%.1f PWM=%.0f Err=%.1f Kp=%.2f Ki=%.2f | Age=%ums\r\n")
+
+#endif /* __APP_TRACE_FMT_H */
@@ -7,7 +7,8 @@
 #include "app_ui.h"
 #include "app_comm.h"
 #include "../Bsp/Bsp_Flash.h"
-#include "../Algo/pid.h"
+#include "app_follow.h"
+#include "os.h"
 #include <stdio.h>
 
 /* 外部变量引用 */
@@ -19,15 +20,20 @@ extern nmea_msg gps_data;
 static UI_State_t g_ui_state = {PAGE_MAIN, 0, 0, 0};
 
 /* 菜单项数量定义 */
-#define MAIN_MENU_ITEMS 3
+#define MAIN_MENU_ITEMS 6
+#define MAIN_VIEW_ITEMS 5
 #define PID_MENU_ITEMS  13
 #define PID_VIEW_ITEMS  4
+#define TASK_VIEW_ITEMS 4
 
 /* 内部函数声明 */
 static void Draw_MainPage(void);
 static void Draw_MotorPage(void);
 static void Draw_GPSPage(void);
 static void Draw_PIDPage(void);
+static void Draw_TaskPage(void);
+static void Draw_TunePage(void);
+static void Draw_GSchedPage(void);
 
 /**
  * @brief UI 模块初始化
@@ -68,8 +74,20 @@ void App_UI_KeyProcess(void)
                         case 0: g_ui_state.current_page = PAGE_MOTOR; break;
                         case 1: g_ui_state.current_page = PAGE_GPS; break;
                         case 2: g_ui_state.current_page = PAGE_PID; break;
+                        case 3: g_ui_state.current_page = PAGE_TASK; break;
+                        case 4: g_ui_state.current_page = PAGE_TUNE; break;
+                        case 5: g_ui_state.current_page = PAGE_GSCHED; break;
                     }
                     g_ui_state.cursor_index = 0; // 重置光标
+                    g_ui_state.scroll_offset = 0;
+                }
+                break;
+
+            /* ---------------- 增益调度页面逻辑 (View Only) ---------------- */
+            case PAGE_GSCHED:
+                if (current_key == KEY_3) { // Back
+                    g_ui_state.current_page = PAGE_MAIN;
+                    g_ui_state.cursor_index = 5;
                 }
                 break;
 
@@ -82,6 +100,45 @@ void App_UI_KeyProcess(void)
                 }
                 break;
 
+            /* ---------------- 任务统计页面逻辑 (Up/Down 滚动) ---------------- */
+            case PAGE_TASK:
+                if (current_key == KEY_1) { // Up
+                    if (g_ui_state.scroll_offset > 0) g_ui_state.scroll_offset--;
+                }
+                else if (current_key == KEY_4) { // Down
+                    if (g_ui_state.scroll_offset < OS_MAX_TASKS - 1) g_ui_state.scroll_offset++;
+                }
+                else if (current_key == KEY_3) { // Back
+                    g_ui_state.current_page = PAGE_MAIN;
+                    g_ui_state.cursor_index = 3;
+                    g_ui_state.scroll_offset = 0;
+                }
+                break;
+
+            /* ---------------- 自整定页面逻辑 (cursor_index 为所选规则) ---------------- */
+            case PAGE_TUNE:
+                if (App_Follow_AutoTune_Active()) {
+                    if (current_key == KEY_3) { // Abort
+                        App_Follow_AutoTune_Stop();
+                    }
+                }
+                else if (current_key == KEY_1) { // Up -> 上一个规则
+                    if (g_ui_state.cursor_index > 0) g_ui_state.cursor_index--;
+                    else g_ui_state.cursor_index = PID_AT_RULE_COUNT - 1;
+                }
+                else if (current_key == KEY_4) { // Down -> 下一个规则
+                    if (g_ui_state.cursor_index < PID_AT_RULE_COUNT - 1) g_ui_state.cursor_index++;
+                    else g_ui_state.cursor_index = 0;
+                }
+                else if (current_key == KEY_2) { // Start
+                    App_Follow_AutoTune_Start((PID_AT_Rule_t)g_ui_state.cursor_index);
+                }
+                else if (current_key == KEY_3) { // Back
+                    g_ui_state.current_page = PAGE_MAIN;
+                    g_ui_state.cursor_index = 4;
+                }
+                break;
+
             /* ---------------- PID 参数页面逻辑 ---------------- */
             case PAGE_PID:
                 {
@@ -189,6 +246,9 @@ void App_UI_Refresh(void)
         case PAGE_MOTOR: Draw_MotorPage(); break;
         case PAGE_GPS:   Draw_GPSPage();   break;
         case PAGE_PID:   Draw_PIDPage();   break;
+        case PAGE_TASK:  Draw_TaskPage();  break;
+        case PAGE_TUNE:  Draw_TunePage();  break;
+        case PAGE_GSCHED: Draw_GSchedPage(); break;
         default:         Draw_MainPage();  break;
     }
 
@@ -200,19 +260,30 @@ void App_UI_Refresh(void)
 
 static void Draw_MainPage(void)
 {
-    const char *items[] = {"1. Motor Speed", "2. GPS Status", "3. PID Config"};
+    const char *items[] = {"1. Motor Speed", "2. GPS Status", "3. PID Config", "4. Task Stats", "5. Auto Tune", "6. Gain Sched"};
     
     u8g2_SetFont(&u8g2, u8g2_font_ncenB10_tr);
     u8g2_DrawStr(&u8g2, 0, 12, "Main Menu");
     u8g2_DrawHLine(&u8g2, 0, 14, 128);
 
     u8g2_SetFont(&u8g2, u8g2_font_ncenB08_tr);
-    for (int i = 0; i < MAIN_MENU_ITEMS; i++) {
+
+    /* 一屏放不下全部菜单项：滚动使光标可见 */
+    if (g_ui_state.cursor_index < g_ui_state.scroll_offset) {
+        g_ui_state.scroll_offset = g_ui_state.cursor_index;
+    } else if (g_ui_state.cursor_index >= g_ui_state.scroll_offset + MAIN_VIEW_ITEMS) {
+        g_ui_state.scroll_offset = g_ui_state.cursor_index - MAIN_VIEW_ITEMS + 1;
+    }
+
+    for (int i = 0; i < MAIN_VIEW_ITEMS; i++) {
+        int item_idx = g_ui_state.scroll_offset + i;
+        if (item_idx >= MAIN_MENU_ITEMS) break;
+
         /* 选中项反色显示或加 > */
-        if (i == g_ui_state.cursor_index) {
-            u8g2_DrawStr(&u8g2, 0, 30 + i * 14, ">"); 
+        if (item_idx == g_ui_state.cursor_index) {
+            u8g2_DrawStr(&u8g2, 0, 24 + i * 10, ">"); 
         }
-        u8g2_DrawStr(&u8g2, 10, 30 + i * 14, items[i]);
+        u8g2_DrawStr(&u8g2, 10, 24 + i * 10, items[item_idx]);
     }
 }
 
@@ -315,3 +386,104 @@ static void Draw_PIDPage(void)
         }
     }
 }
+
+static void Draw_TaskPage(void)
+{
+    char buf[32];
+    OS_TaskStats_t st;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB10_tr);
+    u8g2_DrawStr(&u8g2, 0, 12, "Task Stats");
+
+    /* 标题栏右侧显示 CPU 空闲率 */
+    uint32_t ticks = OS_GetTickCount();
+    uint32_t idle_pct = (ticks > 0) ? (uint32_t)((uint64_t)OS_GetIdleTicks() * 100U / ticks) : 0;
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB08_tr);
+    snprintf(buf, sizeof(buf), "idle%lu%%", (unsigned long)idle_pct);
+    u8g2_DrawStr(&u8g2, 84, 12, buf);
+    u8g2_DrawHLine(&u8g2, 0, 14, 128);
+
+    /* 每行: 任务名 平均/最大耗时 (us)，从 scroll_offset 开始列出有效任务 */
+    int row = 0;
+    int skipped = 0;
+    for (int id = 0; id < OS_MAX_TASKS && row < TASK_VIEW_ITEMS; id++) {
+        if (OS_GetTaskStats(id, &st) != 0) continue;
+        if (skipped++ < g_ui_state.scroll_offset) continue;
+
+        snprintf(buf, sizeof(buf), "%-6.6s %lu/%lu",
+                 st.name ? st.name : "-",
+                 (unsigned long)(st.cyclesMean / cycles_per_us),
+                 (unsigned long)(st.cyclesMax / cycles_per_us));
+        u8g2_DrawStr(&u8g2, 0, 26 + row * 12, buf);
+        row++;
+    }
+}
+
+static void Draw_TunePage(void)
+{
+    char buf[32];
+    uint8_t running = App_Follow_AutoTune_Active();
+
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB10_tr);
+    u8g2_DrawStr(&u8g2, 0, 12, "Auto Tune");
+    u8g2_DrawHLine(&u8g2, 0, 14, 128);
+
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB08_tr);
+    snprintf(buf, sizeof(buf), "Rule: %s", PID_AT_RuleName((PID_AT_Rule_t)g_ui_state.cursor_index));
+    u8g2_DrawStr(&u8g2, 0, 26, buf);
+
+    /* 每个电机一行：运行中显示已稳定周期数和最近周期，结束后显示整定结果 */
+    for (uint8_t ch = 0; ch < 2; ch++) {
+        const PID_AT_t *at = App_Follow_AutoTune_Get(ch);
+        char name = (ch == 0) ? 'L' : 'R';
+        switch (at->state) {
+            case PID_AT_RUNNING:
+                snprintf(buf, sizeof(buf), "%c: osc %u/%u  %.1fs", name,
+                         at->periods, PID_AT_STABLE_PERIODS, at->ticks * at->dt);
+                break;
+            case PID_AT_DONE:
+                snprintf(buf, sizeof(buf), "%c:%.1f %.2f %.2f", name, at->Kp, at->Ki, at->Kd);
+                break;
+            case PID_AT_FAILED:
+                snprintf(buf, sizeof(buf), "%c: failed", name);
+                break;
+            default:
+                snprintf(buf, sizeof(buf), "%c: -", name);
+                break;
+        }
+        u8g2_DrawStr(&u8g2, 0, 38 + ch * 12, buf);
+    }
+
+    u8g2_DrawStr(&u8g2, 0, 62, running ? "Wheels up! K3:Abort" : "K2:Start  K3:Back");
+}
+
+static void Draw_GSchedPage(void)
+{
+    char buf[32];
+    const Gain_Sched_Table_t *tabs[FOLLOW_LOOP_COUNT] = { &g_app_params.gs_dist, &g_app_params.gs_angle };
+    const char *names[FOLLOW_LOOP_COUNT] = { "Dist", "Ang" };
+
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB10_tr);
+    u8g2_DrawStr(&u8g2, 0, 12, "Gain Sched");
+    u8g2_DrawHLine(&u8g2, 0, 14, 128);
+
+    /* 每个回路两行：调度变量与当前区间 / 插值后的增益 */
+    u8g2_SetFont(&u8g2, u8g2_font_ncenB08_tr);
+    for (uint8_t loop = 0; loop < FOLLOW_LOOP_COUNT; loop++) {
+        const Gain_Sched_Table_t *t = tabs[loop];
+        const Gain_Sched_Out_t *o = App_Follow_GS_Get(loop);
+        int y = 26 + loop * 24;
+
+        if (!t->enable || !Gain_Sched_Valid(t)) {
+            snprintf(buf, sizeof(buf), "%s: fixed gains", names[loop]);
+            u8g2_DrawStr(&u8g2, 0, y, buf);
+            continue;
+        }
+        snprintf(buf, sizeof(buf), "%s %s=%.0f seg %u-%u", names[loop], Gain_Sched_SrcName(t->src),
+                 o->x, o->seg, o->seg + 1);
+        u8g2_DrawStr(&u8g2, 0, y, buf);
+        snprintf(buf, sizeof(buf), " %.2f %.3f %.2f", o->kp, o->ki, o->kd);
+        u8g2_DrawStr(&u8g2, 0, y + 11, buf);
+    }
+}
@@ -19,6 +19,9 @@ typedef enum {
     PAGE_MOTOR,     // ??????
     PAGE_GPS,       // GPS ??
     PAGE_PID,       // PID ????????
+    PAGE_TASK,      // 任务执行统计 (OS profiler)
+    PAGE_TUNE,      // 速度环自整定
+    PAGE_GSCHED,    // 外环增益调度
     PAGE_MAX
 } UI_Page_e;
 
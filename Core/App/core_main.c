@@ -1,8 +1,9 @@
 #include "core_main.h"
 #include "app_ui.h"
 #include "app_comm.h"
+#include "app_log.h"
 #include "os.h"
-#include "pid.h"
+#include "app_follow.h"
 #include "Bsp_GPS.h"
 #include "Bsp_Led.h"
 #include "Bsp_Key.h"
@@ -34,6 +35,8 @@ static void Task_LedRun(void *arg);
  */
 void Core_Main_Init(void)
 {
+    uint32_t boot_start = HAL_GetTick();    // 统计初始化耗时 (含全部启动打印)
+
     printf("[Core_Main_Init] Start...\r\n");
 
 	/* 初始化 TB6612 电机驱动 */
@@ -73,9 +76,10 @@ void Core_Main_Init(void)
     App_Follow_Init();
     printf("[Core_Main_Init] Follow PID Init done.\r\n");
     
-    /* 启动 TIM14 定时器中断 (10ms) 用于 OpenMV 解析和 PID */
+    /* 启动 TIM14 定时器中断 (1MHz 计数，ENCODER_SAMPLE_HZ 频率) 用于测速和速度环 */
+    __HAL_TIM_SET_AUTORELOAD(&htim14, 1000000U / ENCODER_SAMPLE_HZ - 1U);
     HAL_TIM_Base_Start_IT(&htim14);
-    printf("[Core_Main_Init] OpenMV Init done (USART6) & TIM14 Started.\r\n");
+    printf("[Core_Main_Init] OpenMV Init done (USART6) & TIM14 Started (%u Hz).\r\n", (unsigned)ENCODER_SAMPLE_HZ);
 
     /* 初始化 PID (旧的 PID 初始化注释掉，使用新的跟随控制 PID) */
     /*
@@ -92,26 +96,39 @@ void Core_Main_Init(void)
     OS_Init();
     printf("[Core_Main_Init] OS Init done.\r\n");
 
-    /* 创建任务 */
+    /* 日志输出任务：优先级 0 (最低)，经 USART1 DMA 发送 App_Log 的内容 */
+    App_Log_Init(0);
+
+    /* 创建任务 (截止时刻：OS_CFG_SCHED_POLICY 为 EDF 时参与调度，否则只统计错过次数；
+     * WCET 为准入声明值，实测超出时 OS 按实测值重新准入) */
+    int32_t id;
+
     // 机器人主控任务：优先级 2 (高)
     // OS_CreateTask(Task_RobotControl, NULL, 2); // 注释掉：控制逻辑已移至 TIM14 中断
     
-    // UI 更新任务：优先级 1 (低)
-    OS_CreateTask(Task_UIUpdate, NULL, 1);
+    // UI 更新任务：优先级 1 (低, 50ms 周期，截止时刻 = 周期；WCET 主要是 I2C 阻塞发送整屏 1KB，约 25ms)
+    id = OS_CreatePeriodicTask(Task_UIUpdate, NULL, 1, 50 / OS_TICK_MS, 0);
+    OS_SetTaskName(id, "UI");
+    OS_SetTaskDeadline(id, 50 / OS_TICK_MS, 25000);
     
-    // GPS 处理任务：优先级 1 (低, 200ms周期)
-    OS_CreateTask(GPS_Process_Task, NULL, 1);
+    // GPS 处理任务：优先级 1 (低, 等待 GPS 接收事件，200ms 内处理完)
+    id = OS_CreateTask(GPS_Process_Task, NULL, 1);
+    OS_SetTaskName(id, "GPS");
+    OS_SetTaskDeadline(id, 200 / OS_TICK_MS, 2000);
     
     // OpenMV 调试打印任务：优先级 1 (低)
-    OS_CreateTask(OpenMV_Print_Task, NULL, 1);
+    OS_SetTaskName(OS_CreateTask(OpenMV_Print_Task, NULL, 1), "OpenMV");
 
-    // LED 跑马灯任务：优先级 0 (最低, 阻塞式逻辑)
-    OS_CreateTask(Task_LedRun, NULL, 0);
+    // LED 跑马灯任务：优先级 0 (最低, 200ms 周期)
+    OS_SetTaskName(OS_CreatePeriodicTask(Task_LedRun, NULL, 0, 200 / OS_TICK_MS, 0), "LED");
 
-    // 通信处理任务：优先级 3 (最高)
-    OS_CreateTask(Task_Comm, NULL, 3);
+    // 通信处理任务：优先级 3 (最高, 收到命令后 10ms 内处理完)
+    id = OS_CreateTask(Task_Comm, NULL, 3);
+    OS_SetTaskName(id, "Comm");
+    OS_SetTaskDeadline(id, 10 / OS_TICK_MS, 1000);
     
-    printf("[Core_Main_Init] All tasks created. System Ready.\r\n");
+    printf("[Core_Main_Init] All tasks created. System Ready (%lu ms).\r\n",
+           (unsigned long)(HAL_GetTick() - boot_start));
 }
 
 /**
@@ -195,99 +212,70 @@ static void Task_RobotControl(void *arg)
 
 /**
  * @brief 通信处理任务
+ * @note  阻塞在命令队列上，WiFi 收到一帧即被唤醒，无需周期轮询
  */
 static void Task_Comm(void *arg)
 {
     /* 调用通信模块的处理函数 */
     App_Comm_ProcessTask();
-    
-    /* 延时 10ms */
-    OS_DelayMs(10);
 }
 
 /**
- * @brief UI 更新任务
+ * @brief UI 更新任务 (50ms 周期任务)
  */
 static void Task_UIUpdate(void *arg)
 {
     /* 调用新的菜单刷新函数 (包含按键处理) */
     App_UI_Refresh();
-    
-    // 延时 50ms，提高 UI 响应速度
-    OS_DelayMs(50);
 }
 
 /**
  * @brief LED 跑马灯任务
  * @param arg 任务参数 (未使用)
- * @note  阻塞式逻辑，利用 OS_DelayMs 切换状态
+ * @note  200ms 周期任务，写成协程：每个 OS_CO_YIELD 等待下一个周期
  *        顺序: LED1 -> LED2 -> LED3 -> LED4 -> LED1 ...
  */
 static void Task_LedRun(void *arg)
 {
-    static uint8_t step = 0;
-    const uint32_t LED_DELAY = 200; // 200ms 切换一次
+    OS_CO_BEGIN();
 
-    // 先熄灭所有 LED (或者只熄灭上一个)
-    // 为了简单且健壮，根据 step 决定亮哪个，其他灭
-    
-    switch (step)
-    {
-        case 0:
-            BSP_LED_On(LED_1);
-            BSP_LED_Off(LED_2);
-            BSP_LED_Off(LED_3);
-            BSP_LED_Off(LED_4);
-            break;
-        case 1:
-            BSP_LED_Off(LED_1);
-            BSP_LED_On(LED_2);
-            BSP_LED_Off(LED_3);
-            BSP_LED_Off(LED_4);
-            break;
-        case 2:
-            BSP_LED_Off(LED_1);
-            BSP_LED_Off(LED_2);
-            BSP_LED_On(LED_3);
-            BSP_LED_Off(LED_4);
-            break;
-        case 3:
-            BSP_LED_Off(LED_1);
-            BSP_LED_Off(LED_2);
-            BSP_LED_Off(LED_3);
-            BSP_LED_On(LED_4);
-            break;
-        default:
-            step = 0;
-            break;
-    }
+    BSP_LED_Off(LED_4);
+    BSP_LED_On(LED_1);
+    OS_CO_YIELD();
 
-    // 切换到下一个状态
-    step++;
-    if (step >= 4) {
-        step = 0;
-    }
+    BSP_LED_Off(LED_1);
+    BSP_LED_On(LED_2);
+    OS_CO_YIELD();
 
-    // 阻塞延时，让出 CPU
-    OS_DelayMs(LED_DELAY);
+    BSP_LED_Off(LED_2);
+    BSP_LED_On(LED_3);
+    OS_CO_YIELD();
+
+    BSP_LED_Off(LED_3);
+    BSP_LED_On(LED_4);
+
+    OS_CO_END();    // 下一个周期从 LED1 重新开始
+}
+
+/**
+ * @brief OpenMV 新帧回调：帧同步地运行视觉外环
+ * @note  在延后处理任务中执行 (USART6 接收事件投递的解析)
+ */
+void OpenMV_Frame_Callback(const OpenMV_Data_t *data)
+{
+    App_Follow_Vision_Loop(data);
 }
 
 /**
  * @brief 定时器周期中断回调函数
  * @param htim 触发回调的定时器句柄
- * @note  仅在 TIM14 中断时更新编码器速度
+ * @note  TIM14 中断直接执行测速和速度环；视觉解析由 USART6 接收事件驱动，不在这里轮询
  */
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
-    /* 由 TIM14 周期中断触发编码器速度更新 */
+    /* 由 TIM14 周期中断驱动速度环 (ENCODER_SAMPLE_HZ) */
     if (htim->Instance == TIM14) {
-        /* 1. OpenMV 解析 (Updating openmv_data) */
-        OpenMV_Parse_Callback();
-        
-        /* 2. Update Speed (Updating motor.speed_rpm) */
-        Encoder_Update_Speed(&motor1, &motor2);
-        
-        /* 3. Control Loop (Using openmv_data and speed_rpm) */
-        App_Follow_Control_Loop();
+        /* 在固定时刻采样编码器并更新 PWM，保证速度环周期准确 */
+        App_Follow_Speed_Loop();
     }
     /* 由 TIM13 周期中断触发按键消抖 (10ms) */
     else if (htim->Instance == TIM13) {
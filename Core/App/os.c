@@ -2,13 +2,115 @@
  * @file    os.c
  * @brief   简单协同式任务调度器实现文件
  * @date    2026-02-19
+ * @note    就绪任务按优先级挂在各自的就绪链表上，并用两级位图记录
+ *          哪些优先级非空：g_readyGroup 的第 g 位表示 g_readyTable[g]
+ *          非零，g_readyTable[g] 的第 b 位表示优先级 (g*32 + b) 有任务。
+ *          选择下一个任务只需两次 CLZ，与任务数无关。
+ *
+ *          延时任务按唤醒时刻排成差分链表 (delta list)：每个节点的
+ *          delayTicks 只记录相对前一节点的 tick 差，OS_Tick 每次只需
+ *          递减表头。唤醒时刻相同的一串任务首尾互指 (delayLast)，表头
+ *          到期时整串一次拼到待唤醒链表，中断里的开销与到期任务数无关；
+ *          摘等待链表、放回就绪链表留到线程态 (OS_ScheduleOnce / OS_Idle
+ *          开头) 逐个处理。
+ *
+ *          没有就绪任务时进入空闲：表头差值就是距离下次唤醒的 tick 数，
+ *          交给 OS_PortSleep 停掉节拍睡眠，醒来后用 OS_TickAdvance 补记。
+ *
+ *          事件标志和消息队列各带一条等待链表 (FIFO)。条件不满足时当前
+ *          任务挂到链表上进入 BLOCKED，有超时的同时挂入延时链表；中断
+ *          里置位事件或发送消息时直接把等待者放回就绪链表，不再依赖轮询。
+ *
+ *          周期任务记录本次释放的绝对时刻，执行完由调度器按
+ *          release + period 重新挂入延时链表，周期与任务执行时间无关。
+ *
+ *          同优先级任务按 FIFO 轮转。低优先级任务可能被持续就绪的高
+ *          优先级任务饿死，因此调度器定期扫描就绪任务，等待超过
+ *          OS_CFG_AGING_TICKS 的任务临时提升到当前最高就绪优先级 (排在
+ *          该级队尾)，被调度时恢复基础优先级，就绪等待因此有上界。
+ *
+ *          OS_SCHED_EDF 策略下，声明了截止时刻的任务不进位图，而是按
+ *          绝对截止时刻排成一条有序就绪链表，调度时先取其表头；只有
+ *          OS_CFG_DEFER_PRIO 及以上优先级 (中断下半部) 排在它前面。
+ *          准入按声明与实测 WCET 的较大者计算密度，实测超限的任务降级
+ *          回位图按固定优先级调度。
+ *
+ *          中断只需调用 OS_DeferPost 把工作函数放入单生产者无锁环形队列
+ *          (os_ring.h)，
+ *          OS_Init 创建的最高优先级任务在下一个调度点取出执行，缩短中断
+ *          本身的最坏执行时间。
  */
 
 #include "os.h"
+#include "os_ring.h"
+#include <stdio.h>
+#include <string.h>
+
+#define OS_PRIO_GROUPS  (OS_PRIO_LEVELS / 32)
 
 static OS_TCB_t g_tasks[OS_MAX_TASKS];
 static int32_t  g_currentTask = OS_INVALID_TASK;
 
+/* 就绪位图与每个优先级的就绪链表 (FIFO) */
+static uint32_t g_readyGroup;
+static uint32_t g_readyTable[OS_PRIO_GROUPS];
+static int16_t  g_readyHead[OS_PRIO_LEVELS];
+static int16_t  g_readyTail[OS_PRIO_LEVELS];
+
+/* 延时差分链表表头 */
+static int16_t  g_delayHead = OS_INVALID_TASK;
+/* 已到期、等待线程态处理的任务 (复用 delayNext/delayPrev，整条链表视为一串) */
+static int16_t  g_wakeHead  = OS_INVALID_TASK;
+static int16_t  g_wakeTail  = OS_INVALID_TASK;
+
+/* 时间与空闲统计 */
+static volatile uint32_t g_tickCount;
+static volatile uint32_t g_idleTicks;
+static volatile uint8_t  g_inIdle;       // 1: 上一次调度后 CPU 一直空闲
+
+#if OS_CFG_TICK_PROFILE
+static uint32_t g_tickMaxCycles;
+#endif
+
+#if OS_CFG_AGING
+static uint32_t g_lastAgingScan;
+#endif
+
+#if OS_CFG_DEFER
+/* 延后工作队列：中断生产，处理任务消费 */
+#if !OS_RING_IS_POW2(OS_CFG_DEFER_DEPTH)
+#error "OS_CFG_DEFER_DEPTH must be a power of 2"
+#endif
+
+typedef struct {
+    void    (*fn)(void *);
+    void     *arg;
+    uint32_t  stamp;            // 投递时刻 (CPU 周期)
+} OS_DeferItem_t;
+
+static OS_DeferItem_t    g_deferBuf[OS_CFG_DEFER_DEPTH];
+static volatile uint32_t g_deferDropped;
+static uint32_t          g_deferMaxLatency;
+/* 静态初始化：OS_Init 之前中断就可能投递并置位事件 */
+static OS_Ring_t         g_deferRing = {
+    (uint8_t *)g_deferBuf, sizeof(OS_DeferItem_t), OS_CFG_DEFER_DEPTH - 1U, 0, 0
+};
+static OS_Event_t        g_deferEvent = { 0, OS_INVALID_TASK };
+
+static void OS_DeferTask(void *arg);
+#endif
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+/* 按绝对截止时刻排序的就绪链表 (复用 readyNext/readyPrev) */
+static int16_t  g_edfHead = OS_INVALID_TASK;
+#define OS_NO_READY_TASK()  (g_readyGroup == 0 && g_edfHead == OS_INVALID_TASK && \
+                             g_wakeHead == OS_INVALID_TASK)
+/* 按截止时刻调度 (声明了截止时刻且未被降级) */
+#define OS_IN_EDF(id)       (g_tasks[id].relDeadline > 0 && !g_tasks[id].edfDemoted)
+#else
+#define OS_NO_READY_TASK()  (g_readyGroup == 0 && g_wakeHead == OS_INVALID_TASK)
+#endif
+
 // 找一个空闲的任务槽位
 static int32_t OS_FindEmptySlot(void)
 {
@@ -20,42 +122,454 @@ static int32_t OS_FindEmptySlot(void)
     return OS_INVALID_TASK;
 }
 
-// 从所有 READY 任务中选出优先级最高的一个
-static int32_t OS_SelectNextTask(void)
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+// 按绝对截止时刻插入 EDF 就绪链表，截止时刻相同的排在后面 (调用者负责临界区)
+static void OS_EdfInsert(int32_t id)
 {
-    int32_t bestId = OS_INVALID_TASK;
-    uint8_t bestPrio = 0;
-    int     found = 0; // 标记是否找到至少一个 READY 任务
+    int16_t prev = OS_INVALID_TASK;
+    int16_t cur  = g_edfHead;
+    uint32_t dl  = g_tasks[id].absDeadline;
 
-    for (int i = 0; i < OS_MAX_TASKS; ++i) {
-        if (g_tasks[i].state == OS_TASK_READY) {
-            // 如果是第一个找到的任务，或者优先级更高
-            if (!found || g_tasks[i].priority > bestPrio) {
-                bestId = i;
-                bestPrio = g_tasks[i].priority;
-                found = 1;
+    while (cur != OS_INVALID_TASK && (int32_t)(g_tasks[cur].absDeadline - dl) <= 0) {
+        prev = cur;
+        cur  = g_tasks[cur].readyNext;
+    }
+
+    g_tasks[id].readyPrev = prev;
+    g_tasks[id].readyNext = cur;
+    if (cur != OS_INVALID_TASK)  g_tasks[cur].readyPrev = (int16_t)id;
+    if (prev != OS_INVALID_TASK) g_tasks[prev].readyNext = (int16_t)id;
+    else                         g_edfHead = (int16_t)id;
+}
+
+static void OS_EdfRemove(int32_t id)
+{
+    int16_t next = g_tasks[id].readyNext;
+    int16_t prev = g_tasks[id].readyPrev;
+
+    if (prev != OS_INVALID_TASK) g_tasks[prev].readyNext = next;
+    else                         g_edfHead = next;
+    if (next != OS_INVALID_TASK) g_tasks[next].readyPrev = prev;
+
+    g_tasks[id].readyNext = OS_INVALID_TASK;
+    g_tasks[id].readyPrev = OS_INVALID_TASK;
+}
+#endif
+
+// 将任务挂到其优先级就绪链表尾部，并置位图 (调用者负责临界区)
+// 新进入就绪态时记录就绪时刻 now，并据此 (周期任务按释放时刻) 算出本次作业的截止时刻
+static void OS_ReadyInsertAt(int32_t id, uint32_t now)
+{
+    uint8_t prio = g_tasks[id].priority;
+
+    if (g_tasks[id].state != OS_TASK_READY) {
+        g_tasks[id].readySince  = now;
+        g_tasks[id].absDeadline = (g_tasks[id].period > 0 ? g_tasks[id].release : now)
+                                + g_tasks[id].relDeadline;
+    }
+    g_tasks[id].state     = OS_TASK_READY;
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    if (OS_IN_EDF(id)) {
+        OS_EdfInsert(id);
+        return;
+    }
+#endif
+
+    g_tasks[id].readyNext = OS_INVALID_TASK;
+    g_tasks[id].readyPrev = g_readyTail[prio];
+
+    if (g_readyTail[prio] != OS_INVALID_TASK) {
+        g_tasks[g_readyTail[prio]].readyNext = (int16_t)id;
+    } else {
+        g_readyHead[prio] = (int16_t)id;
+    }
+    g_readyTail[prio] = (int16_t)id;
+
+    g_readyTable[prio >> 5] |= (1UL << (prio & 0x1F));
+    g_readyGroup            |= (1UL << (prio >> 5));
+}
+
+static void OS_ReadyInsert(int32_t id)
+{
+    OS_ReadyInsertAt(id, g_tickCount);
+}
+
+// 将任务从就绪链表摘除，链表空时清位图 (调用者负责临界区)
+static void OS_ReadyRemove(int32_t id)
+{
+    uint8_t prio = g_tasks[id].priority;
+    int16_t next = g_tasks[id].readyNext;
+    int16_t prev = g_tasks[id].readyPrev;
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    if (OS_IN_EDF(id)) {
+        OS_EdfRemove(id);
+        return;
+    }
+#endif
+
+    if (prev != OS_INVALID_TASK) g_tasks[prev].readyNext = next;
+    else                         g_readyHead[prio] = next;
+
+    if (next != OS_INVALID_TASK) g_tasks[next].readyPrev = prev;
+    else                         g_readyTail[prio] = prev;
+
+    g_tasks[id].readyNext = OS_INVALID_TASK;
+    g_tasks[id].readyPrev = OS_INVALID_TASK;
+
+    if (g_readyHead[prio] == OS_INVALID_TASK) {
+        g_readyTable[prio >> 5] &= ~(1UL << (prio & 0x1F));
+        if (g_readyTable[prio >> 5] == 0) {
+            g_readyGroup &= ~(1UL << (prio >> 5));
+        }
+    }
+}
+
+// 按唤醒时刻把任务插入延时差分链表，ticks >= 1 (调用者负责临界区)
+// 相同唤醒时刻的任务排在已有任务之后，保持先来先唤醒；
+// 唤醒时刻暂存在 readySince，到期后在线程态按它记就绪时刻
+static void OS_DelayInsert(int32_t id, uint32_t ticks)
+{
+    int16_t prev = OS_INVALID_TASK;
+    int16_t cur  = g_delayHead;
+
+    g_tasks[id].readySince = g_tickCount + ticks;
+
+    while (cur != OS_INVALID_TASK && ticks >= g_tasks[cur].delayTicks) {
+        ticks -= g_tasks[cur].delayTicks;
+        prev = cur;
+        cur  = g_tasks[cur].delayNext;
+    }
+
+    // 差值为 0 时接在 prev 所在串的串尾 (cur 的差值 > 0，prev 必是串尾)
+    if (ticks == 0) {
+        int16_t first = g_tasks[prev].delayLast;
+        g_tasks[first].delayLast = (int16_t)id;
+        g_tasks[id].delayLast    = first;
+    } else {
+        g_tasks[id].delayLast    = (int16_t)id;
+    }
+
+    g_tasks[id].state      = OS_TASK_DELAYED;
+    g_tasks[id].delayTicks = ticks;
+    g_tasks[id].delayPrev  = prev;
+    g_tasks[id].delayNext  = cur;
+
+    if (cur != OS_INVALID_TASK) {
+        g_tasks[cur].delayTicks -= ticks;   // 后继改为相对新节点的差值
+        g_tasks[cur].delayPrev   = (int16_t)id;
+    }
+    if (prev != OS_INVALID_TASK) g_tasks[prev].delayNext = (int16_t)id;
+    else                         g_delayHead = (int16_t)id;
+}
+
+// 从延时差分链表或待唤醒链表摘除任务，其剩余差值并入后继 (调用者负责临界区)
+// 串首 (无前驱或差值非 0) 与串尾 (无后继或后继差值非 0) 被摘时把互指交给邻居
+static void OS_DelayRemove(int32_t id)
+{
+    int16_t next = g_tasks[id].delayNext;
+    int16_t prev = g_tasks[id].delayPrev;
+    int     first = (prev == OS_INVALID_TASK || g_tasks[id].delayTicks != 0);
+    int     last  = (next == OS_INVALID_TASK || g_tasks[next].delayTicks != 0);
+
+    if (first && !last) {
+        g_tasks[next].delayLast = g_tasks[id].delayLast;
+        g_tasks[g_tasks[id].delayLast].delayLast = next;
+    } else if (!first && last) {
+        g_tasks[prev].delayLast = g_tasks[id].delayLast;
+        g_tasks[g_tasks[id].delayLast].delayLast = prev;
+    }
+
+    if (next != OS_INVALID_TASK) {
+        g_tasks[next].delayTicks += g_tasks[id].delayTicks;
+        g_tasks[next].delayPrev   = prev;
+    } else if (g_wakeTail == id) {
+        g_wakeTail = prev;
+    }
+    if (prev != OS_INVALID_TASK) g_tasks[prev].delayNext = next;
+    else if (g_delayHead == id)  g_delayHead = next;
+    else                         g_wakeHead  = next;
+
+    g_tasks[id].delayNext  = OS_INVALID_TASK;
+    g_tasks[id].delayPrev  = OS_INVALID_TASK;
+    g_tasks[id].delayTicks = 0;
+}
+
+// 任务是否在延时差分链表或待唤醒链表中
+static int OS_InDelayList(int32_t id)
+{
+    return (g_delayHead == id) || (g_wakeHead == id) ||
+           (g_tasks[id].delayPrev != OS_INVALID_TASK);
+}
+
+// 表头差值已减到 0：把表头那一串整体拼到待唤醒链表尾部，O(1) (调用者负责临界区)
+static void OS_DelayDetachRun(void)
+{
+    int16_t first = g_delayHead;
+    int16_t last  = g_tasks[first].delayLast;
+
+    g_delayHead = g_tasks[last].delayNext;
+    if (g_delayHead != OS_INVALID_TASK) {
+        g_tasks[g_delayHead].delayPrev = OS_INVALID_TASK;
+    }
+    g_tasks[last].delayNext = OS_INVALID_TASK;
+
+    if (g_wakeTail == OS_INVALID_TASK) {
+        g_wakeHead = first;
+    } else {
+        g_tasks[g_wakeTail].delayNext = first;
+        g_tasks[first].delayPrev      = g_wakeTail;
+        g_tasks[g_wakeHead].delayLast = last;
+        g_tasks[last].delayLast       = g_wakeHead;
+    }
+    g_wakeTail = last;
+}
+
+// 把任务追加到等待链表尾部 (调用者负责临界区)
+static void OS_WaitListAppend(int16_t *list, int32_t id)
+{
+    g_tasks[id].waitList = list;
+    g_tasks[id].waitNext = OS_INVALID_TASK;
+
+    if (*list == OS_INVALID_TASK) {
+        *list = (int16_t)id;
+        return;
+    }
+
+    int16_t cur = *list;
+    while (g_tasks[cur].waitNext != OS_INVALID_TASK) {
+        cur = g_tasks[cur].waitNext;
+    }
+    g_tasks[cur].waitNext = (int16_t)id;
+}
+
+// 把任务从其等待链表摘除 (调用者负责临界区)
+static void OS_WaitListRemove(int32_t id)
+{
+    int16_t *list = g_tasks[id].waitList;
+
+    if (list != 0) {
+        if (*list == id) {
+            *list = g_tasks[id].waitNext;
+        } else {
+            int16_t cur = *list;
+            while (cur != OS_INVALID_TASK && g_tasks[cur].waitNext != id) {
+                cur = g_tasks[cur].waitNext;
+            }
+            if (cur != OS_INVALID_TASK) {
+                g_tasks[cur].waitNext = g_tasks[id].waitNext;
             }
         }
     }
-    return bestId;
+
+    g_tasks[id].waitList = 0;
+    g_tasks[id].waitNext = OS_INVALID_TASK;
 }
 
+// 取消阻塞任务的等待 (等待链表 + 超时)，用于删除/挂起 (调用者负责临界区)
+static void OS_WaitCancel(int32_t id)
+{
+    OS_WaitListRemove(id);
+    if (OS_InDelayList(id)) {
+        OS_DelayRemove(id);
+    }
+}
+
+// 等待条件满足：唤醒阻塞任务 (调用者负责临界区)
+static void OS_WaitWake(int32_t id)
+{
+    OS_WaitCancel(id);
+    g_tasks[id].timeoutList = 0;
+    OS_ReadyInsert(id);
+}
+
+// 处理待唤醒链表：普通延时直接就绪，阻塞等待则记为超时，就绪时刻取到期时刻
+// 在线程态调用，每处理一个任务开一次中断
+static void OS_WakePending(void)
+{
+    OS_CRITICAL_ALLOC();
+
+    OS_ENTER_CRITICAL();
+    while (g_wakeHead != OS_INVALID_TASK) {
+        int32_t id = g_wakeHead;
+
+        OS_DelayRemove(id);
+        if (g_tasks[id].state == OS_TASK_BLOCKED) {
+            g_tasks[id].timeoutList = g_tasks[id].waitList;
+            OS_WaitListRemove(id);
+        }
+        OS_ReadyInsertAt(id, g_tasks[id].readySince);
+
+        OS_EXIT_CRITICAL();
+        OS_ENTER_CRITICAL();
+    }
+    OS_EXIT_CRITICAL();
+}
+
+// 条件不满足时让当前任务阻塞在 list 上 (调用者负责临界区)
+// 返回 OS_PENDING 表示已阻塞；上一次在同一对象上超时则返回 OS_ERR_TIMEOUT
+static int32_t OS_WaitBlock(int16_t *list, uint32_t timeout)
+{
+    if (timeout == 0) {
+        return OS_ERR_TIMEOUT;
+    }
+    if (g_currentTask < 0 || g_currentTask >= OS_MAX_TASKS) {
+        return OS_ERR_PARAM;
+    }
+    if (g_tasks[g_currentTask].timeoutList == list) {
+        g_tasks[g_currentTask].timeoutList = 0;
+        return OS_ERR_TIMEOUT;
+    }
+
+    if (timeout != OS_WAIT_FOREVER) {
+        OS_DelayInsert(g_currentTask, timeout);
+    }
+    OS_WaitListAppend(list, g_currentTask);
+    g_tasks[g_currentTask].state = OS_TASK_BLOCKED;
+    g_currentTask = OS_INVALID_TASK;
+
+    return OS_PENDING;
+}
+
+// 等待成功返回前清掉当前任务残留的超时记录 (调用者负责临界区)
+static void OS_WaitDone(void)
+{
+    if (g_currentTask >= 0 && g_currentTask < OS_MAX_TASKS) {
+        g_tasks[g_currentTask].timeoutList = 0;
+    }
+}
+
+#if OS_CFG_TASK_PROFILE
+// 清零单个任务的执行统计
+static void OS_ProfileClear(int32_t id)
+{
+    g_tasks[id].runCount    = 0;
+    g_tasks[id].cyclesMin   = 0xFFFFFFFFUL;
+    g_tasks[id].cyclesMax   = 0;
+    g_tasks[id].cyclesTotal = 0;
+}
+#endif
+
+// 从所有 READY 任务中选出优先级最高的一个 (O(1)：两次 CLZ)
+// EDF 策略下截止时刻最早的任务优先，但延后处理任务 (OS_CFG_DEFER_PRIO 及以上) 不排在
+// EDF 任务之后，否则持续就绪的 EDF 任务会把中断下半部饿死
+static int32_t OS_SelectNextTask(void)
+{
+    uint32_t prio = 0;
+
+    if (g_readyGroup != 0) {
+        uint32_t group = 31U - OS_CLZ(g_readyGroup);
+        prio = (group << 5) | (31U - OS_CLZ(g_readyTable[group]));
+    }
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    if (g_edfHead != OS_INVALID_TASK && (g_readyGroup == 0 || prio < OS_CFG_DEFER_PRIO)) {
+        return g_edfHead;
+    }
+#endif
+    if (g_readyGroup == 0) {
+        return OS_INVALID_TASK;
+    }
+    return g_readyHead[prio];
+}
+
+#if OS_CFG_AGING
+// 老化扫描：就绪等待过久的任务提升到当前最高就绪优先级 (调用者负责临界区)
+static void OS_AgingScan(void)
+{
+    uint32_t now = g_tickCount;
+
+    if (g_readyGroup == 0) return;
+
+    uint32_t group   = 31U - OS_CLZ(g_readyGroup);
+    uint8_t  topPrio = (uint8_t)((group << 5) | (31U - OS_CLZ(g_readyTable[group])));
+
+    // 最多提升到 OS_CFG_DEFER_PRIO 之下：该级及以上留给中断下半部 (EDF 下还先于 EDF 任务)
+    if (topPrio >= OS_CFG_DEFER_PRIO) {
+        topPrio = OS_CFG_DEFER_PRIO - 1;
+    }
+
+    for (int i = 0; i < OS_MAX_TASKS; ++i) {
+        if (g_tasks[i].state != OS_TASK_READY) continue;
+        if (g_tasks[i].priority >= topPrio) continue;
+        if (now - g_tasks[i].readySince < OS_CFG_AGING_TICKS) continue;
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+        if (OS_IN_EDF(i)) continue;     // EDF 任务不在优先级位图中
+#endif
+
+        // 状态仍为 READY，重新插入不会改写就绪时刻
+        OS_ReadyRemove(i);
+        g_tasks[i].priority = topPrio;
+        OS_ReadyInsert(i);
+    }
+}
+#endif
+
 void OS_Init(void)
 {
     for (int i = 0; i < OS_MAX_TASKS; ++i) {
         g_tasks[i].entry      = 0;
         g_tasks[i].arg        = 0;
         g_tasks[i].priority   = 0;
+        g_tasks[i].basePriority = 0;
         g_tasks[i].state      = OS_TASK_UNUSED;
         g_tasks[i].delayTicks = 0;
+        g_tasks[i].readyNext  = OS_INVALID_TASK;
+        g_tasks[i].readyPrev  = OS_INVALID_TASK;
+        g_tasks[i].delayNext  = OS_INVALID_TASK;
+        g_tasks[i].delayPrev  = OS_INVALID_TASK;
+        g_tasks[i].delayLast  = OS_INVALID_TASK;
+        g_tasks[i].waitList   = 0;
+        g_tasks[i].waitNext   = OS_INVALID_TASK;
+        g_tasks[i].timeoutList = 0;
+        g_tasks[i].waitMask   = 0;
+        g_tasks[i].period     = 0;
+        g_tasks[i].release    = 0;
+        g_tasks[i].deadlineMisses = 0;
+        g_tasks[i].overruns   = 0;
+        g_tasks[i].readySince = 0;
+        g_tasks[i].readyWaitMax = 0;
+        g_tasks[i].relDeadline = 0;
+        g_tasks[i].absDeadline = 0;
+        g_tasks[i].wcetCycles  = 0;
+        g_tasks[i].edfDemoted  = 0;
+        g_tasks[i].coLine     = 0;
+        g_tasks[i].name       = 0;
+#if OS_CFG_TASK_PROFILE
+        OS_ProfileClear(i);
+#endif
     }
+    for (int p = 0; p < OS_PRIO_LEVELS; ++p) {
+        g_readyHead[p] = OS_INVALID_TASK;
+        g_readyTail[p] = OS_INVALID_TASK;
+    }
+    for (int g = 0; g < OS_PRIO_GROUPS; ++g) {
+        g_readyTable[g] = 0;
+    }
+    g_readyGroup  = 0;
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    g_edfHead     = OS_INVALID_TASK;
+#endif
+    g_delayHead   = OS_INVALID_TASK;
+    g_wakeHead    = OS_INVALID_TASK;
+    g_wakeTail    = OS_INVALID_TASK;
     g_currentTask = OS_INVALID_TASK;
+    g_tickCount   = 0;
+    g_idleTicks   = 0;
+    g_inIdle      = 0;
+#if OS_CFG_AGING
+    g_lastAgingScan = 0;
+#endif
+
+#if OS_CFG_DEFER
+    // 队列中可能已有 OS_Init 之前投递的工作，保留，只重建处理任务
+    g_deferEvent.waitList = OS_INVALID_TASK;
+    OS_SetTaskName(OS_CreateTask(OS_DeferTask, 0, OS_CFG_DEFER_PRIO), "Defer");
+#endif
 }
 
-// 优先级数字越大，优先级越高
-int32_t OS_CreateTask(void (*entry)(void *),
-                      void *arg,
-                      uint8_t priority)
+// 分配并初始化 TCB，但不放入任何链表 (调用者负责临界区)
+static int32_t OS_TaskAlloc(void (*entry)(void *), void *arg, uint8_t priority)
 {
     int32_t id = OS_FindEmptySlot();
     if (id == OS_INVALID_TASK || entry == 0) {
@@ -65,17 +579,224 @@ int32_t OS_CreateTask(void (*entry)(void *),
     g_tasks[id].entry      = entry;
     g_tasks[id].arg        = arg;
     g_tasks[id].priority   = priority;
-    g_tasks[id].state      = OS_TASK_READY;
+    g_tasks[id].basePriority = priority;
     g_tasks[id].delayTicks = 0;
+    g_tasks[id].waitList   = 0;
+    g_tasks[id].waitNext   = OS_INVALID_TASK;
+    g_tasks[id].timeoutList = 0;
+    g_tasks[id].waitMask   = 0;
+    g_tasks[id].period     = 0;
+    g_tasks[id].release    = 0;
+    g_tasks[id].deadlineMisses = 0;
+    g_tasks[id].overruns   = 0;
+    g_tasks[id].readyWaitMax = 0;
+    g_tasks[id].relDeadline = 0;
+    g_tasks[id].absDeadline = 0;
+    g_tasks[id].wcetCycles  = 0;
+    g_tasks[id].edfDemoted  = 0;
+    g_tasks[id].coLine     = 0;
+    g_tasks[id].name       = 0;
+    g_tasks[id].state      = OS_TASK_SUSPENDED;     // 占住槽位，由调用者放入链表
+#if OS_CFG_TASK_PROFILE
+    OS_ProfileClear(id);
+#endif
+    return id;
+}
+
+// 优先级数字越大，优先级越高
+int32_t OS_CreateTask(void (*entry)(void *),
+                      void *arg,
+                      uint8_t priority)
+{
+    OS_CRITICAL_ALLOC();
+
+    OS_ENTER_CRITICAL();
+
+    int32_t id = OS_TaskAlloc(entry, arg, priority);
+    if (id != OS_INVALID_TASK) {
+        OS_ReadyInsert(id);
+    }
+
+    OS_EXIT_CRITICAL();
+    return id;
+}
+
+int32_t OS_CreatePeriodicTask(void (*entry)(void *), void *arg, uint8_t priority,
+                              uint32_t period, uint32_t phase)
+{
+    OS_CRITICAL_ALLOC();
+
+    if (period == 0) return OS_INVALID_TASK;
+
+    OS_ENTER_CRITICAL();
+
+    int32_t id = OS_TaskAlloc(entry, arg, priority);
+    if (id != OS_INVALID_TASK) {
+        g_tasks[id].period  = period;
+        g_tasks[id].release = g_tickCount + phase;
+        if (phase > 0) {
+            OS_DelayInsert(id, phase);
+        } else {
+            OS_ReadyInsert(id);
+        }
+    }
 
+    OS_EXIT_CRITICAL();
     return id;
 }
 
+// 单个任务的密度 WCET / min(D, T)，千分比 (调用者负责临界区)
+static uint32_t OS_TaskDensity(int32_t id, uint32_t deadline, uint32_t wcetCycles)
+{
+    uint32_t window = deadline;
+    if (g_tasks[id].period > 0 && g_tasks[id].period < window) {
+        window = g_tasks[id].period;
+    }
+    if (window == 0) return 0;
+
+    return (uint32_t)((uint64_t)wcetCycles * 1000U /
+                      ((uint64_t)window * OS_CYCLES_PER_TICK()));
+}
+
+// 除 skip 之外参与 EDF 调度的任务的总密度 (调用者负责临界区)
+static uint32_t OS_EdfDensity(int32_t skip)
+{
+    uint32_t density = 0;
+
+    for (int i = 0; i < OS_MAX_TASKS; ++i) {
+        if (i != skip && g_tasks[i].state != OS_TASK_UNUSED &&
+            g_tasks[i].relDeadline > 0 && !g_tasks[i].edfDemoted) {
+            density += OS_TaskDensity(i, g_tasks[i].relDeadline, g_tasks[i].wcetCycles);
+        }
+    }
+    return density;
+}
+
+uint32_t OS_GetDeadlineDensity(void)
+{
+    uint32_t density;
+    OS_CRITICAL_ALLOC();
+
+    OS_ENTER_CRITICAL();
+    density = OS_EdfDensity(OS_INVALID_TASK);
+    OS_EXIT_CRITICAL();
+    return density;
+}
+
+// 就绪中的任务可能要在位图和 EDF 链表之间迁移，先摘下、改参数再放回 (调用者负责临界区)
+static void OS_SetSchedParam(int32_t id, uint32_t deadline, uint8_t demoted)
+{
+    uint8_t ready = (g_tasks[id].state == OS_TASK_READY);
+    if (ready) OS_ReadyRemove(id);
+
+    g_tasks[id].relDeadline = deadline;
+    g_tasks[id].edfDemoted  = demoted;
+    g_tasks[id].absDeadline = (g_tasks[id].period > 0 ? g_tasks[id].release : g_tasks[id].readySince)
+                            + deadline;
+
+    if (ready) OS_ReadyInsert(id);
+}
+
+int32_t OS_SetTaskDeadline(int32_t id, uint32_t deadline, uint32_t wcetUs)
+{
+    OS_CRITICAL_ALLOC();
+
+    if (id < 0 || id >= OS_MAX_TASKS) return OS_ERR_PARAM;
+
+    // 声明值换算为 CPU 周期，与实测最大值取大
+    uint32_t wcet = (uint32_t)((uint64_t)wcetUs * OS_CYCLES_PER_TICK() / (1000U * OS_TICK_MS));
+
+    OS_ENTER_CRITICAL();
+
+    if (g_tasks[id].state == OS_TASK_UNUSED) {
+        OS_EXIT_CRITICAL();
+        return OS_ERR_PARAM;
+    }
+#if OS_CFG_TASK_PROFILE
+    if (g_tasks[id].cyclesMax > wcet) wcet = g_tasks[id].cyclesMax;
+#endif
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    // 准入：其余任务的密度 + 该任务按新参数的密度不超过上限
+    if (deadline > 0 &&
+        OS_EdfDensity(id) + OS_TaskDensity(id, deadline, wcet) > OS_CFG_EDF_ADMIT_PERMILLE) {
+        OS_EXIT_CRITICAL();
+        return OS_ERR_ADMIT;
+    }
+#endif
+
+    g_tasks[id].wcetCycles = wcet;
+    OS_SetSchedParam(id, deadline, 0);
+
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+}
+
+#if OS_CFG_TASK_PROFILE
+// 实测执行时间超过准入 WCET：更新 WCET，EDF 下按新值重新准入，超限则降级到固定优先级
+static void OS_WcetExceeded(int32_t id, uint32_t cycles)
+{
+    OS_CRITICAL_ALLOC();
+
+    OS_ENTER_CRITICAL();
+    g_tasks[id].wcetCycles = cycles;
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    if (OS_IN_EDF(id) &&
+        OS_EdfDensity(id) + OS_TaskDensity(id, g_tasks[id].relDeadline, cycles) > OS_CFG_EDF_ADMIT_PERMILLE) {
+        OS_SetSchedParam(id, g_tasks[id].relDeadline, 1);
+    }
+#endif
+    OS_EXIT_CRITICAL();
+}
+#endif
+
+// 周期任务执行完毕：计算下一次释放时刻并挂入延时链表 (调用者负责临界区)
+static void OS_PeriodicRearm(int32_t id)
+{
+    OS_TCB_t *t   = &g_tasks[id];
+    uint32_t  now = g_tickCount;
+    uint32_t  next = t->release + t->period;   // 下一次释放时刻
+    uint32_t  deadline = t->release + (t->relDeadline > 0 ? t->relDeadline : t->period);
+
+    // 完成时刻晚于截止时刻 (未声明时截止时刻即下一次释放)
+    if ((int32_t)(now - deadline) > 0) {
+        t->deadlineMisses++;
+    }
+
+    if ((int32_t)(now - next) > 0) {
+        // 整周期都已过去的释放不再补跑，保持原有相位
+        uint32_t skipped = (now - next) / t->period;
+        if (skipped > 0) {
+            t->overruns += skipped;
+            next += skipped * t->period;
+        }
+    }
+
+    t->release = next;
+    if ((int32_t)(next - now) > 0) {
+        OS_DelayInsert(id, next - now);
+    } else {
+        OS_ReadyInsert(id);     // 已到释放时刻，立即重新就绪
+    }
+}
+
 // 删除任务
 void OS_DeleteTask(int32_t id)
 {
+    OS_CRITICAL_ALLOC();
+
     if (id < 0 || id >= OS_MAX_TASKS) return;
 
+    OS_ENTER_CRITICAL();
+
+    if (g_tasks[id].state == OS_TASK_READY) {
+        OS_ReadyRemove(id);
+    } else if (g_tasks[id].state == OS_TASK_DELAYED) {
+        OS_DelayRemove(id);
+    } else if (g_tasks[id].state == OS_TASK_BLOCKED) {
+        OS_WaitCancel(id);
+    }
+
     g_tasks[id].state      = OS_TASK_UNUSED;
     g_tasks[id].entry      = 0;
     g_tasks[id].arg        = 0;
@@ -85,54 +806,93 @@ void OS_DeleteTask(int32_t id)
     if (g_currentTask == id) {
         g_currentTask = OS_INVALID_TASK;
     }
+
+    OS_EXIT_CRITICAL();
+}
+
+void OS_SetTaskName(int32_t id, const char *name)
+{
+    if (id < 0 || id >= OS_MAX_TASKS) return;
+    g_tasks[id].name = name;
 }
 
 // 挂起
 void OS_SuspendTask(int32_t id)
 {
+    OS_CRITICAL_ALLOC();
+
     if (id < 0 || id >= OS_MAX_TASKS) return;
-    if (g_tasks[id].state == OS_TASK_UNUSED) return;
 
-    // 不管是 READY / RUNNING / DELAYED，都可以直接挂起
+    OS_ENTER_CRITICAL();
+
+    if (g_tasks[id].state == OS_TASK_UNUSED) {
+        OS_EXIT_CRITICAL();
+        return;
+    }
+
+    // 不管是 READY / RUNNING / DELAYED / BLOCKED，都可以直接挂起
+    if (g_tasks[id].state == OS_TASK_READY) {
+        OS_ReadyRemove(id);
+    } else if (g_tasks[id].state == OS_TASK_DELAYED) {
+        OS_DelayRemove(id);
+    } else if (g_tasks[id].state == OS_TASK_BLOCKED) {
+        OS_WaitCancel(id);     // 恢复后重新执行，会再次发起等待
+    }
     g_tasks[id].state      = OS_TASK_SUSPENDED;
+    g_tasks[id].priority   = g_tasks[id].basePriority;   // 撤销老化提升
     g_tasks[id].delayTicks = 0;              // 防止残留延时，下次恢复时直接 READY
 
     if (g_currentTask == id) {
         g_currentTask = OS_INVALID_TASK;
     }
+
+    OS_EXIT_CRITICAL();
 }
 
 // 恢复
 void OS_ResumeTask(int32_t id)
 {
+    OS_CRITICAL_ALLOC();
+
     if (id < 0 || id >= OS_MAX_TASKS) return;
+
+    OS_ENTER_CRITICAL();
     if (g_tasks[id].state == OS_TASK_SUSPENDED) {
-        g_tasks[id].state = OS_TASK_READY;
+        g_tasks[id].release = g_tickCount;  // 周期任务从恢复时刻重新起算
+        OS_ReadyInsert(id);
     }
+    OS_EXIT_CRITICAL();
 }
 
 // 当前任务主动让出 CPU
 void OS_Yield(void)
 {
+    OS_CRITICAL_ALLOC();
+
     // 对于协同式调度，Yield 实际上只是为了改变状态，真正的让出是函数 return
     if (g_currentTask < 0 || g_currentTask >= OS_MAX_TASKS) return;
 
-    // 把自己改回 READY，让调度器有机会调度别人
+    // 把自己改回 READY (排到同优先级队尾)，让调度器有机会调度别人
+    OS_ENTER_CRITICAL();
     if (g_tasks[g_currentTask].state == OS_TASK_RUNNING) {
-        g_tasks[g_currentTask].state = OS_TASK_READY;
+        OS_ReadyInsert(g_currentTask);
         g_currentTask = OS_INVALID_TASK;
     }
+    OS_EXIT_CRITICAL();
 }
 
 // 非阻塞延时：让当前任务 N 个 tick 不再被调度
 void OS_DelayTicks(uint32_t ticks)
 {
+    OS_CRITICAL_ALLOC();
+
     if (ticks == 0) return;
     if (g_currentTask < 0 || g_currentTask >= OS_MAX_TASKS) return;
 
-    g_tasks[g_currentTask].delayTicks = ticks;
-    g_tasks[g_currentTask].state      = OS_TASK_DELAYED;
+    OS_ENTER_CRITICAL();
+    OS_DelayInsert(g_currentTask, ticks);
     g_currentTask = OS_INVALID_TASK;
+    OS_EXIT_CRITICAL();
 }
 
 void OS_DelayMs(uint32_t ms)
@@ -148,46 +908,469 @@ void OS_DelayMs(uint32_t ms)
 #endif
 }
 
+void OS_EventInit(OS_Event_t *ev)
+{
+    ev->flags    = 0;
+    ev->waitList = OS_INVALID_TASK;
+}
+
+// 置位事件：等待其中任一位的任务全部放回就绪链表，由它们各自取走标志
+void OS_EventSet(OS_Event_t *ev, uint32_t bits)
+{
+    OS_CRITICAL_ALLOC();
+
+    if (ev == 0 || bits == 0) return;
+
+    OS_ENTER_CRITICAL();
+
+    ev->flags |= bits;
+
+    int16_t id = ev->waitList;
+    while (id != OS_INVALID_TASK) {
+        int16_t next = g_tasks[id].waitNext;
+        if (g_tasks[id].waitMask & ev->flags) {
+            OS_WaitWake(id);
+        }
+        id = next;
+    }
+
+    OS_EXIT_CRITICAL();
+}
+
+int32_t OS_EventWait(OS_Event_t *ev, uint32_t mask, uint32_t timeout, uint32_t *bits)
+{
+    OS_CRITICAL_ALLOC();
+    int32_t ret;
+
+    if (ev == 0 || mask == 0) return OS_ERR_PARAM;
+
+    OS_ENTER_CRITICAL();
+
+    uint32_t got = ev->flags & mask;
+    if (got != 0) {
+        ev->flags &= ~got;
+        OS_WaitDone();
+        ret = OS_OK;
+    } else {
+        if (g_currentTask >= 0 && g_currentTask < OS_MAX_TASKS) {
+            g_tasks[g_currentTask].waitMask = mask;
+        }
+        ret = OS_WaitBlock(&ev->waitList, timeout);
+    }
+
+    OS_EXIT_CRITICAL();
+
+    if (bits) *bits = got;
+    return ret;
+}
+
+void OS_QueueInit(OS_Queue_t *q, void *buf, uint16_t msgSize, uint16_t capacity)
+{
+    q->buf      = (uint8_t *)buf;
+    q->msgSize  = msgSize;
+    q->capacity = capacity;
+    q->head     = 0;
+    q->count    = 0;
+    q->waitList = OS_INVALID_TASK;
+}
+
+// 发送：拷贝到队尾，唤醒最早等待的一个接收者
+int32_t OS_QueueSend(OS_Queue_t *q, const void *msg)
+{
+    OS_CRITICAL_ALLOC();
+
+    if (q == 0 || msg == 0) return OS_ERR_PARAM;
+
+    OS_ENTER_CRITICAL();
+
+    if (q->count >= q->capacity) {
+        OS_EXIT_CRITICAL();
+        return OS_ERR_FULL;
+    }
+
+    uint16_t tail = (uint16_t)((q->head + q->count) % q->capacity);
+    memcpy(&q->buf[(uint32_t)tail * q->msgSize], msg, q->msgSize);
+    q->count++;
+
+    if (q->waitList != OS_INVALID_TASK) {
+        OS_WaitWake(q->waitList);
+    }
+
+    OS_EXIT_CRITICAL();
+    return OS_OK;
+}
+
+int32_t OS_QueueReceive(OS_Queue_t *q, void *msg, uint32_t timeout)
+{
+    OS_CRITICAL_ALLOC();
+    int32_t ret;
+
+    if (q == 0 || msg == 0) return OS_ERR_PARAM;
+
+    OS_ENTER_CRITICAL();
+
+    if (q->count > 0) {
+        memcpy(msg, &q->buf[(uint32_t)q->head * q->msgSize], q->msgSize);
+        q->head = (uint16_t)((q->head + 1U) % q->capacity);
+        q->count--;
+        OS_WaitDone();
+        ret = OS_OK;
+    } else {
+        ret = OS_WaitBlock(&q->waitList, timeout);
+    }
+
+    OS_EXIT_CRITICAL();
+    return ret;
+}
+
+#if OS_CFG_DEFER
+int32_t OS_DeferPost(void (*fn)(void *), void *arg)
+{
+    OS_DeferItem_t *item;
+
+    if (fn == 0) return OS_ERR_PARAM;
+
+    item = (OS_DeferItem_t *)OS_Ring_WriteSlot(&g_deferRing);
+    if (item == 0) {
+        g_deferDropped++;
+        return OS_ERR_FULL;
+    }
+    item->fn    = fn;
+    item->arg   = arg;
+    item->stamp = OS_CYCLE_COUNT();
+    OS_Ring_WriteCommit(&g_deferRing);
+
+    OS_EventSet(&g_deferEvent, 0x01U);
+    return OS_OK;
+}
+
+// 延后处理任务：取空队列后阻塞在事件上
+static void OS_DeferTask(void *arg)
+{
+    OS_DeferItem_t item;
+
+    (void)arg;
+
+    do {
+        // 先拷出条目、释放槽位再执行，工作函数里可以再次投递
+        while (OS_Ring_Pop(&g_deferRing, &item) == OS_OK) {
+            uint32_t latency = OS_CYCLE_COUNT() - item.stamp;
+            if (latency > g_deferMaxLatency) {
+                g_deferMaxLatency = latency;
+            }
+            item.fn(item.arg);
+        }
+        // 检查为空之后才投递的工作会留下事件标志，Wait 直接返回 OK 再取一轮
+    } while (OS_EventWait(&g_deferEvent, 0x01U, OS_WAIT_FOREVER, 0) == OS_OK);
+}
+
+void OS_GetDeferStats(uint32_t *dropped, uint32_t *maxLatency)
+{
+    if (dropped)    *dropped    = g_deferDropped;
+    if (maxLatency) *maxLatency = g_deferMaxLatency;
+}
+#else
+int32_t OS_DeferPost(void (*fn)(void *), void *arg)
+{
+    // 未使能延后队列：直接在调用者上下文执行
+    if (fn == 0) return OS_ERR_PARAM;
+    fn(arg);
+    return OS_OK;
+}
+
+void OS_GetDeferStats(uint32_t *dropped, uint32_t *maxLatency)
+{
+    if (dropped)    *dropped    = 0;
+    if (maxLatency) *maxLatency = 0;
+}
+#endif
+
 // 时基：在定时器中断里调用
 void OS_Tick(void)
 {
-    // 扫描所有 DELAYED 任务，做倒计时
-    for (int i = 0; i < OS_MAX_TASKS; ++i) {
-        if (g_tasks[i].state == OS_TASK_DELAYED && g_tasks[i].delayTicks > 0) {
-            g_tasks[i].delayTicks--;
-            if (g_tasks[i].delayTicks == 0) {
-                g_tasks[i].state = OS_TASK_READY;
-            }
+    OS_CRITICAL_ALLOC();
+#if OS_CFG_TICK_PROFILE
+    uint32_t start = OS_CYCLE_COUNT();
+#endif
+
+    OS_ENTER_CRITICAL();
+
+    g_tickCount++;
+    if (g_inIdle) {
+        g_idleTicks++;
+    }
+
+    // 只递减表头；差值减到 0 时整串移到待唤醒链表，由线程态唤醒
+    if (g_delayHead != OS_INVALID_TASK) {
+        g_tasks[g_delayHead].delayTicks--;
+
+        if (g_tasks[g_delayHead].delayTicks == 0) {
+            OS_DelayDetachRun();
+        }
+    }
+
+    OS_EXIT_CRITICAL();
+
+#if OS_CFG_TICK_PROFILE
+    uint32_t cycles = OS_CYCLE_COUNT() - start;
+    if (cycles > g_tickMaxCycles) {
+        g_tickMaxCycles = cycles;
+    }
+#endif
+}
+
+// 补记 ticks 个 tick：沿差分链表消耗，到期的各串移到待唤醒链表
+void OS_TickAdvance(uint32_t ticks)
+{
+    OS_CRITICAL_ALLOC();
+
+    OS_ENTER_CRITICAL();
+
+    g_tickCount += ticks;
+    if (g_inIdle) {
+        g_idleTicks += ticks;
+    }
+
+    while (ticks > 0 && g_delayHead != OS_INVALID_TASK) {
+        if (ticks < g_tasks[g_delayHead].delayTicks) {
+            g_tasks[g_delayHead].delayTicks -= ticks;
+            break;
         }
+
+        ticks -= g_tasks[g_delayHead].delayTicks;
+        g_tasks[g_delayHead].delayTicks = 0;
+        OS_DelayDetachRun();
+    }
+
+    OS_EXIT_CRITICAL();
+}
+
+uint32_t OS_GetNextWakeupTicks(void)
+{
+    int16_t head = g_delayHead;
+    if (g_wakeHead != OS_INVALID_TASK) return 0;
+    return (head != OS_INVALID_TASK) ? g_tasks[head].delayTicks : OS_WAIT_FOREVER;
+}
+
+uint32_t OS_GetTickCount(void)
+{
+    return g_tickCount;
+}
+
+uint32_t OS_GetIdleTicks(void)
+{
+    return g_idleTicks;
+}
+
+int32_t OS_GetTaskStats(int32_t id, OS_TaskStats_t *stats)
+{
+    if (id < 0 || id >= OS_MAX_TASKS || stats == 0) return -1;
+    if (g_tasks[id].state == OS_TASK_UNUSED) return -1;
+
+    stats->name     = g_tasks[id].name;
+    stats->priority = g_tasks[id].basePriority;
+    stats->state    = g_tasks[id].state;
+#if OS_CFG_TASK_PROFILE
+    stats->runCount    = g_tasks[id].runCount;
+    stats->cyclesMin   = (g_tasks[id].runCount > 0) ? g_tasks[id].cyclesMin : 0;
+    stats->cyclesMax   = g_tasks[id].cyclesMax;
+    stats->cyclesTotal = g_tasks[id].cyclesTotal;
+    stats->cyclesMean  = (g_tasks[id].runCount > 0)
+                       ? (uint32_t)(g_tasks[id].cyclesTotal / g_tasks[id].runCount) : 0;
+#else
+    stats->runCount    = 0;
+    stats->cyclesMin   = 0;
+    stats->cyclesMax   = 0;
+    stats->cyclesTotal = 0;
+    stats->cyclesMean  = 0;
+#endif
+    stats->period         = g_tasks[id].period;
+    stats->deadlineMisses = g_tasks[id].deadlineMisses;
+    stats->overruns       = g_tasks[id].overruns;
+    stats->readyWaitMax   = g_tasks[id].readyWaitMax;
+    stats->relDeadline    = g_tasks[id].relDeadline;
+    stats->wcetCycles     = g_tasks[id].wcetCycles;
+    stats->edfDemoted     = g_tasks[id].edfDemoted;
+    return 0;
+}
+
+void OS_ResetTaskStats(void)
+{
+#if OS_CFG_DEFER
+    g_deferMaxLatency = 0;
+#endif
+#if OS_CFG_TASK_PROFILE
+    for (int i = 0; i < OS_MAX_TASKS; ++i) {
+        OS_ProfileClear(i);
+    }
+#endif
+    for (int i = 0; i < OS_MAX_TASKS; ++i) {
+        g_tasks[i].deadlineMisses = 0;
+        g_tasks[i].overruns       = 0;
+        g_tasks[i].readyWaitMax   = 0;
+    }
+}
+
+void OS_PrintTaskStats(void)
+{
+    OS_TaskStats_t st;
+
+    printf("[OS] id prio name         runs      min      max     mean (cycles) period  dl     wcet miss ovr wait\r\n");
+    for (int i = 0; i < OS_MAX_TASKS; ++i) {
+        if (OS_GetTaskStats(i, &st) != 0) continue;
+        printf("[OS] %2d %4u %-10s %8lu %8lu %8lu %8lu %6lu %3lu%c %8lu %4lu %3lu %4lu\r\n",
+               i, st.priority, st.name ? st.name : "-",
+               (unsigned long)st.runCount, (unsigned long)st.cyclesMin,
+               (unsigned long)st.cyclesMax, (unsigned long)st.cyclesMean,
+               (unsigned long)st.period, (unsigned long)st.relDeadline,
+               st.edfDemoted ? '*' : ' ', (unsigned long)st.wcetCycles,
+               (unsigned long)st.deadlineMisses,
+               (unsigned long)st.overruns, (unsigned long)st.readyWaitMax);
     }
+    printf("[OS] ticks=%lu idle=%lu tickMax=%lu cycles density=%lu permille\r\n",
+           (unsigned long)OS_GetTickCount(), (unsigned long)OS_GetIdleTicks(),
+           (unsigned long)OS_GetTickMaxCycles(0), (unsigned long)OS_GetDeadlineDensity());
+
+    uint32_t dropped, latency;
+    OS_GetDeferStats(&dropped, &latency);
+    printf("[OS] defer dropped=%lu maxLatency=%lu cycles\r\n",
+           (unsigned long)dropped, (unsigned long)latency);
+}
+
+uint32_t OS_GetTickMaxCycles(uint8_t reset)
+{
+#if OS_CFG_TICK_PROFILE
+    uint32_t cycles = g_tickMaxCycles;
+    if (reset) {
+        g_tickMaxCycles = 0;
+    }
+    return cycles;
+#else
+    (void)reset;
+    return 0;
+#endif
+}
+
+// 协程断点保存在当前任务的 TCB 中；不在任务上下文时返回一个丢弃用的变量
+uint16_t *OS_CoState(void)
+{
+    static uint16_t dummy;
+
+    if (g_currentTask < 0 || g_currentTask >= OS_MAX_TASKS) {
+        dummy = 0;
+        return &dummy;
+    }
+    return &g_tasks[g_currentTask].coLine;
 }
 
 // 调度一次：选任务 → 调用其函数一次
 void OS_ScheduleOnce(void)
 {
+    OS_CRITICAL_ALLOC();
+
+    OS_WakePending();
+
+    OS_ENTER_CRITICAL();
+
+#if OS_CFG_AGING
+    if (g_tickCount - g_lastAgingScan >= OS_CFG_AGING_SCAN_TICKS) {
+        g_lastAgingScan = g_tickCount;
+        OS_AgingScan();
+    }
+#endif
+
     int32_t next = OS_SelectNextTask();
     if (next == OS_INVALID_TASK) {
         // 没有 READY 任务，啥也不干（可以在这里挂个 idle 任务）
+        OS_EXIT_CRITICAL();
         return;
     }
 
+    OS_ReadyRemove(next);
+    g_tasks[next].priority = g_tasks[next].basePriority;    // 被调度后撤销老化提升
+    uint32_t wait = g_tickCount - g_tasks[next].readySince;
+    if (wait > g_tasks[next].readyWaitMax) {
+        g_tasks[next].readyWaitMax = wait;
+    }
     g_currentTask = next;
     g_tasks[next].state = OS_TASK_RUNNING;
+    g_inIdle = 0;
+
+    OS_EXIT_CRITICAL();
 
     // 调用任务函数：任务内部不要写 while(1)，只做一步逻辑就 return
     if (g_tasks[next].entry) {
+#if OS_CFG_TASK_PROFILE
+        uint32_t start = OS_CYCLE_COUNT();
+        g_tasks[next].entry(g_tasks[next].arg);
+        uint32_t cycles = OS_CYCLE_COUNT() - start;
+
+        // 任务可能在执行中删除了自己，槽位已空就不再记账
+        if (g_tasks[next].state != OS_TASK_UNUSED) {
+            g_tasks[next].runCount++;
+            g_tasks[next].cyclesTotal += cycles;
+            if (cycles < g_tasks[next].cyclesMin) g_tasks[next].cyclesMin = cycles;
+            if (cycles > g_tasks[next].cyclesMax) g_tasks[next].cyclesMax = cycles;
+            if (cycles > g_tasks[next].wcetCycles && g_tasks[next].relDeadline > 0) {
+                OS_WcetExceeded(next, cycles);
+            }
+        }
+#else
         g_tasks[next].entry(g_tasks[next].arg);
+#endif
+    }
+
+    // 如果任务没自己改状态（比如延时/挂起/删除），默认跑完一次回到 READY (同优先级队尾)
+    // 周期任务则按绝对时刻等待下一次释放
+    OS_ENTER_CRITICAL();
+
+    // 非周期任务的作业在函数返回时完成，晚于截止时刻计一次错过 (周期任务在重新定时时统计)
+    if (g_tasks[next].state != OS_TASK_UNUSED && g_tasks[next].period == 0 &&
+        g_tasks[next].relDeadline > 0 &&
+        (int32_t)(g_tickCount - g_tasks[next].absDeadline) > 0) {
+        g_tasks[next].deadlineMisses++;
     }
 
-    // 如果任务没自己改状态（比如延时/挂起/删除），默认跑完一次回到 READY
     if (g_currentTask == next &&
         g_tasks[next].state == OS_TASK_RUNNING) {
-        g_tasks[next].state = OS_TASK_READY;
+        if (g_tasks[next].period > 0) {
+            OS_PeriodicRearm(next);
+        } else {
+            OS_ReadyInsert(next);
+        }
         g_currentTask = OS_INVALID_TASK;
     } else {
         // 任务在内部可能调用了 Delay/Suspend/Delete 等，我们尊重它的状态
         // g_currentTask 已经被修改为 OS_INVALID_TASK 或其他值
     }
+    OS_EXIT_CRITICAL();
+}
+
+// 空闲处理：屏蔽中断后再确认一次没有就绪任务，然后睡到最近的唤醒时刻
+static void OS_Idle(void)
+{
+    OS_CRITICAL_ALLOC();
+
+    OS_WakePending();
+
+    OS_ENTER_CRITICAL();
+
+    if (OS_NO_READY_TASK()) {
+        g_inIdle = 1;
+
+        uint32_t expected = OS_GetNextWakeupTicks();
+#if OS_CFG_TICKLESS_IDLE
+        uint32_t missed = OS_PortSleep(expected);
+        if (missed > 0) {
+            OS_TickAdvance(missed);
+        }
+#else
+        (void)OS_PortSleep(0);  // 只等下一个中断 (最迟下一个 tick)
+        (void)expected;
+#endif
+    }
+
+    OS_EXIT_CRITICAL();     // 唤醒我们的中断在这里得到执行
 }
 
 // 启动调度器：死循环调度
@@ -195,6 +1378,10 @@ void OS_Start(void)
 {
     while (1) {
         OS_ScheduleOnce();
-        // 这里也可以插 Idle 行为，比如省电 / 喂狗 等
+
+        // 没有就绪任务时进入空闲睡眠，而不是空转
+        if (OS_NO_READY_TASK()) {
+            OS_Idle();
+        }
     }
 }
@@ -10,8 +10,54 @@
 #include <stdint.h>
 
 /* 配置项 */
-#define OS_MAX_TASKS    8       // 最大任务数
+#ifndef OS_MAX_TASKS
+#define OS_MAX_TASKS    32      // 最大任务数 (不超过 32767)
+#endif
 #define OS_TICK_MS      1       // 调度器时基 (ms)
+#define OS_PRIO_LEVELS  256     // 优先级级数 (与 uint8_t 优先级一一对应)
+#define OS_CFG_TICK_PROFILE 1   // 1: 用 DWT 记录 OS_Tick 最坏耗时 (周期数)
+#define OS_CFG_TICKLESS_IDLE 1  // 1: 空闲时停掉 SysTick 一直睡到最近的唤醒时刻
+#define OS_CFG_TICKLESS_MIN_TICKS 2 // 预计空闲少于该 tick 数时只做普通 WFI
+#define OS_CFG_TASK_PROFILE 1   // 1: 用 DWT 统计每个任务单次执行的周期数
+#ifndef OS_CFG_AGING
+#define OS_CFG_AGING        1   // 1: 就绪等待过久的任务临时提升到当前最高就绪优先级
+#endif
+#define OS_CFG_AGING_TICKS  100 // 就绪等待超过该 tick 数即提升
+#define OS_CFG_AGING_SCAN_TICKS 10 // 老化扫描间隔 (tick)
+
+/* 调度策略 (编译期选择) */
+#define OS_SCHED_FIXED_PRIO 0   // 固定优先级 (同级 FIFO 轮转)
+#define OS_SCHED_EDF        1   // 最早截止时刻优先：声明了截止时刻的任务按绝对截止时刻调度，
+                                // 优先于未声明的任务；未声明的任务仍按固定优先级在其后调度，
+                                // 但优先级不低于 OS_CFG_DEFER_PRIO 的任务 (中断下半部) 先于 EDF 任务
+#ifndef OS_CFG_SCHED_POLICY
+#define OS_CFG_SCHED_POLICY OS_SCHED_FIXED_PRIO
+#endif
+#ifndef OS_CFG_EDF_ADMIT_PERMILLE
+#define OS_CFG_EDF_ADMIT_PERMILLE 1000  // EDF 准入上限：总密度 (WCET / min(D,T)) 千分比
+#endif
+
+#define OS_CFG_DEFER        1   // 1: 提供中断延后处理队列 (下半部)，由最高优先级任务执行
+#define OS_CFG_DEFER_DEPTH  16  // 延后工作队列深度 (必须为 2 的幂)
+#define OS_CFG_DEFER_PRIO   255 // 延后处理任务优先级
+
+/* 移植层：默认使用 CMSIS 内核接口；在主机上编译时可预先定义以下宏 */
+#ifndef OS_ENTER_CRITICAL
+#include "main.h"
+/* 临界区：保存并恢复 PRIMASK，可在任务和中断中嵌套使用
+ * 用法：函数开头 OS_CRITICAL_ALLOC()，之后成对使用 ENTER/EXIT */
+#define OS_CRITICAL_ALLOC()     uint32_t os_primask = 0
+#define OS_ENTER_CRITICAL()     do { os_primask = __get_PRIMASK(); __disable_irq(); } while (0)
+#define OS_EXIT_CRITICAL()      __set_PRIMASK(os_primask)
+/* 前导零计数 (Cortex-M4 单条 CLZ 指令) */
+#define OS_CLZ(x)               __CLZ(x)
+/* CPU 周期计数 (需先调用 delay_init() 使能 DWT) */
+#define OS_CYCLE_COUNT()        (DWT->CYCCNT)
+/* 每个 tick 的 CPU 周期数 (用于 WCET 与截止时刻换算) */
+#define OS_CYCLES_PER_TICK()    (SystemCoreClock / 1000U * OS_TICK_MS)
+/* 内存屏障：无锁队列发布数据前保证写入顺序 */
+#define OS_MEMORY_BARRIER()     __DMB()
+#endif
 
 /* 任务状态枚举 */
 typedef enum {
@@ -19,21 +65,96 @@ typedef enum {
     OS_TASK_READY,
     OS_TASK_RUNNING,
     OS_TASK_SUSPENDED,
-    OS_TASK_DELAYED
+    OS_TASK_DELAYED,
+    OS_TASK_BLOCKED             // 等待事件标志 / 消息队列 (可带超时)
 } OS_TaskState_t;
 
 /* 任务控制块 (TCB) */
 typedef struct {
     void (*entry)(void *arg);   // 任务函数指针
     void           *arg;        // 任务参数
-    uint8_t         priority;   // 优先级 (数值越大越高)
+    uint8_t         priority;   // 当前 (有效) 优先级，老化时可能临时高于基础优先级
+    uint8_t         basePriority; // 创建时指定的基础优先级 (数值越大越高)
     OS_TaskState_t  state;      // 当前状态
-    uint32_t        delayTicks; // 延时计数器
+    uint32_t        delayTicks; // 延时差分值 (相对延时链表中前一个任务的 tick 数)
+    int16_t         readyNext;  // 同优先级就绪链表：后继任务 ID
+    int16_t         readyPrev;  // 同优先级就绪链表：前驱任务 ID
+    int16_t         delayNext;  // 延时差分链表：后继任务 ID
+    int16_t         delayPrev;  // 延时差分链表：前驱任务 ID
+    int16_t         delayLast;  // 延时差分链表：唤醒时刻相同的一串任务，串首指向串尾、串尾指向串首
+    int16_t        *waitList;   // 正在等待的对象的等待链表表头 (未等待时为空)
+    int16_t         waitNext;   // 等待链表：后继任务 ID
+    int16_t        *timeoutList;// 上一次因超时而放弃的等待对象 (供下次等待返回超时)
+    uint32_t        waitMask;   // 等待的事件标志位
+    uint32_t        period;     // 周期 (tick)，0 表示非周期任务
+    uint32_t        release;    // 本次释放的绝对时刻 (tick)，截止时刻为 release + period
+    uint32_t        deadlineMisses; // 完成时已超过截止时刻的次数
+    uint32_t        overruns;   // 因上一次执行过长而整体跳过的释放次数
+    uint32_t        readySince; // 最近一次进入就绪链表的时刻 (tick)；延时期间为唤醒时刻
+    uint32_t        readyWaitMax; // 从就绪到被调度的最长等待 (tick)
+    uint32_t        relDeadline;  // 相对截止时刻 (tick)，0 表示未声明
+    uint32_t        absDeadline;  // 当前作业的绝对截止时刻 (tick)
+    uint32_t        wcetCycles;   // 准入使用的 WCET (声明值与实测最大值取大，CPU 周期)
+    uint8_t         edfDemoted;   // 1: 实测 WCET 使准入失败，降级为按固定优先级调度
+    uint16_t        coLine;     // 协程断点 (OS_CO_* 宏记录的 __LINE__，0 表示从头开始)
+    const char     *name;       // 任务名 (用于统计显示，可为空)
+#if OS_CFG_TASK_PROFILE
+    uint32_t        runCount;   // 执行次数
+    uint32_t        cyclesMin;  // 单次执行最少周期数
+    uint32_t        cyclesMax;  // 单次执行最多周期数
+    uint64_t        cyclesTotal;// 累计执行周期数
+#endif
 } OS_TCB_t;
 
+/* 任务执行统计 (OS_GetTaskStats 输出) */
+typedef struct {
+    const char     *name;       // 任务名
+    uint8_t         priority;   // 优先级
+    OS_TaskState_t  state;      // 当前状态
+    uint32_t        runCount;   // 执行次数
+    uint32_t        cyclesMin;  // 单次最少周期数
+    uint32_t        cyclesMax;  // 单次最多周期数
+    uint32_t        cyclesMean; // 单次平均周期数
+    uint64_t        cyclesTotal;// 累计周期数
+    uint32_t        period;     // 周期 (tick)，0 表示非周期任务
+    uint32_t        deadlineMisses; // 错过截止时刻次数
+    uint32_t        overruns;   // 跳过的释放次数
+    uint32_t        readyWaitMax; // 最长就绪等待 (tick)
+    uint32_t        relDeadline;  // 相对截止时刻 (tick)，0 表示未声明
+    uint32_t        wcetCycles;   // 准入使用的 WCET (CPU 周期)
+    uint8_t         edfDemoted;   // 1: 已从 EDF 降级
+} OS_TaskStats_t;
+
 /* 宏定义无效任务 ID */
 #define OS_INVALID_TASK (-1)
 
+/* 无限等待 / 没有待唤醒任务 */
+#define OS_WAIT_FOREVER 0xFFFFFFFFUL
+
+/* 事件 / 队列接口返回值 */
+#define OS_OK            0      // 成功
+#define OS_PENDING       1      // 条件未满足，当前任务已进入阻塞，应立即 return
+#define OS_ERR_PARAM    (-1)    // 参数错误或不在任务上下文
+#define OS_ERR_TIMEOUT  (-2)    // 等待超时 (或超时为 0 时条件不满足)
+#define OS_ERR_FULL     (-3)    // 队列已满
+#define OS_ERR_ADMIT    (-4)    // EDF 准入检查失败
+
+/* 事件标志组 (32 位) */
+typedef struct {
+    volatile uint32_t flags;    // 已置位的事件
+    int16_t           waitList; // 等待任务链表表头
+} OS_Event_t;
+
+/* 定长消息队列 (环形缓冲区由调用者提供) */
+typedef struct {
+    uint8_t          *buf;      // 存储区：capacity * msgSize 字节
+    uint16_t          msgSize;  // 单条消息字节数
+    uint16_t          capacity; // 最多容纳的消息条数
+    uint16_t          head;     // 读位置
+    volatile uint16_t count;    // 当前消息条数
+    int16_t           waitList; // 等待接收的任务链表表头
+} OS_Queue_t;
+
 /* API 函数声明 */
 
 /**
@@ -50,12 +171,54 @@ void OS_Init(void);
  */
 int32_t OS_CreateTask(void (*entry)(void *), void *arg, uint8_t priority);
 
+/**
+ * @brief 创建周期任务 (按绝对释放时刻调度，周期不随执行时间漂移)
+ * @param entry    任务入口函数 (执行一次后返回，不要再调用 OS_DelayMs 重新定时)
+ * @param arg      传递给任务的参数
+ * @param priority 任务优先级 (0-255，越大越高)
+ * @param period   周期 (tick)，截止时刻为下一次释放时刻
+ * @param phase    首次释放相对当前时刻的偏移 (tick)
+ * @return 任务 ID，失败返回 OS_INVALID_TASK
+ * @note  每次执行完成后按 release += period 计算下一次释放；完成时已过截止
+ *        时刻计一次 deadline miss，整周期都被错过的释放直接跳过并计入 overrun
+ */
+int32_t OS_CreatePeriodicTask(void (*entry)(void *), void *arg, uint8_t priority,
+                              uint32_t period, uint32_t phase);
+
+/**
+ * @brief 声明任务的相对截止时刻与最坏执行时间
+ * @param id       任务 ID
+ * @param deadline 相对截止时刻 (tick)；作业从就绪 (周期任务从释放) 起算，0 表示取消
+ * @param wcetUs   声明的单次最坏执行时间 (us)
+ * @return OS_OK；EDF 策略下加入该任务后总密度超过 OS_CFG_EDF_ADMIT_PERMILLE
+ *         时返回 OS_ERR_ADMIT 且不修改原设置；OS_ERR_PARAM 任务无效
+ * @note  - 准入 WCET 取声明值与实测最大值 (cyclesMax) 中的较大者，
+ *          事件驱动任务以 deadline 作为最小到达间隔
+ *        - 之后实测执行时间超过准入 WCET 时按新值重新检查，超限的任务降级为按
+ *          固定优先级调度 (edfDemoted)，再次调用本函数通过准入后恢复
+ *        - 两种策略下都会统计截止时刻错过次数
+ */
+int32_t OS_SetTaskDeadline(int32_t id, uint32_t deadline, uint32_t wcetUs);
+
+/**
+ * @brief 计算参与 EDF 调度的任务的总密度 Σ WCET / min(D, T)
+ * @return 千分比 (1000 表示 100%)
+ */
+uint32_t OS_GetDeadlineDensity(void);
+
 /**
  * @brief 删除任务
  * @param id 任务 ID
  */
 void OS_DeleteTask(int32_t id);
 
+/**
+ * @brief 设置任务名 (仅保存指针，字符串需长期有效)
+ * @param id   任务 ID
+ * @param name 任务名
+ */
+void OS_SetTaskName(int32_t id, const char *name);
+
 /**
  * @brief 挂起任务
  * @param id 任务 ID
@@ -85,11 +248,107 @@ void OS_DelayMs(uint32_t ms);
  */
 void OS_DelayTicks(uint32_t ticks);
 
+/**
+ * @brief 初始化事件标志组
+ */
+void OS_EventInit(OS_Event_t *ev);
+
+/**
+ * @brief 置位事件标志，唤醒所有等待其中任一位的任务 (可在中断中调用)
+ * @param ev   事件标志组
+ * @param bits 要置位的标志
+ */
+void OS_EventSet(OS_Event_t *ev, uint32_t bits);
+
+/**
+ * @brief 等待事件标志 (任一位满足即返回，并清除取走的位)
+ * @param ev      事件标志组
+ * @param mask    关心的标志位
+ * @param timeout 超时 tick 数；0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @param bits    输出取走的标志 (可为空)
+ * @return OS_OK / OS_PENDING / OS_ERR_TIMEOUT / OS_ERR_PARAM
+ * @note  协同式调度下任务不能原地阻塞：返回 OS_PENDING 时当前任务已挂到
+ *        事件上，任务函数应直接 return，被唤醒后会再次从头执行
+ */
+int32_t OS_EventWait(OS_Event_t *ev, uint32_t mask, uint32_t timeout, uint32_t *bits);
+
+/**
+ * @brief 初始化消息队列
+ * @param q        队列
+ * @param buf      存储区，至少 msgSize * capacity 字节
+ * @param msgSize  单条消息字节数
+ * @param capacity 消息条数
+ */
+void OS_QueueInit(OS_Queue_t *q, void *buf, uint16_t msgSize, uint16_t capacity);
+
+/**
+ * @brief 发送一条消息 (拷贝进队列，不阻塞，可在中断中调用)
+ * @return OS_OK / OS_ERR_FULL / OS_ERR_PARAM
+ */
+int32_t OS_QueueSend(OS_Queue_t *q, const void *msg);
+
+/**
+ * @brief 接收一条消息
+ * @param q       队列
+ * @param msg     输出缓冲区，至少 msgSize 字节
+ * @param timeout 超时 tick 数；0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return OS_OK / OS_PENDING / OS_ERR_TIMEOUT / OS_ERR_PARAM (OS_PENDING 的含义同 OS_EventWait)
+ */
+int32_t OS_QueueReceive(OS_Queue_t *q, void *msg, uint32_t timeout);
+
 /**
  * @brief OS 时基心跳，需要在定时器中断中调用
  */
 void OS_Tick(void);
 
+/**
+ * @brief 一次性补偿多个 tick (低功耗睡眠期间被抑制的 tick)
+ * @param ticks 需要补记的 tick 数，效果等同于连续调用 ticks 次 OS_Tick
+ */
+void OS_TickAdvance(uint32_t ticks);
+
+/**
+ * @brief 距离最近一个延时任务唤醒还剩多少 tick
+ * @return tick 数；没有延时任务时返回 OS_WAIT_FOREVER
+ */
+uint32_t OS_GetNextWakeupTicks(void);
+
+/**
+ * @brief 获取系统启动以来的 tick 计数 (含睡眠补偿)
+ */
+uint32_t OS_GetTickCount(void);
+
+/**
+ * @brief 获取累计空闲 tick 数 (CPU 处于空闲/睡眠状态的时间)
+ */
+uint32_t OS_GetIdleTicks(void);
+
+/**
+ * @brief 获取 OS_Tick 的最坏执行耗时 (CPU 周期，需 OS_CFG_TICK_PROFILE)
+ * @param reset 非 0 时读取后清零，用于重新统计
+ * @return 自上次清零以来的最大周期数
+ */
+uint32_t OS_GetTickMaxCycles(uint8_t reset);
+
+/**
+ * @brief 读取任务执行统计 (需 OS_CFG_TASK_PROFILE，并已调用 delay_init 使能 DWT)
+ * @param id    任务 ID
+ * @param stats 输出统计数据
+ * @return 0 成功；-1 任务 ID 无效或未使用
+ */
+int32_t OS_GetTaskStats(int32_t id, OS_TaskStats_t *stats);
+
+/**
+ * @brief 清零所有任务的执行统计
+ */
+void OS_ResetTaskStats(void);
+
+/**
+ * @brief 通过 printf 打印所有任务的执行统计
+ * @note  dl 后的 * 表示该任务已从 EDF 降级，wcet 为准入使用的 WCET (周期)
+ */
+void OS_PrintTaskStats(void);
+
 /**
  * @brief 启动调度器 (死循环，不会返回)
  */
@@ -100,4 +359,88 @@ void OS_Start(void);
  */
 void OS_ScheduleOnce(void);
 
+/**
+ * @brief 获取当前任务的协程断点变量 (供 OS_CO_* 宏使用)
+ */
+uint16_t *OS_CoState(void);
+
+/* 无栈协程 ------------------------------------------------------------------
+ * 任务函数仍是"执行一步就 return"，但可以写成顺序流程，在等待点自动返回，
+ * 下次被调度时从断点继续 (protothread 方式，断点保存在 TCB 中)。
+ *
+ *   static void Task_X(void *arg)
+ *   {
+ *       OS_CO_BEGIN();
+ *       Step1();
+ *       OS_CO_DELAY(100);             // 100ms 后从下一行继续
+ *       OS_CO_AWAIT(IsDone());        // 条件不满足时返回，下次再检查
+ *       OS_CO_WAIT_EVENT(&ev, 0x01, NULL); // 阻塞到事件置位
+ *       Step2();
+ *       OS_CO_END();                  // 下次从头开始
+ *   }
+ *
+ * 限制：
+ *   - 局部变量在断点之间不保留，需要跨步保存的状态用 static 或 arg
+ *   - OS_CO_BEGIN 与 OS_CO_END 之间不能再使用 switch 语句
+ *   - 同一行只能放一个 OS_CO_* 宏
+ *   - 周期任务中 OS_CO_YIELD / OS_CO_AWAIT 返回后等待下一个周期再继续；
+ *     非周期任务则立即重新就绪 (OS_CO_AWAIT 相当于按优先级轮询)
+ */
+#define OS_CO_BEGIN()                                                       \
+    uint16_t *os_co_ = OS_CoState();                                        \
+    switch (*os_co_) { case 0:
+
+#define OS_CO_END()                                                         \
+    } *os_co_ = 0; return
+
+/* 让出一次 CPU，下次从下一行继续 */
+#define OS_CO_YIELD()                                                       \
+    do { *os_co_ = __LINE__; return; case __LINE__:; } while (0)
+
+/* 等待条件成立 */
+#define OS_CO_AWAIT(cond)                                                   \
+    do { *os_co_ = __LINE__; case __LINE__: if (!(cond)) return; } while (0)
+
+/* 延时 ms 毫秒后继续 */
+#define OS_CO_DELAY(ms)                                                     \
+    do { *os_co_ = __LINE__; OS_DelayMs(ms); return; case __LINE__:; } while (0)
+
+/* 阻塞等待事件标志 (不占用 CPU 轮询)，bits 输出取走的标志，可为 NULL */
+#define OS_CO_WAIT_EVENT(ev, mask, bits)                                    \
+    do { *os_co_ = __LINE__; case __LINE__:                                 \
+         if (OS_EventWait((ev), (mask), OS_WAIT_FOREVER, (bits)) != OS_OK) return; } while (0)
+
+/* 阻塞接收一条消息 */
+#define OS_CO_WAIT_QUEUE(q, msg)                                            \
+    do { *os_co_ = __LINE__; case __LINE__:                                 \
+         if (OS_QueueReceive((q), (msg), OS_WAIT_FOREVER) != OS_OK) return; } while (0)
+
+/**
+ * @brief 把一项工作延后到延后处理任务中执行 (中断下半部)
+ * @param fn  工作函数
+ * @param arg 工作参数
+ * @return OS_OK；队列满时返回 OS_ERR_FULL 并计入丢弃数
+ * @note  单生产者无锁队列：只能在中断中调用，且所有投递者须处于同一
+ *        抢占优先级 (本工程外设中断均为 0)，任务中的工作直接调用即可。
+ *        投递时记录 DWT 时间戳，执行时统计从投递到执行的最大延迟
+ */
+int32_t OS_DeferPost(void (*fn)(void *), void *arg);
+
+/**
+ * @brief 读取延后处理统计
+ * @param dropped    输出队列满而丢弃的工作数 (可为空)
+ * @param maxLatency 输出投递到开始执行的最大延迟，CPU 周期 (可为空)
+ */
+void OS_GetDeferStats(uint32_t *dropped, uint32_t *maxLatency);
+
+/* 移植层接口 (os_port.c 实现) ----------------------------------------------*/
+
+/**
+ * @brief 睡眠直到中断或 expectedTicks 个 tick 之后
+ * @param expectedTicks 距离最近唤醒的 tick 数 (可能为 OS_WAIT_FOREVER)
+ * @return 睡眠期间被抑制、需要由 OS_TickAdvance 补记的 tick 数
+ * @note  调用时中断已被屏蔽 (PRIMASK=1)，WFI 仍会被挂起的中断唤醒
+ */
+uint32_t OS_PortSleep(uint32_t expectedTicks);
+
 #endif /* __OS_H */
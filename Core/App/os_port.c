@@ -0,0 +1,109 @@
+/**
+ * @file    os_port.c
+ * @brief   协同式调度器的 Cortex-M4 移植层 (SysTick 无节拍空闲)
+ * @date    2026-02-19
+ * @note    SysTick 由 HAL 配置为 1ms 中断，SysTick_Handler 中调用 OS_Tick()
+ *          和 HAL_IncTick()。空闲时把 SysTick 重装载值拉长到最近的唤醒
+ *          时刻再执行 WFI；被其他中断提前唤醒时，按 SysTick 剩余计数算出
+ *          实际经过的整 tick 数，并把下一次中断对齐回原来的 tick 相位。
+ */
+
+#include "os.h"
+
+/* SysTick 为 24 位递减计数器 */
+#define OS_PORT_SYSTICK_MAX     0x00FFFFFFUL
+
+/* 寄存器访问：在主机上仿真时可预先定义以下宏 (见 tools/os_tickless_sim.c)
+ * 注意 SysTick->CTRL 的 COUNTFLAG 读即清零，所以停表一律直接写 CTRL，
+ * 不能用 &= / |= 这类读-改-写 */
+#ifndef OS_PORT_ST_READ
+#define OS_PORT_ST_READ(reg)        (SysTick->reg)
+#define OS_PORT_ST_WRITE(reg, v)    (SysTick->reg = (v))
+#define OS_PORT_TICK_PENDING()      ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+#define OS_PORT_WFI()               do { __DSB(); __WFI(); __ISB(); } while (0)
+#endif
+
+/**
+ * @brief 睡眠直到中断或 expectedTicks 个 tick 之后 (调用时 PRIMASK=1)
+ * @return 需要由 OS_TickAdvance 补记的 tick 数
+ */
+uint32_t OS_PortSleep(uint32_t expectedTicks)
+{
+    const uint32_t cyclesPerTick = OS_PORT_ST_READ(LOAD) + 1U;  // HAL 配置的 1 tick 周期
+    const uint32_t maxTicks      = OS_PORT_SYSTICK_MAX / cyclesPerTick;
+    uint32_t completed = 0;
+
+    /* 唤醒时刻很近：普通 WFI，等下一个中断 (最迟是下一个 SysTick) */
+    if (expectedTicks < OS_CFG_TICKLESS_MIN_TICKS) {
+        OS_PORT_WFI();
+        return 0;
+    }
+
+    if (expectedTicks > maxTicks) {
+        expectedTicks = maxTicks;
+    }
+
+    /* 1. 停止 SysTick (保留时钟源与中断使能位)，计算一直数到目标唤醒时刻的重装载值 */
+    const uint32_t ctrl = OS_PORT_ST_READ(CTRL) &
+                          ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_COUNTFLAG_Msk);
+    OS_PORT_ST_WRITE(CTRL, ctrl);
+
+    /* 停表前 tick 中断已经挂起：直接返回，让它先得到处理 */
+    if (OS_PORT_TICK_PENDING()) {
+        OS_PORT_ST_WRITE(CTRL, ctrl | SysTick_CTRL_ENABLE_Msk);
+        return 0;
+    }
+
+    /* 计数器使能后第一个时钟装载 LOAD，再递减 LOAD 次到 0：到期需 LOAD + 1 个周期 */
+    uint32_t remaining = OS_PORT_ST_READ(VAL);
+    if (remaining == 0) {
+        remaining = cyclesPerTick;
+    }
+    uint32_t reload = remaining - 1U + cyclesPerTick * (expectedTicks - 1U);
+
+    OS_PORT_ST_WRITE(LOAD, reload);
+    OS_PORT_ST_WRITE(VAL, 0U);                              // 同时清除 COUNTFLAG
+    OS_PORT_ST_WRITE(CTRL, ctrl | SysTick_CTRL_ENABLE_Msk);
+
+    /* 2. 睡眠 */
+    OS_PORT_WFI();
+
+    /* 3. 醒来后直接写 CTRL 停表 (不读，COUNTFLAG 保持)，然后只读一次 CTRL：
+     *    COUNTFLAG 置位说明定时到期，否则是被其他中断提前唤醒 */
+    OS_PORT_ST_WRITE(CTRL, ctrl);
+
+    const uint32_t flags = OS_PORT_ST_READ(CTRL);
+    const uint32_t val   = OS_PORT_ST_READ(VAL);
+    uint32_t elapsed;                                       // 距最近一个已记 tick 边界的周期数
+
+    if (flags & SysTick_CTRL_COUNTFLAG_Msk) {
+        /* 计满：SysTick 中断已挂起，会自己记到期时刻的 1 个 tick，这里补记其余的；
+         * 到期后计数器已重装载 reload 继续递减 (到期当拍 VAL 仍为 0) */
+        completed = expectedTicks - 1U;
+        elapsed   = (val == 0) ? 0U : reload - val + 1U;
+    } else {
+        /* 提前唤醒：按已递减的计数折算 (以睡眠前最后一个 tick 边界为起点) */
+        completed = 0;
+        elapsed   = expectedTicks * cyclesPerTick - val;
+    }
+
+    /* 整 tick 补记，不足一个 tick 的部分决定下一次中断的时刻，保持原 tick 相位 */
+    completed += elapsed / cyclesPerTick;
+    uint32_t next = cyclesPerTick - elapsed % cyclesPerTick;
+    if (next == 1U) {
+        /* LOAD 为 0 时计数器不产生中断：这个边界直接补记，下一次对齐到再下一个 */
+        completed++;
+        next += cyclesPerTick;
+    }
+    OS_PORT_ST_WRITE(LOAD, next - 1U);
+
+    /* 4. 以修正后的装载值重启，随后恢复正常的 1 tick 周期 */
+    OS_PORT_ST_WRITE(VAL, 0U);
+    OS_PORT_ST_WRITE(CTRL, ctrl | SysTick_CTRL_ENABLE_Msk);
+    OS_PORT_ST_WRITE(LOAD, cyclesPerTick - 1U);
+
+    /* HAL 的毫秒计数同样由 SysTick 驱动，一并补偿 */
+    uwTick += completed;
+
+    return completed;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file    os_ring.h
+ * @brief   无锁单生产者/单消费者环形队列 (仅头文件)
+ * @note    - 容量必须为 2 的幂：head/tail 为自由递增的 16 位计数，下标取 & (capacity-1)，
+ *            条目数 = head - tail (回绕自动正确)，不需要共享的 count，也不需要关中断
+ *          - head 只由生产者写，tail 只由消费者写；满时 Push 返回 OS_ERR_FULL，
+ *            生产者从不移动 tail (丢最新而不是覆盖最旧，避免与消费者竞争)
+ *          - 典型用法：中断生产、任务消费。生产者与消费者各自只能有一个
+ *            (同一优先级的多个中断算一个生产者，见 OS_DeferPost)
+ *          - 零拷贝：WriteSlot/WriteCommit 让 DMA 或中断直接写入槽位，
+ *            ReadSlot/ReadRelease 让任务就地解析
+ *          - 内存屏障使用 os.h 移植层的 OS_MEMORY_BARRIER()，在主机上编译时预先定义即可
+ * @date    2026-02-19
+ */
+
+#ifndef __OS_RING_H
+#define __OS_RING_H
+
+#include "os.h"
+#include <stddef.h>
+#include <string.h>
+
+/* 是否为 2 的幂 (可用于静态检查容量) */
+#define OS_RING_IS_POW2(n)      ((n) != 0U && ((n) & ((n) - 1U)) == 0U)
+
+/* 环形队列 (存储区由调用者提供：capacity * itemSize 字节) */
+typedef struct {
+    uint8_t           *buf;
+    uint16_t           itemSize;    // 单个条目字节数
+    uint16_t           mask;        // capacity - 1
+    volatile uint16_t  head;        // 已写入条目计数 (仅生产者修改)
+    volatile uint16_t  tail;        // 已读出条目计数 (仅消费者修改)
+} OS_Ring_t;
+
+/**
+ * @brief 初始化
+ * @param capacity 条目数，必须为 2 的幂且不超过 32768
+ * @return OS_OK；OS_ERR_PARAM 容量不是 2 的幂
+ */
+static inline int32_t OS_Ring_Init(OS_Ring_t *r, void *buf, uint16_t itemSize, uint16_t capacity)
+{
+    if (!OS_RING_IS_POW2(capacity) || capacity > 32768U) {
+        return OS_ERR_PARAM;
+    }
+    r->buf      = (uint8_t *)buf;
+    r->itemSize = itemSize;
+    r->mask     = (uint16_t)(capacity - 1U);
+    r->head     = 0;
+    r->tail     = 0;
+    return OS_OK;
+}
+
+/**
+ * @brief 当前条目数 (两端都可调用，结果可能立即过时)
+ */
+static inline uint16_t OS_Ring_Count(const OS_Ring_t *r)
+{
+    return (uint16_t)(r->head - r->tail);
+}
+
+/**
+ * @brief 空闲槽位数
+ */
+static inline uint16_t OS_Ring_Free(const OS_Ring_t *r)
+{
+    return (uint16_t)(r->mask + 1U - OS_Ring_Count(r));
+}
+
+/**
+ * @brief 生产者：取下一个可写槽位
+ * @return 槽位指针；满时返回 NULL
+ * @note  写完后调用 OS_Ring_WriteCommit 发布；未发布前槽位归生产者所有，可反复取到同一个
+ */
+static inline void *OS_Ring_WriteSlot(OS_Ring_t *r)
+{
+    uint16_t head = r->head;
+
+    if ((uint16_t)(head - r->tail) > r->mask) {
+        return NULL;
+    }
+    OS_MEMORY_BARRIER();            // 先看到消费者释放槽位，再改写其内容
+    return &r->buf[(uint32_t)(head & r->mask) * r->itemSize];
+}
+
+/**
+ * @brief 生产者：发布 OS_Ring_WriteSlot 取得的槽位
+ */
+static inline void OS_Ring_WriteCommit(OS_Ring_t *r)
+{
+    OS_MEMORY_BARRIER();            // 先写完条目再发布
+    r->head = (uint16_t)(r->head + 1U);
+}
+
+/**
+ * @brief 生产者：拷贝写入一个条目
+ * @return OS_OK；OS_ERR_FULL 已满 (条目被丢弃)
+ */
+static inline int32_t OS_Ring_Push(OS_Ring_t *r, const void *item)
+{
+    void *slot = OS_Ring_WriteSlot(r);
+
+    if (slot == NULL) {
+        return OS_ERR_FULL;
+    }
+    memcpy(slot, item, r->itemSize);
+    OS_Ring_WriteCommit(r);
+    return OS_OK;
+}
+
+/**
+ * @brief 消费者：取最早的条目 (不出队)
+ * @return 条目指针；空时返回 NULL
+ * @note  用完后调用 OS_Ring_ReadRelease 归还槽位
+ */
+static inline void *OS_Ring_ReadSlot(OS_Ring_t *r)
+{
+    uint16_t tail = r->tail;
+
+    if (tail == r->head) {
+        return NULL;
+    }
+    OS_MEMORY_BARRIER();            // 看到 head 更新后再读条目
+    return &r->buf[(uint32_t)(tail & r->mask) * r->itemSize];
+}
+
+/**
+ * @brief 消费者：归还 OS_Ring_ReadSlot 取得的槽位
+ */
+static inline void OS_Ring_ReadRelease(OS_Ring_t *r)
+{
+    OS_MEMORY_BARRIER();            // 读完条目后才允许生产者覆盖
+    r->tail = (uint16_t)(r->tail + 1U);
+}
+
+/**
+ * @brief 消费者：拷贝读出一个条目
+ * @return OS_OK；OS_ERR_TIMEOUT 队列为空
+ */
+static inline int32_t OS_Ring_Pop(OS_Ring_t *r, void *item)
+{
+    const void *slot = OS_Ring_ReadSlot(r);
+
+    if (slot == NULL) {
+        return OS_ERR_TIMEOUT;
+    }
+    memcpy(item, slot, r->itemSize);
+    OS_Ring_ReadRelease(r);
+    return OS_OK;
+}
+
+#endif /* __OS_RING_H */
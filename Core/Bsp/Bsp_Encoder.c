@@ -2,8 +2,8 @@
 #include "tim.h"
 #include "stdio.h"
 // 定义两个电机实例
-Encoder_t motor1 = {&htim3, 0, 0.0f};
-Encoder_t motor2 = {&htim5, 0, 0.0f};
+Encoder_t motor1 = {&htim3, 0, 0.0f, 0};
+Encoder_t motor2 = {&htim5, 0, 0.0f, 0};
 
 /**
  * @brief 初始化编码器并开启定时器
@@ -19,13 +19,44 @@ void Encoder_Init(void) {
  * @note 4倍频下，一圈的总脉冲 = PPR * 4 * 减速比
  */
 void Encoder_Update_Speed(Encoder_t *m1, Encoder_t *m2) {
-    // 1. 获取当前计数值并计算增量（利用16位溢出特性）
-    int16_t cnt1 = (int16_t)__HAL_TIM_GET_COUNTER(m1->htim);
-    int16_t cnt2 = (int16_t)__HAL_TIM_GET_COUNTER(m2->htim);
+    Encoder_Sample(m1, m2);
+    Encoder_Compute_Speed(m1, m2);
+}
 
-    // 2. 计算 RPM = (脉冲数 / (单圈脉冲 * 4 * 减速比)) / 时间(s) * 60
-    /* 注意：分母为 (11 * 4 * 50 * 0.01) = 22.0 */
-    /* 如果转速很低，10ms 内可能只有1-2个脉冲，cnt=1 -> RPM = 60/22 ≈ 2.7 RPM */
+/**
+ * @brief 采样编码器计数 (在定时器中断里调用，只读寄存器并清零)
+ * @note  速度计算放到 Encoder_Compute_Speed，可延后到任务中执行
+ */
+void Encoder_Sample(Encoder_t *m1, Encoder_t *m2) {
+    // 获取当前计数值作为增量（利用16位溢出特性），随后清零为下一次采样准备
+    m1->delta = (int16_t)__HAL_TIM_GET_COUNTER(m1->htim);
+    m2->delta = (int16_t)__HAL_TIM_GET_COUNTER(m2->htim);
+    __HAL_TIM_SET_COUNTER(m1->htim, 0);
+    __HAL_TIM_SET_COUNTER(m2->htim, 0);
+}
+
+/**
+ * @brief 把最近一次增量放入滑动窗口，返回窗口内的总脉冲数
+ */
+static int32_t Encoder_Window_Push(Encoder_t *m) {
+    m->hist_sum -= m->hist[m->hist_idx];
+    m->hist[m->hist_idx] = m->delta;
+    m->hist_sum += m->delta;
+    if (++m->hist_idx >= ENCODER_SPEED_WINDOW) m->hist_idx = 0;
+    return m->hist_sum;
+}
+
+/**
+ * @brief 根据最近 ENCODER_SPEED_WINDOW 次采样的增量计算转速 (每次采样后调用)
+ */
+void Encoder_Compute_Speed(Encoder_t *m1, Encoder_t *m2) {
+    // 1. 取滑动窗口内的脉冲数
+    int32_t cnt1 = Encoder_Window_Push(m1);
+    int32_t cnt2 = Encoder_Window_Push(m2);
+
+    // 2. 计算 RPM = (脉冲数 / (单圈脉冲 * 4 * 减速比)) / 窗口时间(s) * 60
+    /* 注意：分母为 (11 * 4 * 50 * 0.001 * 10) = 22.0 */
+    /* 如果转速很低，10ms 窗口内可能只有1-2个脉冲，cnt=1 -> RPM = 60/22 ≈ 2.7 RPM */
     /* 如果转速为0，cnt=0 */
     // float common_factor = (ENCODER_PPR * 4.0f * MOTOR_REDUCTION_RATIO * SAMPLE_TIME_S);
     
@@ -34,12 +65,8 @@ void Encoder_Update_Speed(Encoder_t *m1, Encoder_t *m2) {
 
     /* 增加速度为0的判断逻辑（防止抖动或极低速时的噪声） */
     if (cnt1 == 0) m1->speed_rpm = 0.0f;
-    else m1->speed_rpm = -(float)cnt1 * 60.0f / (ENCODER_PPR * 4.0f * MOTOR_REDUCTION_RATIO * SAMPLE_TIME_S);
+    else m1->speed_rpm = -(float)cnt1 * 60.0f / (ENCODER_PPR * 4.0f * MOTOR_REDUCTION_RATIO * SAMPLE_TIME_S * ENCODER_SPEED_WINDOW);
 
     if (cnt2 == 0) m2->speed_rpm = 0.0f;
-    else m2->speed_rpm = (float)cnt2 * 60.0f / (ENCODER_PPR * 4.0f * MOTOR_REDUCTION_RATIO * SAMPLE_TIME_S);
-
-    // 3. 计数值清零，为下一次采样准备
-    __HAL_TIM_SET_COUNTER(m1->htim, 0);
-    __HAL_TIM_SET_COUNTER(m2->htim, 0);
+    else m2->speed_rpm = (float)cnt2 * 60.0f / (ENCODER_PPR * 4.0f * MOTOR_REDUCTION_RATIO * SAMPLE_TIME_S * ENCODER_SPEED_WINDOW);
 }
@@ -6,12 +6,18 @@
 // �������������壨���������ʵ������޸ģ�
 #define ENCODER_PPR          11     // ������ÿת������ (Pulse Per Revolution)
 #define MOTOR_REDUCTION_RATIO 50    // ������ٱ�
-#define SAMPLE_TIME_S        0.05f  // 速度采样时间 (50ms)
+#define ENCODER_SAMPLE_HZ    1000   // 速度采样频率 (Hz)，即速度环频率 (TIM14 中断)
+#define SAMPLE_TIME_S        (1.0f / ENCODER_SAMPLE_HZ)  // 速度采样时间
+#define ENCODER_SPEED_WINDOW 10     // 测速滑动窗口 (采样次数)：1ms 内 1 个脉冲约合 27RPM，取 10 次平均
 
 typedef struct {
     TIM_HandleTypeDef *htim; // 指向定时器的句柄
     int32_t last_count;      // 上次计数值
     float speed_rpm;         // 转速（转/分钟, RPM）
+    int16_t delta;           // 最近一次采样的计数增量 (Encoder_Sample 写入)
+    int16_t hist[ENCODER_SPEED_WINDOW]; // 最近若干次采样的增量
+    uint8_t hist_idx;        // 滑动窗口写位置
+    int32_t hist_sum;        // 滑动窗口内增量之和
 } Encoder_t;
 
 extern Encoder_t motor1;
@@ -20,5 +26,7 @@ extern Encoder_t motor2;
 // 函数声明
 void Encoder_Init(void);
 void Encoder_Update_Speed(Encoder_t *m1, Encoder_t *m2);
+void Encoder_Sample(Encoder_t *m1, Encoder_t *m2);
+void Encoder_Compute_Speed(Encoder_t *m1, Encoder_t *m2);
 
 #endif
@@ -4,6 +4,14 @@
 /* 全局参数变量 (Global Parameters) */
 App_Params_t g_app_params;
 
+/**
+ * @brief 默认增益调度表：按目标距离 20~120 cm 调度，各断点取同一组固定增益
+ */
+static void App_Flash_Default_Sched(Gain_Sched_Table_t *t, float kp, float ki, float kd)
+{
+    Gain_Sched_Init(t, GAIN_SCHED_SRC_DIST, 20.0f, 120.0f, kp, ki, kd);
+}
+
 /**
  * @brief 从 Flash 加载参数 (Load Parameters from Flash)
  * @note  检查 Flash 有效标志，如果有效则加载，否则使用默认值
@@ -16,6 +24,14 @@ void App_Flash_Load(void)
     if (flash_params->magic == FLASH_MAGIC_NUM) {
         /* 有效: 加载参数 (Valid: Load parameters) */
         memcpy(&g_app_params, flash_params, sizeof(App_Params_t));
+        
+        /* 前馈表单独校验 (旧版本参数区之后是擦除值) */
+        if (g_app_params.ff_L.magic != MOTOR_FF_MAGIC) Motor_FF_Clear(&g_app_params.ff_L);
+        if (g_app_params.ff_R.magic != MOTOR_FF_MAGIC) Motor_FF_Clear(&g_app_params.ff_R);
+        
+        /* 增益调度表单独校验：无效时按固定增益生成平坦表 (不启用) */
+        if (!Gain_Sched_Valid(&g_app_params.gs_dist)) App_Flash_Default_Sched(&g_app_params.gs_dist, g_app_params.dist_kp, g_app_params.dist_ki, g_app_params.dist_kd);
+        if (!Gain_Sched_Valid(&g_app_params.gs_angle)) App_Flash_Default_Sched(&g_app_params.gs_angle, g_app_params.angle_kp, g_app_params.angle_ki, g_app_params.angle_kd);
     } else {
         /* 无效: 设置默认参数 (Invalid: Set default parameters) */
         g_app_params.magic = FLASH_MAGIC_NUM;
@@ -39,6 +55,14 @@ void App_Flash_Load(void)
         g_app_params.speed_R_kp = 5.0f;
         g_app_params.speed_R_ki = 2.5f;
         g_app_params.speed_R_kd = 0.0f;
+        
+        /* 速度环前馈 (未辨识，前馈为 0) */
+        Motor_FF_Clear(&g_app_params.ff_L);
+        Motor_FF_Clear(&g_app_params.ff_R);
+        
+        /* 外环增益调度 (平坦表，不启用) */
+        App_Flash_Default_Sched(&g_app_params.gs_dist, g_app_params.dist_kp, g_app_params.dist_ki, g_app_params.dist_kd);
+        App_Flash_Default_Sched(&g_app_params.gs_angle, g_app_params.angle_kp, g_app_params.angle_ki, g_app_params.angle_kd);
     }
 }
 
@@ -2,6 +2,8 @@
 #define __BSP_FLASH_H
 
 #include "main.h"
+#include "motor_ff.h"
+#include "gain_sched.h"
 
 /* Flash 洢ַ (STM32F407 Sector 11: 0x080E0000 - 0x080FFFFF) */
 #define FLASH_USER_START_ADDR   0x080E0000 
@@ -31,6 +33,15 @@ typedef struct {
     float speed_R_kp;
     float speed_R_ki;
     float speed_R_kd;
+
+    /* ٶȻǰ (Speed Feedforward Maps)б±ʶɣ
+     * ĩβɰ汾Ĳǲֵmagic Ϊδʶ */
+    Motor_FF_Map_t ff_L;
+    Motor_FF_Map_t ff_R;
+
+    /* ⻷ȱ (Gain Schedules)ͬ׷ĩβԴ magic */
+    Gain_Sched_Table_t gs_dist;
+    Gain_Sched_Table_t gs_angle;
     
 } App_Params_t;
 
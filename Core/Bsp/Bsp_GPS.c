@@ -6,13 +6,28 @@
 #include <stdarg.h>
 #include <math.h>
 #include "os.h"
+#include "os_ring.h"
 
-/* Buffer Configuration */
+/* Buffer Configuration
+ * SPSC ring of receive buffers (os_ring.h): DMA fills the producer's write
+ * slot in place and the IDLE ISR publishes it, the task parses the oldest
+ * slot in place. The ISR always keeps one slot for DMA; when the task still
+ * holds all the others the new sentence is dropped instead of overwriting
+ * the buffer being parsed. +1 byte for the '\0'. */
 #define GPS_RX_BUF_SIZE 512
-uint8_t gps_rx_buffer[GPS_RX_BUF_SIZE];
-uint8_t gps_proc_buffer[GPS_RX_BUF_SIZE];
-volatile uint16_t gps_rx_len = 0;
-volatile uint8_t gps_data_ready = 0;
+#define GPS_RX_SLOTS    2       /* power of two */
+typedef struct {
+    uint16_t len;
+    uint8_t  data[GPS_RX_BUF_SIZE + 1];
+} GPS_Rx_Slot_t;
+static GPS_Rx_Slot_t gps_rx_slots[GPS_RX_SLOTS];
+static OS_Ring_t gps_rx_ring;
+static GPS_Rx_Slot_t *gps_dma_slot;         /* slot currently owned by DMA */
+volatile uint32_t gps_rx_dropped = 0;
+
+/* Rx event: set in the IDLE ISR, GPS_Process_Task blocks on it */
+#define GPS_EVT_RX  0x01U
+static OS_Event_t gps_event;
 
 /* Global GPS Data Instance */
 nmea_msg gps_data;
@@ -140,11 +155,15 @@ void NMEA_GPRMC_Analysis(nmea_msg *gpsx, uint8_t *buf) {
 
 /* Initialization */
 void GPS_Init(void) {
+    OS_EventInit(&gps_event);
+    OS_Ring_Init(&gps_rx_ring, gps_rx_slots, sizeof(GPS_Rx_Slot_t), GPS_RX_SLOTS);
+    gps_dma_slot = (GPS_Rx_Slot_t *)OS_Ring_WriteSlot(&gps_rx_ring);
+
     /* 1. Enable GPS Module (PE9) */
     HAL_GPIO_WritePin(GPIOE, GPIO_PIN_9, GPIO_PIN_SET);
     
     /* 2. Start UART DMA Reception with Idle Interrupt */
-    HAL_UART_Receive_DMA(&huart3, gps_rx_buffer, GPS_RX_BUF_SIZE);
+    HAL_UART_Receive_DMA(&huart3, gps_dma_slot->data, GPS_RX_BUF_SIZE);
     __HAL_UART_ENABLE_IT(&huart3, UART_IT_IDLE);
 }
 
@@ -159,36 +178,42 @@ void GPS_Rx_Callback(void) {
         /* Calculate received length */
         uint16_t rx_len = GPS_RX_BUF_SIZE - __HAL_DMA_GET_COUNTER(huart3.hdmarx);
         
-        /* Copy to process buffer */
+        /* Publish the filled slot only if another one is left for DMA */
         if (rx_len > 0) {
-            memcpy(gps_proc_buffer, gps_rx_buffer, rx_len);
-            gps_proc_buffer[rx_len] = 0; // Null terminate
-            gps_rx_len = rx_len;
-            gps_data_ready = 1;
+            if (OS_Ring_Free(&gps_rx_ring) > 1U) {
+                gps_dma_slot->data[rx_len] = 0; // Null terminate (buffer has +1 byte)
+                gps_dma_slot->len = rx_len;
+                OS_Ring_WriteCommit(&gps_rx_ring);
+                gps_dma_slot = (GPS_Rx_Slot_t *)OS_Ring_WriteSlot(&gps_rx_ring);
+                OS_EventSet(&gps_event, GPS_EVT_RX);
+            } else {
+                gps_rx_dropped++;               // Task busy: reuse the same slot
+            }
         }
         
-        /* Restart DMA */
-        HAL_UART_Receive_DMA(&huart3, gps_rx_buffer, GPS_RX_BUF_SIZE);
+        /* Restart DMA into the free slot */
+        HAL_UART_Receive_DMA(&huart3, gps_dma_slot->data, GPS_RX_BUF_SIZE);
     }
 }
 
-/* OS Task */
+/* OS Task: runs only when the Rx event wakes it */
 void GPS_Process_Task(void *arg) {
-        /* Check if new data arrived */
-        if (gps_data_ready) {
-            /* Clear flag */
-            gps_data_ready = 0;
+        GPS_Rx_Slot_t *slot;
 
-            /* Print Raw Data */
+        /* Wait for new data (returns OS_PENDING and blocks when none) */
+        while (OS_EventWait(&gps_event, GPS_EVT_RX, OS_WAIT_FOREVER, NULL) == OS_OK) {
+            while ((slot = (GPS_Rx_Slot_t *)OS_Ring_ReadSlot(&gps_rx_ring)) != NULL) {
+                uint8_t *gps_proc_buffer = slot->data;
+
+                /* Print Raw Data */
 #if DEBUG_GPS_PRINT
-            printf("[GPS_RAW] %s\r\n", gps_proc_buffer);
+                printf("[GPS_RAW] %s\r\n", gps_proc_buffer);
 #endif
-            
-            /* Parse Data */
-            NMEA_GPRMC_Analysis(&gps_data, gps_proc_buffer);
-            NMEA_GPGGA_Analysis(&gps_data, gps_proc_buffer);
+                
+                /* Parse Data */
+                NMEA_GPRMC_Analysis(&gps_data, gps_proc_buffer);
+                NMEA_GPGGA_Analysis(&gps_data, gps_proc_buffer);
+                OS_Ring_ReadRelease(&gps_rx_ring);
+            }
         }
-        
-        /* Yield 200ms */
-        OS_DelayMs(200);
 }
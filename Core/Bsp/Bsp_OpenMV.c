@@ -1,113 +1,241 @@
 #include "Bsp_OpenMV.h"
 #include "core_main_config.h"
 #include "os.h"
+#include "os_ring.h"
 #include <stdio.h>
 #include "pid.h"
 
 /* 串口句柄 (UART Handle) */
 static UART_HandleTypeDef *openmv_huart;
+
+/* 接收环形缓冲 (Rx Ring)：DMA 循环模式持续写入，从不停止；
+ * 解析直接按读指针从环中取字节，不拷贝。115200bps 下 512 字节约可缓冲 44ms */
 #define OPENMV_RX_BUF_SIZE 512
 static uint8_t openmv_rx_buffer[OPENMV_RX_BUF_SIZE];
-static uint16_t last_rx_index = 0;
-static volatile uint8_t omv_process_flag = 0; // 空闲中断标志 (IDLE flag)
+static uint16_t last_rx_index = 0;              // 读指针 (只在解析上下文中修改)
+static uint32_t omv_rd_total;                   // 已解析的总字节数 (只在解析上下文中修改)
+static uint32_t omv_overruns;                   // 写位置追上读指针的次数
+static volatile uint8_t omv_process_flag = 0;   // 已投递解析、尚未执行 (避免重复投递)
+
+/* 接收时间戳：每个接收事件 (ISR) 成对记录 DWT 时刻和当时的 DMA 写位置，
+ * 解析只处理到该位置，每帧的接收时刻按其后的字节数倒推 */
+static volatile uint32_t omv_evt_cyc;           // 写位置前一个字节收完的时刻
+static volatile uint16_t omv_evt_index;         // 事件时的 DMA 写位置
+static volatile uint32_t omv_wr_total;          // 到该事件为止 DMA 写入的总字节数 (自由回绕)
+static uint32_t omv_byte_cyc;                   // 一个字符 (10 位) 的时间 (DWT 周期)
+
+/* 新帧事件：OpenMV_Print_Task 阻塞等待 */
+#define OMV_EVT_FRAME  0x01U
+static OS_Event_t omv_event;
 
 /* OpenMV 数据实例 (OpenMV Data Instance) */
 OpenMV_Data_t openmv_data = {0};
-OpenMV_FIFO_t openmv_fifo = {0};
-
-/* 将数据写入 FIFO (Write Data to FIFO) */
-static void OpenMV_FIFO_Push(OpenMV_Data_t data) {
-    /* 写入数据到缓冲区 (Write data to buffer) */
-    openmv_fifo.buffer[openmv_fifo.head] = data;
-    
-    /* 更新 head 指针 (Update head pointer) */
-    uint8_t next_head = (openmv_fifo.head + 1) % OPENMV_FIFO_SIZE;
-    
-    /* 检查缓冲区是否满 (Check if buffer full) */
-    if (next_head == openmv_fifo.tail) {
-        /* 缓冲区满，覆盖旧数据 (Buffer full, overwrite old data) */
-        openmv_fifo.tail = (openmv_fifo.tail + 1) % OPENMV_FIFO_SIZE;
-        /* count 不需要增加，因为覆盖了一个旧的 (count remains same) */
-    } else {
-        /* 未满，增加计数 (Not full, increment count) */
-        openmv_fifo.count++;
+
+/* 帧队列：满时丢最新帧 (打印任务跟不上时只影响打印) */
+static OpenMV_Data_t openmv_fifo_buf[OPENMV_FIFO_SIZE];
+static OS_Ring_t openmv_fifo;
+
+/**
+ * @brief 新数据帧回调 (New Frame Callback)
+ * @note  每解析出一帧有效数据调用一次，在解析所在的上下文中执行；
+ *        弱定义，应用层可重新实现 (与 HAL 回调相同的用法)
+ */
+__weak void OpenMV_Frame_Callback(const OpenMV_Data_t *data)
+{
+    (void)data;
+}
+
+/* 协议解码器 (v1/v2 自动识别，见 Bsp_OpenMV_Proto.h) */
+static OMV_Proto_t omv_proto;
+
+/* 协议解码函数 (Protocol Decode Function)
+ * rx_cyc：该字节的接收时刻 */
+static uint8_t OpenMV_Decode(uint8_t byte, uint32_t rx_cyc) {
+    if (!OMV_Proto_Feed(&omv_proto, byte, &openmv_data)) {
+        return 0;
     }
-    
-    openmv_fifo.head = next_head;
+    openmv_data.rx_cyc = rx_cyc;
+
+    /* 推入 FIFO (Push to FIFO) */
+    (void)OS_Ring_Push(&openmv_fifo, &openmv_data);
+    OS_EventSet(&omv_event, OMV_EVT_FRAME);
+
+    /* 通知应用层新帧到达 (Notify new frame) */
+    OpenMV_Frame_Callback(&openmv_data);
+    return 1;
 }
 
-/* 从 FIFO 读取数据 (Read Data from FIFO) */
-static uint8_t OpenMV_FIFO_Pop(OpenMV_Data_t *data) {
-    /* 检查缓冲区是否空 (Check if buffer empty) */
-    if (openmv_fifo.head == openmv_fifo.tail) {
-        return 0; // 空 (Empty)
+/**
+ * @brief 解码统计
+ */
+const OMV_Proto_Stats_t *OpenMV_Get_Stats(void)
+{
+    return &omv_proto.stats;
+}
+
+/**
+ * @brief 接收环溢出次数 (解析没跟上，DMA 覆盖了未读数据)
+ */
+uint32_t OpenMV_Get_Overruns(void)
+{
+    return omv_overruns;
+}
+
+/**
+ * @brief 初始化 OpenMV 接收 (Init OpenMV Receiver)
+ * @param huart 串口句柄，其 hdmarx 须配置为 DMA_CIRCULAR
+ * @note  DMA 循环接收一直运行：半满 (HT)、全满 (TC) 和空闲 (IDLE) 三种事件都只通知解析，
+ *        不停止也不重启 DMA，高帧率下不会在重启间隙丢字节
+ */
+void OpenMV_Init(UART_HandleTypeDef *huart)
+{
+    openmv_huart = huart;
+    last_rx_index = 0;
+    omv_rd_total = 0;
+    omv_overruns = 0;
+    omv_process_flag = 0;
+    omv_evt_index = 0;
+    omv_wr_total = 0;
+    omv_evt_cyc = DWT->CYCCNT;
+    omv_byte_cyc = (uint32_t)((uint64_t)SystemCoreClock * 10U / huart->Init.BaudRate);
+    OMV_Proto_Init(&omv_proto);
+    OS_Ring_Init(&openmv_fifo, openmv_fifo_buf, sizeof(OpenMV_Data_t), OPENMV_FIFO_SIZE);
+    OS_EventInit(&omv_event);
+
+    HAL_UART_Receive_DMA(huart, openmv_rx_buffer, OPENMV_RX_BUF_SIZE);
+
+    /* 关闭线路错误中断：DMA 接收时 HAL 把噪声/帧错误/溢出都当作阻塞错误并中止 DMA。
+     * 出错的字节交给协议 (v2 CRC，v1 包头/包尾) 丢弃，ORE 在空闲中断读 SR、DR 时一并清除 */
+    CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
+    CLEAR_BIT(huart->Instance->CR1, USART_CR1_PEIE);
+
+    __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);
+}
+
+/* 延后处理任务中执行解析 */
+static void OpenMV_Parse_Deferred(void *arg)
+{
+    (void)arg;
+    OpenMV_Parse_Callback();
+}
+
+/**
+ * @brief 接收事件 (ISR 上下文)：记录时间戳，投递一次解析，已投递未执行时不重复投递
+ * @param idle 1 空闲事件：IDLE 在最后一个字符之后再过一个字符时间才置位
+ */
+static void OpenMV_Rx_Notify(uint8_t idle)
+{
+    uint16_t index;
+    uint32_t primask;
+
+    /* USART 与 DMA 中断可能互相抢占，三个量须成对更新 */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    index = (uint16_t)(OPENMV_RX_BUF_SIZE - __HAL_DMA_GET_COUNTER(openmv_huart->hdmarx));
+    if (index >= OPENMV_RX_BUF_SIZE) {
+        index = 0;          // NDTR 重装瞬间
+    }
+    /* HT/TC 保证相邻两个事件之间不超过半个缓冲，按写位置之差累加总数不会有歧义 */
+    omv_wr_total += (uint16_t)((index - omv_evt_index + OPENMV_RX_BUF_SIZE) % OPENMV_RX_BUF_SIZE);
+    omv_evt_cyc   = DWT->CYCCNT - (idle ? omv_byte_cyc : 0U);
+    omv_evt_index = index;
+    __set_PRIMASK(primask);
+
+    if (omv_process_flag) {
+        return;
+    }
+    omv_process_flag = 1;
+    if (OS_DeferPost(OpenMV_Parse_Deferred, NULL) != OS_OK) {
+        omv_process_flag = 0;   // 队列满：下一个事件再投递，数据仍在环中
+    }
+}
+
+/**
+ * @brief USART6 中断回调 (在 USART6_IRQHandler 中、HAL_UART_IRQHandler 之前调用)
+ * @note  只处理 IDLE：一帧数据结束后线路空闲，立即解析
+ */
+void OpenMV_Rx_Callback(void)
+{
+    if (__HAL_UART_GET_FLAG(openmv_huart, UART_FLAG_IDLE) &&
+        __HAL_UART_GET_IT_SOURCE(openmv_huart, UART_IT_IDLE)) {
+        __HAL_UART_CLEAR_IDLEFLAG(openmv_huart);
+        OpenMV_Rx_Notify(1);
+    }
+}
+
+/**
+ * @brief HAL 库 UART 接收半满/全满回调 (DMA 中断)
+ * @note  数据连续不断、没有空闲间隙时，保证每半个缓冲区至少解析一次
+ */
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == openmv_huart) {
+        OpenMV_Rx_Notify(0);
+    }
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == openmv_huart) {
+        OpenMV_Rx_Notify(0);
     }
-    
-    /* 读取数据 (Read data) */
-    *data = openmv_fifo.buffer[openmv_fifo.tail];
-    
-    /* 更新 tail 指针 (Update tail pointer) */
-    openmv_fifo.tail = (openmv_fifo.tail + 1) % OPENMV_FIFO_SIZE;
-    
-    /* 减少计数 (Decrement count) */
+}
+
+/**
+ * @brief 解析环形缓冲中的新数据 (Parse New Data from the Ring)
+ * @note  从读指针解析到最近一次接收事件记录的写位置；每解析出一帧调用
+ *        OpenMV_Frame_Callback。先清投递标志再取写位置，解析期间到达的数据会触发新的投递，
+ *        事件之后才到的字节留给下一个事件 (一串数据结束总会有 IDLE)。
+ *        未读字节数按写入/已读总数计算：达到缓冲区大小说明 DMA 已绕过读指针，
+ *        环中数据不可信，计一次溢出，丢弃到写位置并让解码器重新找帧头
+ */
+void OpenMV_Parse_Callback(void)
+{
+    uint16_t write_index;
+    uint32_t evt_cyc, wr_total, pending, primask;
+
+    omv_process_flag = 0;
+
+    primask = __get_PRIMASK();
     __disable_irq();
-    if (openmv_fifo.count > 0) openmv_fifo.count--;
-    __enable_irq();
-    
-    return 1;
+    write_index = omv_evt_index;
+    evt_cyc     = omv_evt_cyc;
+    wr_total    = omv_wr_total;
+    __set_PRIMASK(primask);
+
+    pending = wr_total - omv_rd_total;
+    omv_rd_total = wr_total;
+    if (pending >= OPENMV_RX_BUF_SIZE) {
+        omv_overruns++;
+        last_rx_index = write_index;
+        OMV_Proto_Resync(&omv_proto);
+        return;
+    }
+    while (pending > 0) {
+        pending--;
+        /* 该字节之后还有 pending 个字节在事件前收到 */
+        OpenMV_Decode(openmv_rx_buffer[last_rx_index], evt_cyc - pending * omv_byte_cyc);
+        if (++last_rx_index >= OPENMV_RX_BUF_SIZE) {
+            last_rx_index = 0;
+        }
+    }
 }
 
-/* 协议解析状态 (Protocol States) */
-typedef enum {
-    OMV_STATE_HEADER = 0, // 包头 (Header)
-    OMV_STATE_X,          // X坐标 (X Coordinate)
-    OMV_STATE_DIST,       // 距离 (Distance)
-    OMV_STATE_TAIL        // 包尾 (Tail)
-} OMV_State_t;
-
-static OMV_State_t omv_state = OMV_STATE_HEADER;
-static uint8_t temp_x = 0;
-static uint8_t temp_dist = 0;
-
-/* 协议解码函数 (Protocol Decode Function) */
-static uint8_t OpenMV_Decode(uint8_t byte) {
-    uint8_t packet_ready = 0;
-    
-    switch (omv_state) {
-        case OMV_STATE_HEADER:
-            if (byte == 0xAA) {
-                omv_state = OMV_STATE_X;
-            }
-            break;
-            
-        case OMV_STATE_X:
-            temp_x = byte;
-            omv_state = OMV_STATE_DIST;
-            break;
-            
-        case OMV_STATE_DIST:
-            temp_dist = byte;
-            omv_state = OMV_STATE_TAIL;
-            break;
-            
-        case OMV_STATE_TAIL:
-            if (byte == 0x55) {
-                /* 有效数据包 (Valid Packet) */
-                openmv_data.x = temp_x;
-                openmv_data.dist = temp_dist;
-                
-                /* 推入 FIFO (Push to FIFO) */
-                OpenMV_FIFO_Push(openmv_data);
-                packet_ready = 1;
-            }
-            /* 无论是否正确包尾，都重置状态 (Reset state) */
-            omv_state = OMV_STATE_HEADER; 
-            break;
-            
-        default:
-            omv_state = OMV_STATE_HEADER;
-            break;
+/**
+ * @brief OpenMV 数据打印任务 (OS Task)
+ * @note  新帧事件唤醒，取空 FIFO；DEBUG_OPENMV_PRINT 为 0 时只取出不打印
+ */
+void OpenMV_Print_Task(void *arg)
+{
+    OpenMV_Data_t data;
+
+    (void)arg;
+    while (OS_EventWait(&omv_event, OMV_EVT_FRAME, OS_WAIT_FOREVER, NULL) == OS_OK) {
+        while (OS_Ring_Pop(&openmv_fifo, &data) == OS_OK) {
+#if DEBUG_OPENMV_PRINT
+            printf("[OpenMV] v%u #%u x=%u y=%u %ux%u dist=%u conf=%u\r\n", data.ver, data.seq,
+                   data.x, data.y, data.w, data.h, data.dist, data.conf);
+#endif
+        }
     }
-    
-    return packet_ready;
 }
@@ -6,31 +6,21 @@ extern "C" {
 #endif
 
 #include "main.h"
+#include "Bsp_OpenMV_Proto.h"   // OpenMV_Data_t 及协议定义
 
-/* OpenMV 数据结构 (OpenMV Data Structure) */
-typedef struct {
-    uint8_t x;           // X 坐标 (0-160)
-    uint8_t dist;        // 距离 (cm)
-    // uint8_t update_flag; // 更新标志 (Update flag)
-} OpenMV_Data_t;
-
-/* FIFO 缓冲区定义 (FIFO Buffer Definition) */
-#define OPENMV_FIFO_SIZE 10 // 存储最近 10 个数据包
-typedef struct {
-    OpenMV_Data_t buffer[OPENMV_FIFO_SIZE];
-    volatile uint8_t head; // 写位置 (Write pos)
-    volatile uint8_t tail; // 读位置 (Read pos)
-    volatile uint8_t count; // 数据计数 (Data count)
-} OpenMV_FIFO_t;
+/* 帧队列：解析上下文写入，OpenMV_Print_Task 读出 (os_ring.h，容量须为 2 的幂) */
+#define OPENMV_FIFO_SIZE 16 // 存储最近 16 个数据包
 
 extern OpenMV_Data_t openmv_data;
-extern OpenMV_FIFO_t openmv_fifo;
 
 /* 函数原型 (Function Prototypes) */
-void OpenMV_Init(UART_HandleTypeDef *huart);
-void OpenMV_Rx_Callback(void); // 在 USART6 中断中调用
-void OpenMV_Parse_Callback(void); // 在 IDLE 中断中调用
+void OpenMV_Init(UART_HandleTypeDef *huart); // 启动 DMA 循环接收 (hdmarx 须为 DMA_CIRCULAR)
+void OpenMV_Rx_Callback(void); // 在 USART6 中断中调用 (IDLE)
+void OpenMV_Parse_Callback(void); // 解析环形缓冲中的新数据 (由接收事件投递到延后处理任务中执行)
 void OpenMV_Print_Task(void *arg); // OS 任务
+void OpenMV_Frame_Callback(const OpenMV_Data_t *data); // 新帧回调 (弱定义，应用层可重写)
+const OMV_Proto_Stats_t *OpenMV_Get_Stats(void); // 解码统计 (帧数/CRC 错误/丢帧)
+uint32_t OpenMV_Get_Overruns(void); // 接收环溢出次数
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,240 @@
+/**
+ * @file    Bsp_OpenMV_Proto.c
+ * @brief   OpenMV 串口协议解码实现
+ * @date    2026-02-19
+ */
+
+#include "Bsp_OpenMV_Proto.h"
+#include <stddef.h>
+#include <string.h>
+
+#define OMV_V1_HEAD     0xAAU
+#define OMV_V1_TAIL     0x55U
+#define OMV_V2_HEAD0    0xA5U
+#define OMV_V2_HEAD1    0x5AU
+#define OMV_V2_CRC_POS  2U      // CRC 覆盖 [2, 17)
+
+/* 候选帧检查结果 */
+typedef enum {
+    OMV_CHK_MORE = 0,   // 还不完整
+    OMV_CHK_FRAME,      // 有效帧
+    OMV_CHK_SKIP,       // 完整但不输出 (重复帧)，整帧丢弃
+    OMV_CHK_BAD         // 无效，丢掉帧头重新找
+} OMV_Chk_t;
+
+/* CRC-8，多项式 0x07 (x^8 + x^2 + x + 1)，初值 0 */
+const uint8_t omv_crc8_table[256] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+/* v2 字段表：线上位置、字节数、在 OpenMV_Data_t 中的偏移 (16 位字段为小端) */
+typedef struct {
+    uint8_t pos;
+    uint8_t size;
+    uint8_t offset;
+} OMV_Field_t;
+
+static const OMV_Field_t omv_v2_fields[] = {
+    {  3, 1, offsetof(OpenMV_Data_t, seq)   },
+    {  4, 2, offsetof(OpenMV_Data_t, ts_ms) },
+    {  6, 2, offsetof(OpenMV_Data_t, x)     },
+    {  8, 2, offsetof(OpenMV_Data_t, y)     },
+    { 10, 2, offsetof(OpenMV_Data_t, w)     },
+    { 12, 2, offsetof(OpenMV_Data_t, h)     },
+    { 14, 2, offsetof(OpenMV_Data_t, dist)  },
+    { 16, 1, offsetof(OpenMV_Data_t, conf)  },
+};
+
+#define OMV_V2_FIELDS   (sizeof(omv_v2_fields) / sizeof(omv_v2_fields[0]))
+
+/**
+ * @brief 初始化
+ */
+void OMV_Proto_Init(OMV_Proto_t *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+void OMV_Proto_Resync(OMV_Proto_t *p)
+{
+    p->len = 0;
+}
+
+uint8_t OMV_Proto_CRC8(uint8_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc = omv_crc8_table[crc ^ *data++];
+    }
+    return crc;
+}
+
+/**
+ * @brief 按 v2 格式打包一帧
+ */
+uint32_t OMV_Proto_Encode_V2(const OpenMV_Data_t *d, uint8_t *buf)
+{
+    const uint8_t *src = (const uint8_t *)d;
+    uint32_t i;
+
+    buf[0] = OMV_V2_HEAD0;
+    buf[1] = OMV_V2_HEAD1;
+    buf[2] = OMV_PROTO_V2_VERSION;
+    for (i = 0; i < OMV_V2_FIELDS; i++) {
+        const OMV_Field_t *f = &omv_v2_fields[i];
+        if (f->size == 1) {
+            buf[f->pos] = src[f->offset];
+        } else {
+            uint16_t v = *(const uint16_t *)(src + f->offset);
+            buf[f->pos]     = (uint8_t)v;
+            buf[f->pos + 1] = (uint8_t)(v >> 8);
+        }
+    }
+    buf[OMV_PROTO_V2_LEN - 1] = OMV_Proto_CRC8(0, &buf[OMV_V2_CRC_POS], OMV_PROTO_V2_LEN - 1 - OMV_V2_CRC_POS);
+    return OMV_PROTO_V2_LEN;
+}
+
+/**
+ * @brief 按字段表解出 v2 帧并检查序号
+ */
+static OMV_Chk_t OMV_Proto_Unpack_V2(OMV_Proto_t *p, OpenMV_Data_t *out)
+{
+    uint8_t *dst = (uint8_t *)out;
+    uint8_t gap;
+    uint32_t i;
+
+    memset(out, 0, sizeof(*out));
+    for (i = 0; i < OMV_V2_FIELDS; i++) {
+        const OMV_Field_t *f = &omv_v2_fields[i];
+        if (f->size == 1) {
+            dst[f->offset] = p->buf[f->pos];
+        } else {
+            *(uint16_t *)(dst + f->offset) = (uint16_t)(p->buf[f->pos] | (p->buf[f->pos + 1] << 8));
+        }
+    }
+    out->ver = 2;
+
+    gap = (uint8_t)(out->seq - p->last_seq);
+    if (p->have_seq && gap == 0) {
+        p->stats.dup++;
+        return OMV_CHK_SKIP;
+    }
+    if (p->have_seq) {
+        out->lost = (uint8_t)(gap - 1);
+        p->stats.lost += out->lost;
+    }
+    p->have_seq  = 1;
+    p->last_seq  = out->seq;
+    p->locked_v2 = 1;
+    p->v1_run    = 0;
+    p->stats.frames_v2++;
+    return OMV_CHK_FRAME;
+}
+
+/**
+ * @brief 检查 buf 开头的候选帧
+ */
+static OMV_Chk_t OMV_Proto_Check(OMV_Proto_t *p, OpenMV_Data_t *out)
+{
+    const uint8_t *b = p->buf;
+
+    if (b[0] == OMV_V2_HEAD0) {
+        if (p->len >= 2 && b[1] != OMV_V2_HEAD1) {
+            return OMV_CHK_BAD;
+        }
+        if (p->len >= 3 && b[2] != OMV_PROTO_V2_VERSION) {
+            p->stats.bad++;
+            return OMV_CHK_BAD;
+        }
+        if (p->len < OMV_PROTO_V2_LEN) {
+            return OMV_CHK_MORE;
+        }
+        if (OMV_Proto_CRC8(0, &b[OMV_V2_CRC_POS], OMV_PROTO_V2_LEN - OMV_V2_CRC_POS) != 0) {
+            p->stats.crc_err++;     // 数据连同 CRC 一起计算，结果为 0 表示正确
+            return OMV_CHK_BAD;
+        }
+        return OMV_Proto_Unpack_V2(p, out);
+    }
+
+    if (b[0] == OMV_V1_HEAD) {
+        if (p->len < OMV_PROTO_V1_LEN) {
+            return OMV_CHK_MORE;
+        }
+        if (b[3] != OMV_V1_TAIL) {
+            return OMV_CHK_BAD;
+        }
+        if (p->locked_v2) {
+            p->stats.bad++;
+            if (++p->v1_run < OMV_PROTO_V1_FALLBACK) {
+                return OMV_CHK_BAD;
+            }
+            p->locked_v2 = 0;       // 相机换回了 v1
+            p->have_seq  = 0;
+            p->stats.fallback++;
+        }
+        memset(out, 0, sizeof(*out));
+        out->x    = b[1];
+        out->dist = b[2];
+        out->conf = (b[1] == 0 && b[2] == 0) ? 0 : 255;
+        out->seq  = p->v1_seq++;
+        out->ver  = 1;
+        p->stats.frames_v1++;
+        return OMV_CHK_FRAME;
+    }
+
+    return OMV_CHK_BAD;
+}
+
+/**
+ * @brief 丢掉开头 n 个字节，并跳到下一个可能的帧头
+ */
+static void OMV_Proto_Drop(OMV_Proto_t *p, uint8_t n)
+{
+    while (n < p->len && p->buf[n] != OMV_V1_HEAD && p->buf[n] != OMV_V2_HEAD0) {
+        n++;
+    }
+    p->len = (uint8_t)(p->len - n);
+    memmove(p->buf, &p->buf[n], p->len);
+}
+
+/**
+ * @brief 输入一个字节
+ */
+uint8_t OMV_Proto_Feed(OMV_Proto_t *p, uint8_t byte, OpenMV_Data_t *out)
+{
+    if (p->len == 0 && byte != OMV_V1_HEAD && byte != OMV_V2_HEAD0) {
+        return 0;   // 帧间空闲字节
+    }
+    p->buf[p->len++] = byte;
+
+    while (p->len > 0) {
+        switch (OMV_Proto_Check(p, out)) {
+            case OMV_CHK_MORE:
+                return 0;
+            case OMV_CHK_FRAME:
+                OMV_Proto_Drop(p, (out->ver == 2) ? OMV_PROTO_V2_LEN : OMV_PROTO_V1_LEN);
+                return 1;
+            case OMV_CHK_SKIP:
+                OMV_Proto_Drop(p, OMV_PROTO_V2_LEN);
+                break;
+            default:
+                OMV_Proto_Drop(p, 1);
+                break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file    Bsp_OpenMV_Proto.h
+ * @brief   OpenMV 串口协议解码 (v1 / v2 自动识别)
+ * @note    - v1：4 字节 `0xAA x dist 0x55`，无校验，x、dist 各 8 位
+ *          - v2：18 字节，小端：
+ *              0  0xA5  1  0x5A   帧头
+ *              2  版本 (0x02)
+ *              3  序号 seq (每帧 +1，回绕)
+ *              4  相机时间戳 ts (ms，16 位回绕)
+ *              6  x    8  y    10 w    12 h      目标框 (像素，各 16 位)
+ *              14 dist (cm，16 位)
+ *              16 conf 置信度 (0 = 未找到目标)
+ *              17 CRC-8 (多项式 0x07，初值 0，覆盖字节 2..16)
+ *          - 上电按 v1/v2 同时识别；收到一帧校验通过的 v2 后锁定 v2，不再接受无校验的 v1
+ *            (v2 数据中可能恰好出现 AA .. .. 55)；锁定期间连续 OMV_PROTO_V1_FALLBACK 个
+ *            完整 v1 帧而没有 v2 帧时解锁，兼容换回 v1 脚本的相机
+ *          - v2 按序号统计丢帧，重复帧 (序号不变) 丢弃
+ *          - 纯计算模块，无硬件依赖，上位机 tools/openmv_proto_bench.c 直接链接
+ * @date    2026-02-19
+ */
+
+#ifndef __BSP_OPENMV_PROTO_H__
+#define __BSP_OPENMV_PROTO_H__
+
+#include <stdint.h>
+
+/* 配置项 */
+#define OMV_PROTO_V1_LEN        4U
+#define OMV_PROTO_V2_LEN        18U
+#define OMV_PROTO_V2_VERSION    0x02U
+#define OMV_PROTO_V1_FALLBACK   8U      // 锁定 v2 后，连续多少个 v1 帧视为相机换回 v1
+
+/* OpenMV 数据结构 (OpenMV Data Structure) */
+typedef struct {
+    uint16_t x;         // X 坐标 (像素，v1 为 0-160)
+    uint16_t y;         // Y 坐标 (v1 为 0)
+    uint16_t w;         // 目标框宽 (v1 为 0)
+    uint16_t h;         // 目标框高 (v1 为 0)
+    uint16_t dist;      // 距离 (cm)
+    uint16_t ts_ms;     // 相机时间戳 (ms，16 位回绕；v1 为 0)
+    uint8_t  seq;       // 帧序号 (v1 为本地计数)
+    uint8_t  conf;      // 置信度，0 表示未找到目标 (v1：x、dist 全 0 时为 0，否则 255)
+    uint8_t  ver;       // 协议版本 1 / 2
+    uint8_t  lost;      // 与上一帧之间丢失的帧数 (仅 v2)
+    uint32_t rx_cyc;    // 最后一个字节的接收时刻 (DWT 周期，由 Bsp_OpenMV 填写，解码器置 0)
+} OpenMV_Data_t;
+
+/**
+ * @brief 解码统计
+ */
+typedef struct {
+    uint32_t frames_v1;     // 收到的 v1 帧
+    uint32_t frames_v2;     // 收到的 v2 帧 (不含重复帧)
+    uint32_t crc_err;       // v2 CRC 错误
+    uint32_t bad;           // 其他丢弃的候选帧 (包尾/版本错误，锁定 v2 时的 v1 帧)
+    uint32_t lost;          // 按序号推算的丢帧数
+    uint32_t dup;           // 重复帧
+    uint32_t fallback;      // v2 -> v1 解锁次数
+} OMV_Proto_Stats_t;
+
+/**
+ * @brief 解码器状态
+ */
+typedef struct {
+    uint8_t  buf[OMV_PROTO_V2_LEN];     // 当前候选帧 (buf[0] 总是帧头)
+    uint8_t  len;
+    uint8_t  locked_v2;                 // 1 只接受 v2
+    uint8_t  v1_run;                    // 锁定期间连续的 v1 帧数
+    uint8_t  have_seq;
+    uint8_t  last_seq;
+    uint8_t  v1_seq;
+    OMV_Proto_Stats_t stats;
+} OMV_Proto_t;
+
+extern const uint8_t omv_crc8_table[256];
+
+/**
+ * @brief 初始化 (v1/v2 自动识别)
+ */
+void OMV_Proto_Init(OMV_Proto_t *p);
+
+/**
+ * @brief 丢弃当前候选帧 (输入流不连续时调用)，锁定状态和统计保留
+ * @note  帧序号照常连续检查，跳过的帧计入 lost
+ */
+void OMV_Proto_Resync(OMV_Proto_t *p);
+
+/**
+ * @brief 输入一个字节
+ * @param out 解出一帧时写入
+ * @return 1 解出一帧；0 没有
+ * @note  候选帧校验失败时从其第二个字节起重新找帧头，不丢失嵌在其中的真实帧
+ */
+uint8_t OMV_Proto_Feed(OMV_Proto_t *p, uint8_t byte, OpenMV_Data_t *out);
+
+/**
+ * @brief CRC-8 (多项式 0x07，查表)
+ */
+uint8_t OMV_Proto_CRC8(uint8_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief 按 v2 格式打包一帧 (上位机测试/相机脚本参考)
+ * @return 帧长 OMV_PROTO_V2_LEN
+ */
+uint32_t OMV_Proto_Encode_V2(const OpenMV_Data_t *d, uint8_t *buf);
+
+#endif /* __BSP_OPENMV_PROTO_H__ */
@@ -0,0 +1,198 @@
+/**
+ * @file    autotune_sim.c
+ * @brief   上位机仿真：验证继电反馈自整定 (Core/Algo/pid_autotune.c) 在速度环上收敛
+ * @note    被控对象按固件速度环建模：1kHz 节拍，PWM 死区 + 一阶电机 + 库仑摩擦，
+ *          编码器计数取整后按 10 拍滑动窗口测速 (同 Bsp_Encoder)。
+ *          对每组电机参数：
+ *            1. 运行自整定，打印 Ku、Tu 及收敛用时
+ *            2. 与无量化线性模型按频率响应求出的临界点对比 (带回差的继电器测到的是
+ *               相位 -180°+asin(h/a) 处的点，Ku 偏小、Tu 偏长，整定结果偏保守)
+ *            3. 用整定出的增益 (PID_Bank，与 PID_Update 同算法) 做阶跃，打印超调和调节时间
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Algo -o autotune_sim tools/autotune_sim.c \
+ *                Core/Algo/pid_autotune.c Core/Algo/pid_bank.c -lm
+ *          使用：
+ *            ./autotune_sim [规则 0..3]      规则见 PID_AT_Rule_t，默认 0 (PI TL)
+ */
+
+#include "pid_autotune.h"
+#include "pid_bank.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIM_HZ          1000        // 速度环频率
+#define SIM_SUBSTEPS    20          // 每节拍的积分子步
+#define SIM_CPR         2200.0      // 每转编码器计数 (同 Bsp_Encoder)
+#define SIM_WINDOW      10          // 测速滑动窗口 (节拍)
+#define SIM_PWM_MAX     4200.0f
+
+#define AT_SETPOINT     120.0f      // 以下与固件 App_Follow_AutoTune_Start 相同
+#define AT_RELAY        1200.0f
+#define AT_HYST         3.0f
+#define AT_TIMEOUT      10.0f
+
+/* 电机模型 */
+typedef struct {
+    const char *name;
+    double K;       // 稳态增益 (RPM / 有效 PWM)
+    double tau;     // 机械时间常数 (s)
+    double dead;    // PWM 死区
+    double fc;      // 库仑摩擦 (RPM 当量)
+} Motor_Model_t;
+
+typedef struct {
+    const Motor_Model_t *m;
+    double w;                       // 转速 (RPM)
+    double pos;                     // 累计计数
+    long   last_cnt;
+    int    hist[SIM_WINDOW];
+    int    idx;
+    int    sum;
+} Sim_t;
+
+static void Sim_Reset(Sim_t *s, const Motor_Model_t *m)
+{
+    *s = (Sim_t){ 0 };
+    s->m = m;
+}
+
+/**
+ * @brief 推进一个节拍，返回测得转速 (RPM)
+ */
+static float Sim_Tick(Sim_t *s, float u)
+{
+    const double h = 1.0 / SIM_HZ / SIM_SUBSTEPS;
+    double ue = (fabs(u) > s->m->dead) ? (u > 0 ? u - s->m->dead : u + s->m->dead) : 0.0;
+    int i;
+
+    for (i = 0; i < SIM_SUBSTEPS; i++) {
+        double drive = s->m->K * ue;
+        double fr = (s->w > 0.0) ? s->m->fc : ((s->w < 0.0) ? -s->m->fc : 0.0);
+        if (s->w == 0.0 && fabs(drive) <= s->m->fc) {
+            continue;                               // 静止且驱动不足以克服摩擦
+        }
+        double nw = s->w + h * (drive - fr - s->w) / s->m->tau;
+        if (s->w != 0.0 && (nw > 0.0) != (s->w > 0.0) && fabs(drive) <= s->m->fc) {
+            nw = 0.0;
+        }
+        s->w = nw;
+        s->pos += s->w / 60.0 * SIM_CPR * h;
+    }
+
+    long cnt = (long)floor(s->pos);
+    int d = (int)(cnt - s->last_cnt);
+    s->last_cnt = cnt;
+    s->sum += d - s->hist[s->idx];
+    s->hist[s->idx] = d;
+    s->idx = (s->idx + 1) % SIM_WINDOW;
+    return (float)(s->sum * 60.0 / (SIM_CPR * SIM_WINDOW / (double)SIM_HZ));
+}
+
+/**
+ * @brief 线性化离散回路 (ZOH 一阶 + 采样延迟 + 滑动平均) 的临界增益与周期
+ */
+static void Linear_Ultimate(const Motor_Model_t *m, double *ku, double *tu)
+{
+    const double T = 1.0 / SIM_HZ;
+    const double a = exp(-T / m->tau);
+    double w, prev_ph = 0.0;
+
+    for (w = 1.0; w < M_PI / T; w += 0.05) {
+        /* 一阶 ZOH：K(1-a) z^-1 / (1 - a z^-1)，位置差分测速 ≈ 速度的 SIM_WINDOW 拍平均 */
+        double re_n = m->K * (1 - a) * cos(-w * T), im_n = m->K * (1 - a) * sin(-w * T);
+        double re_d = 1 - a * cos(-w * T), im_d = -a * sin(-w * T);
+        double g_re = (re_n * re_d + im_n * im_d) / (re_d * re_d + im_d * im_d);
+        double g_im = (im_n * re_d - re_n * im_d) / (re_d * re_d + im_d * im_d);
+        double f_re = 0, f_im = 0;
+        int k;
+        for (k = 0; k < SIM_WINDOW; k++) {
+            f_re += cos(-w * T * (k + 0.5)) / SIM_WINDOW;   // 平均的是两次采样之间的速度
+            f_im += sin(-w * T * (k + 0.5)) / SIM_WINDOW;
+        }
+        double l_re = g_re * f_re - g_im * f_im;
+        double l_im = g_re * f_im + g_im * f_re;
+        double ph = atan2(l_im, l_re);
+        if (w > 1.0 && prev_ph < 0.0 && ph > 0.0 && prev_ph < -M_PI / 2) {   // 相位越过 -180°
+            *ku = 1.0 / sqrt(l_re * l_re + l_im * l_im);
+            *tu = 2.0 * M_PI / w;
+            return;
+        }
+        prev_ph = ph;
+    }
+    *ku = *tu = 0.0;
+}
+
+/**
+ * @brief 阶跃测试：0 -> AT_SETPOINT，返回超调 (RPM) 和进入 ±5% 的时间 (s)
+ */
+static void Step_Test(const Motor_Model_t *m, const PID_AT_t *at, double *os, double *ts)
+{
+    Sim_t s;
+    PID_Bank_t bank;
+    float tgt[1] = { AT_SETPOINT }, act[1];
+    int i, n = 2 * SIM_HZ;
+    double peak = 0.0, settle = 0.0;
+
+    Sim_Reset(&s, m);
+    PID_Bank_Init(&bank, 1);
+    PID_Bank_SetGains(&bank, 0, at->Kp, at->Ki, at->Kd, SIM_PWM_MAX, 2000.0f);
+    act[0] = 0.0f;
+    for (i = 0; i < n; i++) {
+        PID_Bank_Update(&bank, tgt, act, 1.0f / SIM_HZ);
+        act[0] = Sim_Tick(&s, bank.output[0]);
+        if (s.w > peak) peak = s.w;
+        if (fabs(s.w - AT_SETPOINT) > 0.05 * AT_SETPOINT) settle = (i + 1) / (double)SIM_HZ;
+    }
+    *os = peak - AT_SETPOINT;
+    *ts = settle;
+}
+
+int main(int argc, char **argv)
+{
+    static const Motor_Model_t motors[] = {
+        { "nominal",   300.0 / 4200, 0.040, 300, 15 },
+        { "slow",      300.0 / 4200, 0.080, 300, 15 },
+        { "fast",      300.0 / 4200, 0.020, 300, 15 },
+        { "weak",      200.0 / 4200, 0.040, 500, 25 },
+        { "strong",    450.0 / 4200, 0.050, 200, 10 },
+    };
+    PID_AT_Rule_t rule = (argc > 1) ? (PID_AT_Rule_t)atoi(argv[1]) : PID_AT_RULE_PI_TL;
+    int failed = 0;
+    size_t i;
+
+    printf("rule %s, setpoint %.0f rpm, relay %.0f PWM, hyst %.1f rpm\n",
+           PID_AT_RuleName(rule), AT_SETPOINT, AT_RELAY, AT_HYST);
+    printf("%-8s %8s %8s %8s %8s %7s | %8s %7s | %7s %7s %7s | %7s %7s\n",
+           "motor", "state", "time s", "Ku", "Tu ms", "bias", "Ku lin", "Tu lin", "Kp", "Ki", "Kd", "OS rpm", "ts ms");
+
+    for (i = 0; i < sizeof(motors) / sizeof(motors[0]); i++) {
+        const Motor_Model_t *m = &motors[i];
+        Sim_t s;
+        PID_AT_t at;
+        PID_AT_State_t st;
+        float y = 0.0f, u;
+        double ku_lin, tu_lin, os = 0.0, ts = 0.0;
+
+        Sim_Reset(&s, m);
+        PID_AT_Init(&at, AT_SETPOINT, AT_RELAY, AT_RELAY, AT_HYST, 0.0f, SIM_PWM_MAX,
+                    1.0f / SIM_HZ, AT_TIMEOUT, rule);
+        do {
+            st = PID_AT_Step(&at, y, &u);
+            y = Sim_Tick(&s, u);
+        } while (st == PID_AT_RUNNING);
+
+        Linear_Ultimate(m, &ku_lin, &tu_lin);
+        if (st == PID_AT_DONE) {
+            Step_Test(m, &at, &os, &ts);
+        } else {
+            failed++;
+        }
+        printf("%-8s %8s %8.2f %8.1f %8.1f %7.0f | %8.1f %7.1f | %7.2f %7.2f %7.2f | %7.1f %7.0f\n",
+               m->name, (st == PID_AT_DONE) ? "done" : "FAILED", at.ticks / (double)SIM_HZ,
+               at.Ku, at.Tu * 1000.0, at.bias, ku_lin, tu_lin * 1000.0,
+               at.Kp, at.Ki, at.Kd, os, ts * 1000.0);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file    openmv_proto_bench.c
+ * @brief   上位机测试：OpenMV 协议解码 (Core/Bsp/Bsp_OpenMV_Proto.c) 的模糊测试与吞吐
+ * @note    1. 功能：v2 帧逐字段往返、丢帧/重复帧计数、v1 <-> v2 自动识别与回退
+ *          2. 模糊：有效帧之间插入随机垃圾、随机翻转单个比特，检查
+ *             - 所有未被破坏的帧都被解出且内容一致 (嵌在垃圾里也不丢)
+ *             - 被破坏的 v2 帧一个都不会被当作有效帧 (CRC-8 检出所有单比特错误)
+ *             - 纯随机字节流解出的伪帧数 (v2 与无校验的 v1 分开统计)
+ *          3. 吞吐：连续 v2 / v1 流，每字节耗时及每秒帧数
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Bsp -o openmv_proto_bench tools/openmv_proto_bench.c \
+ *                Core/Bsp/Bsp_OpenMV_Proto.c
+ *          使用：
+ *            ./openmv_proto_bench [随机种子]
+ */
+
+#include "Bsp_OpenMV_Proto.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FUZZ_FRAMES     200000
+#define BENCH_FRAMES    2000000
+
+static int failed;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); failed++; } } while (0)
+
+static uint32_t rng_state = 1;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void Random_Frame(OpenMV_Data_t *d, uint8_t seq)
+{
+    memset(d, 0, sizeof(*d));
+    d->seq   = seq;
+    d->ts_ms = (uint16_t)Rand();
+    d->x     = (uint16_t)(Rand() % 320);
+    d->y     = (uint16_t)(Rand() % 240);
+    d->w     = (uint16_t)(Rand() % 320);
+    d->h     = (uint16_t)(Rand() % 240);
+    d->dist  = (uint16_t)(Rand() % 400);
+    d->conf  = (uint8_t)Rand();
+    d->ver   = 2;
+}
+
+static int Same(const OpenMV_Data_t *a, const OpenMV_Data_t *b)
+{
+    return a->seq == b->seq && a->ts_ms == b->ts_ms && a->x == b->x && a->y == b->y &&
+           a->w == b->w && a->h == b->h && a->dist == b->dist && a->conf == b->conf && a->ver == b->ver;
+}
+
+/* 输入一段字节，返回解出的帧数，帧写入 out (最多 max 个) */
+static int Feed(OMV_Proto_t *p, const uint8_t *buf, int n, OpenMV_Data_t *out, int max)
+{
+    OpenMV_Data_t d;
+    int i, got = 0;
+
+    for (i = 0; i < n; i++) {
+        if (OMV_Proto_Feed(p, buf[i], &d)) {
+            if (got < max) out[got] = d;
+            got++;
+        }
+    }
+    return got;
+}
+
+static void Test_Basic(void)
+{
+    OMV_Proto_t p;
+    OpenMV_Data_t in, out[4];
+    uint8_t buf[64];
+    static const uint8_t v1[] = { 0xAA, 80, 25, 0x55 };
+    int i, n;
+
+    /* CRC-8/SMBUS 标准校验值 */
+    CHECK(OMV_Proto_CRC8(0, (const uint8_t *)"123456789", 9) == 0xF4, "crc8 check value");
+
+    /* v2 往返 */
+    OMV_Proto_Init(&p);
+    Random_Frame(&in, 7);
+    n = (int)OMV_Proto_Encode_V2(&in, buf);
+    CHECK(Feed(&p, buf, n, out, 4) == 1 && Same(&in, &out[0]), "v2 round trip");
+
+    /* 丢 2 帧、重复 1 帧 */
+    in.seq = 10;
+    OMV_Proto_Encode_V2(&in, buf);
+    CHECK(Feed(&p, buf, n, out, 4) == 1 && out[0].lost == 2, "lost count %u", out[0].lost);
+    CHECK(Feed(&p, buf, n, out, 4) == 0 && p.stats.dup == 1, "duplicate dropped");
+
+    /* 锁定 v2 后 v1 帧被忽略，连续 OMV_PROTO_V1_FALLBACK 个后回退 */
+    for (i = 0; i < (int)OMV_PROTO_V1_FALLBACK - 1; i++) {
+        CHECK(Feed(&p, v1, 4, out, 4) == 0, "v1 ignored while locked (%d)", i);
+    }
+    CHECK(Feed(&p, v1, 4, out, 4) == 1 && out[0].ver == 1 && out[0].x == 80 && out[0].dist == 25,
+          "fallback to v1");
+    CHECK(p.stats.fallback == 1, "fallback count");
+
+    /* v1 -> v2 立即切换 */
+    in.seq = 0;
+    OMV_Proto_Encode_V2(&in, buf);
+    CHECK(Feed(&p, buf, n, out, 4) == 1 && out[0].ver == 2 && out[0].lost == 0, "v1 -> v2");
+
+    /* v2 数据里恰好出现 AA .. .. 55：锁定后不得解出 v1 */
+    in.seq = 1;
+    in.x = 0x55AA;
+    in.y = 0xAA55;
+    in.w = 0x0055;
+    OMV_Proto_Encode_V2(&in, buf);
+    CHECK(Feed(&p, buf, n, out, 4) == 1 && Same(&in, &out[0]), "v2 payload with v1 pattern");
+
+    /* v1 丢目标 */
+    OMV_Proto_Init(&p);
+    buf[0] = 0xAA; buf[1] = 0; buf[2] = 0; buf[3] = 0x55;
+    CHECK(Feed(&p, buf, 4, out, 4) == 1 && out[0].conf == 0, "v1 no target");
+}
+
+/**
+ * @brief 模糊测试：帧间垃圾 + 单比特翻转
+ */
+static void Test_Fuzz(void)
+{
+    static uint8_t stream[FUZZ_FRAMES * 40];
+    static OpenMV_Data_t sent[FUZZ_FRAMES], got[FUZZ_FRAMES + 1024];
+    static uint8_t intact[FUZZ_FRAMES];
+    OMV_Proto_t p;
+    int i, n = 0, ng, k = 0, n_intact = 0, n_hit = 0, spurious = 0;
+
+    for (i = 0; i < FUZZ_FRAMES; i++) {
+        int g = (int)(Rand() % 8), j;
+        uint8_t frame[OMV_PROTO_V2_LEN];
+
+        for (j = 0; j < g; j++) {
+            stream[n++] = (uint8_t)Rand();      // 垃圾 (可能含帧头)
+        }
+        Random_Frame(&sent[i], (uint8_t)i);
+        OMV_Proto_Encode_V2(&sent[i], frame);
+        intact[i] = (Rand() % 4) != 0;
+        if (!intact[i]) {
+            uint32_t bit = Rand() % (OMV_PROTO_V2_LEN * 8);
+            frame[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+        }
+        n_intact += intact[i];
+        memcpy(&stream[n], frame, OMV_PROTO_V2_LEN);
+        n += OMV_PROTO_V2_LEN;
+    }
+
+    OMV_Proto_Init(&p);
+    ng = Feed(&p, stream, n, got, FUZZ_FRAMES + 1024);
+
+    /* 按序匹配：每个解出的帧必须是某个发送帧，且被破坏的帧不能出现 */
+    for (i = 0; i < ng && i < FUZZ_FRAMES + 1024; i++) {
+        if (got[i].ver != 2) {
+            continue;   // 锁定前垃圾凑出的 v1 帧 (v1 无校验，允许)
+        }
+        while (k < FUZZ_FRAMES && !Same(&sent[k], &got[i])) {
+            k++;
+        }
+        if (k == FUZZ_FRAMES) {
+            spurious++;
+            k = 0;
+            continue;
+        }
+        CHECK(intact[k], "corrupted frame %d accepted", k);
+        n_hit++;
+        k++;
+    }
+    printf("fuzz: %d frames (%d intact), %d bytes, decoded %d, matched %d, spurious %d\n",
+           FUZZ_FRAMES, n_intact, n, ng, n_hit, spurious);
+    printf("      crc_err %u bad %u lost %u dup %u v1 %u\n", p.stats.crc_err, p.stats.bad,
+           p.stats.lost, p.stats.dup, p.stats.frames_v1);
+    CHECK(n_hit == n_intact, "missed %d intact frames", n_intact - n_hit);
+    CHECK(spurious == 0, "spurious frames");
+
+    /* 纯随机字节流：v2 伪帧需 A5 5A 02 且 CRC 恰好为 0 (约 2^-32 每字节)；
+     * v1 无校验，约 2^-16 每字节，连续 OMV_PROTO_V1_FALLBACK 个后解锁回 v1 */
+    {
+        int bytes = 50 * 1000 * 1000, fake[3] = { 0 };
+        OpenMV_Data_t d;
+        for (i = 0; i < bytes; i++) {
+            if (OMV_Proto_Feed(&p, (uint8_t)Rand(), &d)) {
+                fake[d.ver]++;
+            }
+        }
+        printf("noise: %d random bytes -> false frames v2 %d, v1 %d (fallback %u)\n",
+               bytes, fake[2], fake[1], p.stats.fallback);
+        CHECK(fake[2] < 5, "v2 false frames from noise");
+    }
+}
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 吞吐：连续流逐字节输入
+ */
+static void Bench(int v2)
+{
+    static uint8_t stream[BENCH_FRAMES * OMV_PROTO_V2_LEN];
+    OMV_Proto_t p;
+    OpenMV_Data_t d;
+    volatile uint32_t sink = 0;
+    int i, n = 0, frames = 0;
+    double t0, t;
+
+    for (i = 0; i < BENCH_FRAMES; i++) {
+        if (v2) {
+            Random_Frame(&d, (uint8_t)i);
+            n += (int)OMV_Proto_Encode_V2(&d, &stream[n]);
+        } else {
+            stream[n++] = 0xAA;
+            stream[n++] = (uint8_t)(Rand() % 161);
+            stream[n++] = (uint8_t)Rand();
+            stream[n++] = 0x55;
+        }
+    }
+
+    OMV_Proto_Init(&p);
+    t0 = Now();
+    for (i = 0; i < n; i++) {
+        if (OMV_Proto_Feed(&p, stream[i], &d)) {
+            frames++;
+            sink += d.x;
+        }
+    }
+    t = Now() - t0;
+    (void)sink;
+    printf("bench v%d: %d bytes, %d frames, %.1f ns/byte, %.2f Mframe/s\n",
+           v2 ? 2 : 1, n, frames, t * 1e9 / n, frames / t * 1e-6);
+    CHECK(frames == BENCH_FRAMES, "bench frames %d", frames);
+}
+
+int main(int argc, char **argv)
+{
+    rng_state = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 0x12345678U;
+    if (rng_state == 0) rng_state = 1;
+
+    Test_Basic();
+    Test_Fuzz();
+    Bench(0);
+    Bench(1);
+
+    printf("%s\n", failed ? "FAILED" : "all passed");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file    os_edf_sim.c
+ * @brief   上位机仿真测试：固定优先级与 EDF 在过载下的截止时刻错过率，EDF 准入与降级
+ * @note    把 os.c 直接包含进来，用仿真时钟代替 DWT 与 SysTick：任务"执行"即推进
+ *          仿真时钟，越过 tick 边界时调用 OS_Tick (协同式调度，任务不会被抢占)。
+ *
+ *          1. 错过率对比：四个周期任务 T = 5/8/13/40 tick，D = T，固定优先级按
+ *             速率单调分配 (周期越短优先级越高)；总利用率 U 按 35/30/25/10% 分给
+ *             各任务 (长周期任务的 WCET 不超过最短周期，非抢占阻塞不至于主导结果)，
+ *             每次实际执行时间在 [0.9, 1.0] * WCET 内随机。错过率 = (完成时超过截止
+ *             时刻的作业 + 整周期被跳过的释放) / 释放总数；错过率对比时不做准入
+ *          2. (仅 EDF) 准入与降级：
+ *             - 还没有任何实测数据时，声明 WCET 的总密度超过上限即拒绝
+ *             - 实测执行时间超出声明值使总密度超限的任务降级为固定优先级
+ *          3. (仅 EDF) 两个一直就绪的 EDF 任务下，中断每 3 tick 投递一次延后工作，
+ *             检查延后处理任务 (优先级 OS_CFG_DEFER_PRIO) 不被饿死
+ *          检查项不满足时返回非 0。
+ *
+ *          编译 (Linux，在仓库根目录执行；调度策略是编译期选项，两种各编一次)：
+ *            gcc -O2 -ICore/App -DOS_CFG_SCHED_POLICY=0 -o os_edf_sim_fp  tools/os_edf_sim.c
+ *            gcc -O2 -ICore/App -DOS_CFG_SCHED_POLICY=1 -o os_edf_sim_edf tools/os_edf_sim.c
+ *          使用：
+ *            ./os_edf_sim_fp; ./os_edf_sim_edf
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* ---------------- 仿真时钟 ---------------- */
+
+#define SIM_CPT             168000U     // 每 tick 周期数 (168MHz，1ms)
+#define SIM_TICKS           1000000U    // 错过率对比的仿真时长 (tick)
+
+static uint64_t sim_now;
+static void (*sim_isr)(void);           // 每个 tick 中断里额外执行 (可为空)
+static uint32_t sim_admit = 1000U;      // 准入上限 (错过率对比时放开，测不做准入时的行为)
+
+#define OS_CFG_EDF_ADMIT_PERMILLE   sim_admit
+
+#define OS_CRITICAL_ALLOC()     uint32_t os_primask = 0; (void)os_primask
+#define OS_ENTER_CRITICAL()     do { } while (0)
+#define OS_EXIT_CRITICAL()      do { } while (0)
+#define OS_CLZ(x)               __builtin_clz(x)
+#define OS_CYCLE_COUNT()        ((uint32_t)sim_now)
+#define OS_CYCLES_PER_TICK()    SIM_CPT
+#define OS_MEMORY_BARRIER()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#include "os.c"
+
+/**
+ * @brief 推进仿真时钟，越过的每个 tick 边界执行一次 tick 中断
+ */
+static void Sim_Run(uint64_t cycles)
+{
+    uint64_t end = sim_now + cycles;
+
+    while ((sim_now / SIM_CPT + 1U) * SIM_CPT <= end) {
+        sim_now = (sim_now / SIM_CPT + 1U) * SIM_CPT;
+        OS_Tick();
+        if (sim_isr) {
+            sim_isr();
+        }
+    }
+    sim_now = end;
+}
+
+/* 空闲：睡到下一个 tick 中断，tick 已在中断中计入 */
+uint32_t OS_PortSleep(uint32_t expectedTicks)
+{
+    (void)expectedTicks;
+    Sim_Run((sim_now / SIM_CPT + 1U) * SIM_CPT - sim_now);
+    return 0;
+}
+
+/* 调度到仿真时刻 end_tick */
+static void Sim_Schedule(uint32_t end_tick)
+{
+    while (OS_GetTickCount() < end_tick) {
+        OS_ScheduleOnce();
+        if (OS_NO_READY_TASK()) {
+            OS_Idle();
+        }
+    }
+}
+
+static void Sim_Reset(void)
+{
+    sim_now = 0;
+    sim_isr = 0;
+    sim_admit = 1000U;
+    OS_Init();
+}
+
+/* ---------------- 随机数 ---------------- */
+
+static uint32_t rng_state = 0x2545F491U;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---------------- 1. 错过率对比 ---------------- */
+
+#define BENCH_TASKS     4
+
+static const uint32_t bench_period[BENCH_TASKS] = { 5, 8, 13, 40 };
+static const double   bench_share[BENCH_TASKS]  = { 0.35, 0.30, 0.25, 0.10 };
+static uint64_t       bench_wcet[BENCH_TASKS];      // 周期
+
+static void Bench_Task(void *arg)
+{
+    uint64_t c = bench_wcet[(uintptr_t)arg];
+
+    Sim_Run(c * 9U / 10U + Rand() % (c / 10U + 1U));
+}
+
+/**
+ * @brief 运行一种利用率，打印总错过率和各任务错过率
+ */
+static void Bench_Run(double u)
+{
+    uint32_t i, jobs = 0, misses = 0;
+    double rate[BENCH_TASKS];
+    OS_TaskStats_t st;
+    int32_t id[BENCH_TASKS];
+
+    Sim_Reset();
+    sim_admit = 0xFFFFFFFFU;
+    for (i = 0; i < BENCH_TASKS; i++) {
+        bench_wcet[i] = (uint64_t)(u * bench_share[i] * bench_period[i] * SIM_CPT);
+        id[i] = OS_CreatePeriodicTask(Bench_Task, (void *)(uintptr_t)i,
+                                      (uint8_t)(10 - i), bench_period[i], 0);
+        OS_SetTaskDeadline(id[i], bench_period[i], (uint32_t)(bench_wcet[i] * 1000U / SIM_CPT));
+    }
+    Sim_Schedule(SIM_TICKS);
+
+    for (i = 0; i < BENCH_TASKS; i++) {
+        OS_GetTaskStats(id[i], &st);
+        jobs   += st.runCount + st.overruns;
+        misses += st.deadlineMisses + st.overruns;
+        rate[i] = 100.0 * (st.deadlineMisses + st.overruns) / (st.runCount + st.overruns);
+    }
+    printf("  %.2f  %5.1f%%   %5.1f%% %5.1f%% %5.1f%% %5.1f%%\n", u, 100.0 * misses / jobs,
+           rate[0], rate[1], rate[2], rate[3]);
+}
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+/* ---------------- 2. 准入与降级 ---------------- */
+
+static uint32_t hog_cycles;
+
+static void Hog_Task(void *arg)
+{
+    (void)arg;
+    Sim_Run(hog_cycles);
+}
+
+static int Check_Admission(void)
+{
+    int fail = 0;
+    int32_t a, b, c;
+    int32_t ret;
+    OS_TaskStats_t st;
+
+    Sim_Reset();
+    a = OS_CreatePeriodicTask(Hog_Task, 0, 1, 10, 0);
+    b = OS_CreatePeriodicTask(Hog_Task, 0, 1, 10, 0);
+    c = OS_CreatePeriodicTask(Hog_Task, 0, 1, 10, 0);
+
+    /* 尚无实测数据：只能按声明值准入，600‰ + 500‰ 超限 */
+    ret = OS_SetTaskDeadline(a, 10, 6000);
+    printf("  declared 600 permille: %s\n", ret == OS_OK ? "admitted" : "rejected");
+    fail |= (ret != OS_OK);
+    ret = OS_SetTaskDeadline(b, 10, 5000);
+    printf("  declared +500 permille before any run: %s\n", ret == OS_OK ? "admitted" : "rejected");
+    fail |= (ret != OS_ERR_ADMIT);
+
+    /* 声明 100‰ 被接受，但实际每次执行 5 tick (500‰)：跑过一次即按实测值重新准入而降级 */
+    OS_DeleteTask(b);
+    ret = OS_SetTaskDeadline(c, 10, 1000);
+    fail |= (ret != OS_OK);
+    hog_cycles = 5U * SIM_CPT;
+    Sim_Schedule(100);
+    OS_GetTaskStats(c, &st);
+    printf("  declared 100 permille, measured %lu cycles (%lu permille): %s, density %lu permille\n",
+           (unsigned long)st.wcetCycles, (unsigned long)(st.wcetCycles * 100U / SIM_CPT),
+           st.edfDemoted ? "demoted" : "kept", (unsigned long)OS_GetDeadlineDensity());
+    fail |= (st.edfDemoted == 0);
+    fail |= (OS_GetDeadlineDensity() > OS_CFG_EDF_ADMIT_PERMILLE);
+    return fail;
+}
+
+/* ---------------- 3. 延后处理任务不被 EDF 饿死 ---------------- */
+
+static uint32_t defer_posted, defer_done;
+
+static void Defer_Work(void *arg)
+{
+    (void)arg;
+    defer_done++;
+}
+
+static void Defer_Isr(void)
+{
+    if (OS_GetTickCount() % 3U == 0 && OS_DeferPost(Defer_Work, 0) == OS_OK) {
+        defer_posted++;
+    }
+}
+
+static void Busy_Task(void *arg)
+{
+    (void)arg;
+    Sim_Run(SIM_CPT * 2U / 3U);
+}
+
+static int Check_Defer(void)
+{
+    uint32_t dropped, latency;
+
+    Sim_Reset();
+    OS_SetTaskDeadline(OS_CreateTask(Busy_Task, 0, 1), 5, 0);
+    OS_SetTaskDeadline(OS_CreateTask(Busy_Task, 0, 1), 8, 0);
+    sim_isr = Defer_Isr;
+    Sim_Schedule(100000);
+    OS_GetDeferStats(&dropped, &latency);
+    printf("  defer posted %lu done %lu dropped %lu, max latency %.2f ticks\n",
+           (unsigned long)defer_posted, (unsigned long)defer_done, (unsigned long)dropped,
+           (double)latency / SIM_CPT);
+    return dropped != 0 || defer_posted - defer_done > 1U || latency > SIM_CPT;
+}
+#endif
+
+int main(void)
+{
+    static const double util[] = { 0.80, 0.90, 0.95, 1.00, 1.05, 1.10, 1.20, 1.40 };
+    uint32_t i;
+    int fail = 0;
+
+    printf("== %s: deadline miss rate, T = 5/8/13/40, D = T, %u ticks\n",
+           OS_CFG_SCHED_POLICY == OS_SCHED_EDF ? "EDF" : "fixed priority (RM)", SIM_TICKS);
+    printf("  U      all      T=5    T=8   T=13   T=40\n");
+    for (i = 0; i < sizeof(util) / sizeof(util[0]); i++) {
+        Bench_Run(util[i]);
+    }
+
+#if OS_CFG_SCHED_POLICY == OS_SCHED_EDF
+    printf("== admission\n");
+    fail |= Check_Admission();
+    printf("== defer task vs always-ready EDF tasks\n");
+    fail |= Check_Defer();
+    printf("%s\n", fail ? "FAIL" : "PASS");
+#endif
+    return fail;
+}
@@ -0,0 +1,318 @@
+/**
+ * @file    os_sched_bench.c
+ * @brief   上位机基准：调度器 (Core/App/os.c) 在 8/32/64 个任务下的调度与 tick 开销，
+ *          与原线性扫描实现对比
+ * @note    os.c 以 OS_MAX_TASKS = 64 + 1 (OS_Init 创建的 Defer 任务占一个槽位) 直接包含
+ *          进来；原实现 (遍历全部任务槽位找最高优先级的 READY 任务、OS_Tick 逐个递减
+ *          DELAYED 任务) 按原代码照搬在本文件中，槽位数取 8/32/64。
+ *
+ *          1. 调度一次 (OS_ScheduleOnce，任务函数为空)，三种场景：
+ *               all   N 个任务全部就绪 (优先级随机)
+ *               one   只有 1 个任务就绪，其余挂起
+ *               idle  没有就绪任务 (OS_Start 空转时每次循环的开销)
+ *             结果为每次调度的平均耗时 (ns)
+ *          2. tick 中断 (OS_Tick)：N 个任务都在延时，醒来后立即再延时，两种场景：
+ *               random  每次延时 1~100 tick 随机
+ *               burst   全部任务延时 50 tick 且同相位，每 50 tick 同时到期
+ *             逐次计时 (已扣除计时本身的开销)，给出平均、99.9% 分位 (ns)，以及没有任务
+ *             到期的 tick 与有任务到期的 tick 各自的平均耗时；burst 场景下后者即 N 个任务
+ *             同时到期的最坏情况 (主机上单次最大值受主机中断影响，不作为最坏值)。
+ *             固件上的同一指标见 OS_GetTickMaxCycles (OS_CFG_TICK_PROFILE)。
+ *             新实现的 OS_Tick 只把到期的一串任务移到待唤醒链表，摘等待链表和放回
+ *             就绪链表在随后的 OS_ScheduleOnce 里完成，不计入 tick 耗时
+ *          主机上的绝对值只宜横向比较。
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/App -o os_sched_bench tools/os_sched_bench.c
+ *          使用：
+ *            ./os_sched_bench
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX_TASKS     64
+#define BENCH_ITER          5000000
+#define BENCH_TICKS         1000000
+
+#define OS_MAX_TASKS            (BENCH_MAX_TASKS + 1)    // 另加 Defer 任务
+#define OS_CRITICAL_ALLOC()     uint32_t os_primask = 0; (void)os_primask
+#define OS_ENTER_CRITICAL()     do { } while (0)
+#define OS_EXIT_CRITICAL()      do { } while (0)
+#define OS_CLZ(x)               __builtin_clz(x)
+#define OS_CYCLE_COUNT()        0U
+#define OS_CYCLES_PER_TICK()    168000U
+#define OS_MEMORY_BARRIER()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#include "os.c"
+
+uint32_t OS_PortSleep(uint32_t expectedTicks)
+{
+    (void)expectedTicks;
+    return 0;
+}
+
+/* ---------------- 原实现 (线性扫描) ---------------- */
+
+typedef struct {
+    void (*entry)(void *arg);
+    void           *arg;
+    uint8_t         priority;
+    OS_TaskState_t  state;
+    uint32_t        delayTicks;
+} Old_TCB_t;
+
+static Old_TCB_t old_tasks[BENCH_MAX_TASKS];
+static int       old_max_tasks;             // 原实现的 OS_MAX_TASKS
+static int32_t   old_current = OS_INVALID_TASK;
+
+static int32_t Old_SelectNextTask(void)
+{
+    int32_t bestId = OS_INVALID_TASK;
+    uint8_t bestPrio = 0;
+    int     found = 0;
+
+    for (int i = 0; i < old_max_tasks; ++i) {
+        if (old_tasks[i].state == OS_TASK_READY) {
+            if (!found || old_tasks[i].priority > bestPrio) {
+                bestId = i;
+                bestPrio = old_tasks[i].priority;
+                found = 1;
+            }
+        }
+    }
+    return bestId;
+}
+
+static void Old_ScheduleOnce(void)
+{
+    int32_t next = Old_SelectNextTask();
+    if (next == OS_INVALID_TASK) {
+        return;
+    }
+
+    old_current = next;
+    old_tasks[next].state = OS_TASK_RUNNING;
+
+    if (old_tasks[next].entry) {
+        old_tasks[next].entry(old_tasks[next].arg);
+    }
+
+    if (old_current == next && old_tasks[next].state == OS_TASK_RUNNING) {
+        old_tasks[next].state = OS_TASK_READY;
+        old_current = OS_INVALID_TASK;
+    }
+}
+
+static void Old_Tick(void)
+{
+    for (int i = 0; i < old_max_tasks; ++i) {
+        if (old_tasks[i].state == OS_TASK_DELAYED && old_tasks[i].delayTicks > 0) {
+            old_tasks[i].delayTicks--;
+            if (old_tasks[i].delayTicks == 0) {
+                old_tasks[i].state = OS_TASK_READY;
+            }
+        }
+    }
+}
+
+/* ---------------- 基准 ---------------- */
+
+static uint32_t rng_state = 0x9E3779B9U;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static volatile uint32_t sink;
+
+static void Empty_Task(void *arg)
+{
+    (void)arg;
+    sink++;
+}
+
+enum { SCENE_ALL, SCENE_ONE, SCENE_IDLE };
+
+/**
+ * @brief 两种实现各建 n 个任务，按场景设置就绪状态
+ */
+static void Bench_Setup(int n, int scene)
+{
+    int i;
+
+    OS_Init();
+    old_max_tasks = n;
+    for (i = 0; i < n; i++) {
+        uint8_t prio = (uint8_t)(1U + Rand() % 250U);
+        int ready = (scene == SCENE_ALL) || (scene == SCENE_ONE && i == n / 2);
+        int32_t id = OS_CreateTask(Empty_Task, 0, prio);
+
+        old_tasks[i].entry = Empty_Task;
+        old_tasks[i].arg = 0;
+        old_tasks[i].priority = prio;
+        old_tasks[i].state = ready ? OS_TASK_READY : OS_TASK_SUSPENDED;
+        old_tasks[i].delayTicks = 0;
+        if (!ready) {
+            OS_SuspendTask(id);
+        }
+    }
+}
+
+static double Bench_Dispatch(void (*schedule)(void))
+{
+    double t0 = Now();
+    int i;
+
+    for (i = 0; i < BENCH_ITER; i++) {
+        schedule();
+    }
+    return (Now() - t0) * 1e9 / BENCH_ITER;
+}
+
+/* ---------------- tick 开销 ---------------- */
+
+static uint8_t tick_burst;                  // 1: 全部任务同周期同相位
+static uint32_t tick_ns[BENCH_TICKS];
+
+static uint32_t Delay_Ticks(void)
+{
+    return tick_burst ? 50U : 1U + Rand() % 100U;
+}
+
+/* 醒来后立即再延时 (任务里调用 OS_DelayTicks) */
+static void Delay_Task(void *arg)
+{
+    (void)arg;
+    OS_DelayTicks(Delay_Ticks());
+}
+
+static int Cmp_U32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* 计时本身的开销：连续两次读时钟的最小差 */
+static double Timer_Overhead(void)
+{
+    double best = 1.0;
+    int i;
+
+    for (i = 0; i < 100000; i++) {
+        double t0 = Now(), t1 = Now();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+/**
+ * @brief 逐次计时 BENCH_TICKS 次 tick，醒来的任务在计时之外重新延时
+ */
+static void Bench_Tick(int n, int new_impl, double overhead, double out[4])
+{
+    double sum = 0.0, sum_idle = 0.0, sum_wake = 0.0;
+    int i, k, n_wake = 0;
+
+    OS_Init();
+    old_max_tasks = n;
+    for (i = 0; i < n; i++) {
+        int32_t id = OS_CreateTask(Delay_Task, 0, (uint8_t)(1U + Rand() % 250U));
+
+        OS_ReadyRemove(id);
+        OS_DelayInsert(id, Delay_Ticks());
+        old_tasks[i].state = OS_TASK_DELAYED;
+        old_tasks[i].delayTicks = Delay_Ticks();
+    }
+
+    for (k = 0; k < BENCH_TICKS; k++) {
+        double t0, dt;
+        int woke = 0;
+
+        if (new_impl) {
+            t0 = Now();
+            OS_Tick();
+            dt = Now() - t0;
+            while (!OS_NO_READY_TASK()) {
+                OS_ScheduleOnce();
+                woke = 1;
+            }
+        } else {
+            t0 = Now();
+            Old_Tick();
+            dt = Now() - t0;
+            for (i = 0; i < n; i++) {
+                if (old_tasks[i].state == OS_TASK_READY) {
+                    old_tasks[i].state = OS_TASK_DELAYED;
+                    old_tasks[i].delayTicks = Delay_Ticks();
+                    woke = 1;
+                }
+            }
+        }
+        dt = ((dt > overhead) ? dt - overhead : 0.0) * 1e9;
+        tick_ns[k] = (uint32_t)(dt + 0.5);
+        sum += dt;
+        if (woke) {
+            sum_wake += dt;
+            n_wake++;
+        } else {
+            sum_idle += dt;
+        }
+    }
+
+    qsort(tick_ns, BENCH_TICKS, sizeof(tick_ns[0]), Cmp_U32);
+    out[0] = sum / BENCH_TICKS;
+    out[1] = tick_ns[BENCH_TICKS - BENCH_TICKS / 1000];
+    out[2] = (n_wake < BENCH_TICKS) ? sum_idle / (BENCH_TICKS - n_wake) : 0.0;
+    out[3] = n_wake ? sum_wake / n_wake : 0.0;
+}
+
+int main(void)
+{
+    static const int n_tasks[] = { 8, 32, 64 };
+    static const char *const scene_name[] = { "all", "one", "idle" };
+    int k, scene;
+
+    printf("== dispatch (OS_ScheduleOnce, empty task), ns per call\n");
+    printf("  tasks  scene   linear   bitmap\n");
+    for (k = 0; k < 3; k++) {
+        for (scene = SCENE_ALL; scene <= SCENE_IDLE; scene++) {
+            double t_old, t_new;
+
+            Bench_Setup(n_tasks[k], scene);
+            t_old = Bench_Dispatch(Old_ScheduleOnce);
+            t_new = Bench_Dispatch(OS_ScheduleOnce);
+            printf("  %5d  %-5s  %7.1f  %7.1f\n", n_tasks[k], scene_name[scene], t_old, t_new);
+        }
+    }
+
+    double overhead = Timer_Overhead();
+
+    printf("== tick (OS_Tick, all tasks delayed), ns: mean / p99.9 / no-wake tick / wake tick\n");
+    printf("  tasks  scene          linear                    delta list\n");
+    for (k = 0; k < 3; k++) {
+        for (tick_burst = 0; tick_burst <= 1; tick_burst++) {
+            double r_old[4], r_new[4];
+
+            Bench_Tick(n_tasks[k], 0, overhead, r_old);
+            Bench_Tick(n_tasks[k], 1, overhead, r_new);
+            printf("  %5d  %-6s  %5.1f / %4.0f / %5.1f / %5.1f   %5.1f / %4.0f / %5.1f / %5.1f\n",
+                   n_tasks[k], tick_burst ? "burst" : "random",
+                   r_old[0], r_old[1], r_old[2], r_old[3], r_new[0], r_new[1], r_new[2], r_new[3]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file    os_sched_sim.c
+ * @brief   上位机仿真测试：周期任务 (OS_CreatePeriodicTask) 不漂移，
+ *          同优先级轮转与老化下的调度延迟分位数
+ * @note    把 os.c 直接包含进来，用仿真时钟代替 DWT 与 SysTick：任务"执行"即推进
+ *          仿真时钟，越过 tick 边界时调用 OS_Tick (协同式调度，任务不会被抢占)。
+ *
+ *          1. 漂移：周期 7 tick 的任务每次执行 0~5 tick (随机，含不足 1 tick 的零头)，
+ *             另有一个低优先级、周期 3 tick、每次执行 0~1 tick 的任务制造调度等待，
+ *             仿真 1e6 tick：
+ *               periodic  OS_CreatePeriodicTask 按绝对释放时刻调度
+ *               re-arm    原做法：任务执行完调用 OS_DelayTicks(7) 重新定时
+ *             统计每次开始执行相对第 k 个释放时刻 (phase + k * 7) 的滞后。
+ *             检查项 (periodic)：执行次数等于释放次数，没有截止时刻错过和跳过的释放，
+ *             最后一次的滞后不超过 1 tick (累积漂移为 0)
+ *          2. 轮转：三个优先级 1 的任务一直就绪，检查执行次数相差不超过 1
+ *          3. 老化：一个优先级 2 的任务一直就绪，三个优先级 1 与一个优先级 0 的任务每次
+ *             执行完延时 1~20 tick 后再就绪，仿真 2e5 tick，统计每个任务从就绪到被调度
+ *             的等待 (tick) 的 50/90/99% 分位与最大值。
+ *             检查项 (OS_CFG_AGING 为 1 时)：最大等待不超过
+ *             OS_CFG_AGING_TICKS + OS_CFG_AGING_SCAN_TICKS + 1
+ *          任一检查项不满足即返回非 0。
+ *
+ *          编译 (Linux，在仓库根目录执行；-DOS_CFG_AGING=0 可对比关闭老化的情况)：
+ *            gcc -O2 -ICore/App -o os_sched_sim tools/os_sched_sim.c
+ *          使用：
+ *            ./os_sched_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ---------------- 仿真时钟 ---------------- */
+
+#define SIM_CPT             168000U     // 每 tick 周期数 (168MHz，1ms)
+
+static uint64_t sim_now;
+
+#define OS_CRITICAL_ALLOC()     uint32_t os_primask = 0; (void)os_primask
+#define OS_ENTER_CRITICAL()     do { } while (0)
+#define OS_EXIT_CRITICAL()      do { } while (0)
+#define OS_CLZ(x)               __builtin_clz(x)
+#define OS_CYCLE_COUNT()        ((uint32_t)sim_now)
+#define OS_CYCLES_PER_TICK()    SIM_CPT
+#define OS_MEMORY_BARRIER()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#include "os.c"
+
+/**
+ * @brief 推进仿真时钟，越过的每个 tick 边界执行一次 tick 中断
+ */
+static void Sim_Run(uint64_t cycles)
+{
+    uint64_t end = sim_now + cycles;
+
+    while ((sim_now / SIM_CPT + 1U) * SIM_CPT <= end) {
+        sim_now = (sim_now / SIM_CPT + 1U) * SIM_CPT;
+        OS_Tick();
+    }
+    sim_now = end;
+}
+
+/* 空闲：睡到下一个 tick 中断，tick 已在中断中计入 */
+uint32_t OS_PortSleep(uint32_t expectedTicks)
+{
+    (void)expectedTicks;
+    Sim_Run((sim_now / SIM_CPT + 1U) * SIM_CPT - sim_now);
+    return 0;
+}
+
+/* 调度到仿真时刻 end_tick */
+static void Sim_Schedule(uint32_t end_tick)
+{
+    while (OS_GetTickCount() < end_tick) {
+        OS_ScheduleOnce();
+        if (OS_NO_READY_TASK()) {
+            OS_Idle();
+        }
+    }
+}
+
+static void Sim_Reset(void)
+{
+    sim_now = 0;
+    OS_Init();
+}
+
+/* ---------------- 随机数 ---------------- */
+
+static uint32_t rng_state = 0x6C8E9CF5U;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---------------- 周期任务漂移 ---------------- */
+
+#define DRIFT_TICKS     1000000U
+#define DRIFT_PERIOD    7U
+#define DRIFT_PHASE     2U
+
+static uint8_t  drift_rearm;            // 1: 原做法，执行完 OS_DelayTicks 重新定时
+static uint32_t drift_runs;
+static uint64_t drift_late_max;         // 开始执行相对释放时刻的最大滞后 (周期)
+static uint64_t drift_late_last;
+
+static void Drift_Task(void *arg)
+{
+    uint64_t release = (uint64_t)(DRIFT_PHASE + drift_runs * DRIFT_PERIOD) * SIM_CPT;
+    uint64_t late = sim_now - release;
+
+    (void)arg;
+    if (late > drift_late_max) drift_late_max = late;
+    drift_late_last = late;
+    drift_runs++;
+
+    Sim_Run(Rand() % (5U * SIM_CPT + 1U));
+    if (drift_rearm) {
+        OS_DelayTicks(DRIFT_PERIOD);
+    }
+}
+
+/* 低优先级干扰：执行期间周期任务到期也要等它返回 */
+static void Noise_Task(void *arg)
+{
+    (void)arg;
+    Sim_Run(Rand() % (SIM_CPT + 1U));
+}
+
+static int Check_Drift(uint8_t rearm)
+{
+    OS_TaskStats_t st;
+    uint32_t releases = (DRIFT_TICKS - DRIFT_PHASE - 1U) / DRIFT_PERIOD + 1U;
+    int32_t id;
+
+    Sim_Reset();
+    drift_rearm = rearm;
+    drift_runs = 0;
+    drift_late_max = 0;
+    drift_late_last = 0;
+    if (rearm) {
+        id = OS_CreateTask(Drift_Task, 0, 2);
+        OS_ReadyRemove(id);
+        OS_DelayInsert(id, DRIFT_PHASE);
+    } else {
+        id = OS_CreatePeriodicTask(Drift_Task, 0, 2, DRIFT_PERIOD, DRIFT_PHASE);
+    }
+    OS_CreatePeriodicTask(Noise_Task, 0, 1, 3, 0);
+    Sim_Schedule(DRIFT_TICKS);
+    OS_GetTaskStats(id, &st);
+
+    printf("  %-8s  runs %6lu / %6lu releases, late max %9.2f last %9.2f ticks, miss %lu overrun %lu\n",
+           rearm ? "re-arm" : "periodic", (unsigned long)drift_runs, (unsigned long)releases,
+           (double)drift_late_max / SIM_CPT, (double)drift_late_last / SIM_CPT,
+           (unsigned long)st.deadlineMisses, (unsigned long)st.overruns);
+    if (rearm) {
+        return 0;
+    }
+    return drift_runs != releases || st.deadlineMisses != 0 || st.overruns != 0 ||
+           drift_late_last > SIM_CPT;
+}
+
+/* ---------------- 调度延迟 ---------------- */
+
+#define LAT_TICKS       200000U
+#define LAT_TASKS       5
+#define LAT_MAX_SAMPLES 400000
+
+typedef struct {
+    const char *name;
+    uint8_t     prio;
+    uint8_t     delay;                  // 1: 执行完延时 1~20 tick；0: 一直就绪
+    uint32_t    runtime;                // 每次执行的周期数
+    int32_t     id;
+    uint32_t    n;
+    uint32_t   *wait;                   // 每次从就绪到被调度的等待 (tick)
+} Lat_Task_t;
+
+static Lat_Task_t lat_task[LAT_TASKS];
+static int        lat_count;
+
+static void Lat_Task(void *arg)
+{
+    Lat_Task_t *t = (Lat_Task_t *)arg;
+
+    if (t->n < LAT_MAX_SAMPLES) {
+        t->wait[t->n++] = OS_GetTickCount() - g_tasks[g_currentTask].readySince;
+    }
+    Sim_Run(t->runtime);
+    if (t->delay) {
+        OS_DelayTicks(1U + Rand() % 20U);
+    }
+}
+
+static void Lat_Add(const char *name, uint8_t prio, uint8_t delay, uint32_t runtime)
+{
+    static uint32_t samples[LAT_TASKS][LAT_MAX_SAMPLES];
+    Lat_Task_t *t = &lat_task[lat_count];
+
+    t->name    = name;
+    t->prio    = prio;
+    t->delay   = delay;
+    t->runtime = runtime;
+    t->n       = 0;
+    t->wait    = samples[lat_count];
+    t->id      = OS_CreateTask(Lat_Task, t, prio);
+    lat_count++;
+}
+
+static int Cmp_U32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 打印各任务的执行次数与等待分位数
+ * @return 最大等待 (tick)；有任务从未执行时为仿真结束时它已等待的时间
+ */
+static uint32_t Lat_Report(void)
+{
+    uint32_t worst = 0;
+    int i;
+
+    printf("  task      prio    runs    p50    p90    p99    max\n");
+    for (i = 0; i < lat_count; i++) {
+        Lat_Task_t *t = &lat_task[i];
+
+        if (t->n == 0) {
+            uint32_t waiting = OS_GetTickCount() - g_tasks[t->id].readySince;
+            printf("  %-8s  %4u  %6s  never ran (ready for %lu ticks)\n", t->name, t->prio, "0",
+                   (unsigned long)waiting);
+            if (waiting > worst) worst = waiting;
+            continue;
+        }
+        qsort(t->wait, t->n, sizeof(t->wait[0]), Cmp_U32);
+        printf("  %-8s  %4u  %6lu  %5lu  %5lu  %5lu  %5lu\n", t->name, t->prio, (unsigned long)t->n,
+               (unsigned long)t->wait[t->n / 2], (unsigned long)t->wait[t->n * 9 / 10],
+               (unsigned long)t->wait[t->n * 99 / 100], (unsigned long)t->wait[t->n - 1]);
+        if (t->wait[t->n - 1] > worst) worst = t->wait[t->n - 1];
+    }
+    return worst;
+}
+
+static int Check_RoundRobin(void)
+{
+    uint32_t lo = 0xFFFFFFFFU, hi = 0;
+    int i;
+
+    Sim_Reset();
+    lat_count = 0;
+    Lat_Add("A", 1, 0, SIM_CPT * 3U / 10U);
+    Lat_Add("B", 1, 0, SIM_CPT * 3U / 10U);
+    Lat_Add("C", 1, 0, SIM_CPT * 3U / 10U);
+    Sim_Schedule(LAT_TICKS);
+    Lat_Report();
+    for (i = 0; i < lat_count; i++) {
+        if (lat_task[i].n < lo) lo = lat_task[i].n;
+        if (lat_task[i].n > hi) hi = lat_task[i].n;
+    }
+    return hi - lo > 1U;
+}
+
+static int Check_Aging(void)
+{
+    uint32_t worst;
+
+    Sim_Reset();
+    lat_count = 0;
+    Lat_Add("hog", 2, 0, SIM_CPT / 2U);
+    Lat_Add("mid1", 1, 1, SIM_CPT / 5U);
+    Lat_Add("mid2", 1, 1, SIM_CPT / 5U);
+    Lat_Add("mid3", 1, 1, SIM_CPT / 5U);
+    Lat_Add("low", 0, 1, SIM_CPT / 5U);
+    Sim_Schedule(LAT_TICKS);
+    worst = Lat_Report();
+#if OS_CFG_AGING
+    return worst > OS_CFG_AGING_TICKS + OS_CFG_AGING_SCAN_TICKS + 1U;
+#else
+    (void)worst;
+    return 0;
+#endif
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    printf("== periodic drift: T = %u, runtime 0-5 ticks, %u ticks\n", DRIFT_PERIOD, DRIFT_TICKS);
+    fail |= Check_Drift(0);
+    fail |= Check_Drift(1);
+    printf("== round robin: three always-ready prio-1 tasks, %u ticks\n", LAT_TICKS);
+    fail |= Check_RoundRobin();
+    printf("== dispatch wait (ticks): always-ready prio 2 vs delayed prio 1/0, aging %s, %u ticks\n",
+           OS_CFG_AGING ? "on" : "off", LAT_TICKS);
+    fail |= Check_Aging();
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
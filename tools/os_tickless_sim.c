@@ -0,0 +1,360 @@
+/**
+ * @file    os_tickless_sim.c
+ * @brief   上位机仿真测试：无节拍空闲 (Core/App/os_port.c OS_PortSleep) 不丢 tick
+ * @note    把 os.c 与 os_port.c 直接包含进来，用软件模型代替 SysTick 与 PRIMASK：
+ *            - 仿真时钟以 CPU 周期计；SysTick 为 24 位递减计数器，计到 0 时置
+ *              COUNTFLAG 并挂起中断，下一个周期重装载；读 CTRL 清除 COUNTFLAG，
+ *              写 VAL 清零计数并清除 COUNTFLAG，计数为 0 时使能在下一个周期
+ *              装载 LOAD (与 Cortex-M4 一致)
+ *            - WFI 在有中断挂起时返回，之后再随机经过 1~40 个周期才执行到停表
+ *              (覆盖"被外部中断唤醒后、停表前 SysTick 恰好到期"的竞争)
+ *            - 外部中断按随机间隔到来，其中一部分故意落在 tick 边界附近，
+ *              中断里置事件唤醒等待任务
+ *          检查项 (任一不满足即返回非 0)：
+ *            1. OS tick 计数、HAL uwTick 与仿真真实时间折算的 tick 数一致
+ *            2. 每次 SysTick 中断都落在原 tick 相位上 (相位误差为 0)
+ *            3. OS_DelayTicks 唤醒不早于目标 tick，且最多晚 1 个 tick
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/App -o os_tickless_sim tools/os_tickless_sim.c
+ *          使用：
+ *            ./os_tickless_sim [仿真 tick 数，默认 2000000]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ---------------- 仿真时钟与中断模型 ---------------- */
+
+#define SIM_CPT             168000U     // 每 tick 周期数 (168MHz，1ms)
+#define SIM_WAKE_SLACK      40U         // WFI 返回到停表之间最多经过的周期数
+
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_ENABLE_Msk     (1UL)
+
+static uint64_t sim_now = 1;            // 第 k 个 tick 中断在 k * SIM_CPT 时刻
+static uint32_t sim_primask;
+static uint8_t  sim_in_irq;
+
+static struct {
+    uint32_t cfg;                       // CLKSOURCE | TICKINT
+    uint8_t  enabled;
+    uint8_t  countflag;
+    uint8_t  pending;                   // PENDSTSET
+    uint32_t load;
+    uint32_t val;
+    uint8_t  latched;                   // 使能时计数为 0：下一个时钟装载 latch
+    uint32_t latch;
+} st;
+
+static uint64_t ext_next;               // 下一次外部中断时刻
+static uint8_t  ext_pending;
+
+volatile uint32_t uwTick;               // HAL 毫秒计数
+
+static void Sim_Irq_Dispatch(void);
+
+#define OS_CRITICAL_ALLOC()     uint32_t os_primask = 0
+#define OS_ENTER_CRITICAL()     do { os_primask = sim_primask; sim_primask = 1; } while (0)
+#define OS_EXIT_CRITICAL()      do { sim_primask = os_primask; Sim_Irq_Dispatch(); } while (0)
+#define OS_CLZ(x)               __builtin_clz(x)
+#define OS_CYCLE_COUNT()        ((uint32_t)sim_now)
+#define OS_CYCLES_PER_TICK()    SIM_CPT
+#define OS_MEMORY_BARRIER()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define OS_PORT_ST_READ(reg)        Sim_ST_Read_##reg()
+#define OS_PORT_ST_WRITE(reg, v)    Sim_ST_Write_##reg(v)
+#define OS_PORT_TICK_PENDING()      (st.pending != 0)
+#define OS_PORT_WFI()               Sim_WFI()
+
+static uint32_t Sim_ST_Read_CTRL(void)
+{
+    uint32_t v = st.cfg | st.enabled | (st.countflag ? SysTick_CTRL_COUNTFLAG_Msk : 0U);
+    st.countflag = 0;                   // 读即清零
+    return v;
+}
+
+static void Sim_ST_Write_CTRL(uint32_t v)
+{
+    uint8_t en = (uint8_t)(v & SysTick_CTRL_ENABLE_Msk);
+
+    /* 使能时计数为 0：下一个时钟装载此刻的 LOAD (紧接着再写 LOAD 只影响下一轮) */
+    if (en && !st.enabled && st.val == 0) {
+        st.latched = 1;
+        st.latch = st.load;
+    }
+    st.enabled = en;
+    st.cfg = v & (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk);
+}
+
+static uint32_t Sim_ST_Read_LOAD(void)  { return st.load; }
+static void Sim_ST_Write_LOAD(uint32_t v) { st.load = v & 0x00FFFFFFU; }
+static uint32_t Sim_ST_Read_VAL(void)   { return st.val; }
+static void Sim_ST_Write_VAL(uint32_t v) { (void)v; st.val = 0; st.countflag = 0; st.latched = 0; }
+
+static void Sim_WFI(void);
+
+#include "os.c"
+#include "os_port.c"
+
+/* ---------------- 随机数 ---------------- */
+
+static uint32_t rng_state = 0x1234567U;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t Rand_Range(uint32_t lo, uint32_t hi)
+{
+    return lo + Rand() % (hi - lo + 1U);
+}
+
+/* ---------------- 统计 ---------------- */
+
+static uint64_t st_ticks;               // SysTick 中断次数
+static uint64_t phase_errors;           // 不在 tick 相位上的 SysTick 中断
+static int64_t  tick_err_max;           // |OS tick - 真实 tick| 最大值
+static uint64_t ext_irqs;
+static uint64_t ext_set_time;           // 最近一次外部中断置事件的时刻
+
+static OS_Event_t ext_event;
+
+static void Sim_Schedule_Ext(void)
+{
+    uint64_t gap = Rand_Range(SIM_CPT / 4U, SIM_CPT * 80U);
+
+    ext_next = sim_now + gap;
+    /* 四分之一落在 tick 边界 ±8 个周期内 */
+    if ((Rand() & 3U) == 0) {
+        uint64_t edge = (ext_next / SIM_CPT + 1U) * SIM_CPT;
+        ext_next = edge + Rand_Range(0, 16) - 8U;
+        if (ext_next <= sim_now) {
+            ext_next = sim_now + 1U;
+        }
+    }
+}
+
+static void Sim_Check_Ticks(void)
+{
+    int64_t truth = (int64_t)(sim_now / SIM_CPT);
+    int64_t e1 = (int64_t)OS_GetTickCount() - truth;
+    int64_t e2 = (int64_t)uwTick - truth;
+
+    if (e1 < 0) e1 = -e1;
+    if (e2 < 0) e2 = -e2;
+    if (e1 > tick_err_max) tick_err_max = e1;
+    if (e2 > tick_err_max) tick_err_max = e2;
+}
+
+static void SysTick_Handler(void)
+{
+    st_ticks++;
+    OS_Tick();
+    uwTick++;
+    Sim_Check_Ticks();
+}
+
+static void Ext_Handler(void)
+{
+    ext_irqs++;
+    ext_set_time = sim_now;
+    OS_EventSet(&ext_event, 1U);
+}
+
+/* PRIMASK 为 0 时执行挂起的中断 */
+static void Sim_Irq_Dispatch(void)
+{
+    if (sim_primask || sim_in_irq) {
+        return;
+    }
+    sim_in_irq = 1;
+    while (st.pending || ext_pending) {
+        if (st.pending) {
+            st.pending = 0;
+            SysTick_Handler();
+        }
+        if (ext_pending) {
+            ext_pending = 0;
+            Ext_Handler();
+        }
+    }
+    sim_in_irq = 0;
+}
+
+/* 前进到下一个事件 (计数到 0 / 重装载 / 外部中断) 或最多 n 个周期，返回实际前进数 */
+static uint64_t Sim_Step(uint64_t n)
+{
+    uint64_t step = n;
+
+    if (st.enabled) {
+        uint64_t to_event = (st.val == 0) ? 1U : st.val;
+        if (to_event < step) step = to_event;
+    }
+    if (ext_next - sim_now < step) {
+        step = ext_next - sim_now;
+    }
+
+    sim_now += step;
+    if (st.enabled) {
+        if (st.val == 0) {
+            st.val = st.latched ? st.latch : st.load;   // 重装载占一个周期
+            st.latched = 0;
+        } else {
+            st.val -= (uint32_t)step;
+            if (st.val == 0) {
+                st.countflag = 1;
+                st.pending = 1;
+                if (sim_now % SIM_CPT != 0) {
+                    phase_errors++;     // 到期时刻 (不是中断得到执行的时刻) 偏离 tick 边界
+                }
+            }
+        }
+    }
+    if (sim_now == ext_next) {
+        ext_pending = 1;
+        Sim_Schedule_Ext();
+    }
+    return step;
+}
+
+/* 运行 n 个周期 (任务代码)，期间按 PRIMASK 响应中断 */
+static void Sim_Run(uint64_t n)
+{
+    while (n > 0) {
+        n -= Sim_Step(n);
+        Sim_Irq_Dispatch();
+    }
+}
+
+static uint64_t sleeps, sleeps_full;
+
+static void Sim_WFI(void)
+{
+    uint32_t slack;
+
+    sleeps++;
+    while (!st.pending && !ext_pending) {
+        (void)Sim_Step(UINT64_MAX);
+    }
+    if (st.pending) {
+        sleeps_full++;
+    }
+    /* 唤醒后执行到停表之前经过的周期 (PRIMASK=1，中断只挂起) */
+    slack = Rand_Range(1, SIM_WAKE_SLACK);
+    while (slack > 0) {
+        slack -= (uint32_t)Sim_Step(slack);
+    }
+}
+
+/* ---------------- 测试任务 ---------------- */
+
+typedef struct {
+    uint64_t wake_at;                   // 目标唤醒时刻 (tick 边界)
+    uint8_t  armed;
+    uint32_t runs;
+} Sleeper_t;
+
+static Sleeper_t sleepers[3];
+static uint64_t delay_early, delay_late;
+static uint64_t late_max;               // 最大唤醒延迟 (周期)
+static uint64_t ev_runs, ev_timeouts, ev_lat_max;
+
+static void Task_Sleeper(void *arg)
+{
+    Sleeper_t *s = (Sleeper_t *)arg;
+    uint32_t d;
+
+    if (s->armed) {
+        if (sim_now < s->wake_at) {
+            delay_early++;
+        } else {
+            uint64_t late = sim_now - s->wake_at;
+            if (late > late_max) late_max = late;
+            if (late >= SIM_CPT) delay_late++;
+        }
+    }
+    s->runs++;
+    Sim_Run(Rand_Range(200, 20000));
+
+    /* 大部分短延时，少数超过 SysTick 24 位能睡的最长时间 (约 99 tick) */
+    d = (Rand() & 7U) ? Rand_Range(1, 60) : Rand_Range(60, 400);
+    s->wake_at = (sim_now / SIM_CPT + d) * SIM_CPT;
+    s->armed = 1;
+    OS_DelayTicks(d);
+}
+
+static void Task_Event(void *arg)
+{
+    uint32_t bits;
+    int32_t r;
+
+    (void)arg;
+    while ((r = OS_EventWait(&ext_event, 1U, 50, &bits)) == OS_OK) {
+        uint64_t lat = sim_now - ext_set_time;
+        if (lat > ev_lat_max) ev_lat_max = lat;
+        ev_runs++;
+        Sim_Run(Rand_Range(100, 5000));
+    }
+    if (r == OS_ERR_TIMEOUT) {
+        ev_timeouts++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t ticks = (argc > 1) ? strtoull(argv[1], NULL, 0) : 2000000ULL;
+    uint64_t end;
+    int i, fail;
+
+    /* HAL_InitTick：1ms 周期，第一次中断在 SIM_CPT 时刻 */
+    st.load = SIM_CPT - 1U;
+    st.val  = SIM_CPT - 1U;
+    st.cfg  = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+    st.enabled = 1;
+    Sim_Schedule_Ext();
+
+    OS_Init();
+    OS_EventInit(&ext_event);
+    for (i = 0; i < 3; i++) {
+        OS_CreateTask(Task_Sleeper, &sleepers[i], (uint8_t)(10 + i));
+    }
+    OS_CreateTask(Task_Event, NULL, 20);
+
+    end = ticks * SIM_CPT;
+    while (sim_now < end) {
+        OS_ScheduleOnce();
+        Sim_Run(20);                    // 调度开销
+        if (OS_NO_READY_TASK()) {
+            OS_Idle();
+        }
+    }
+    Sim_Check_Ticks();
+
+    printf("simulated %llu ticks: SysTick irqs %llu, sleeps %llu (%llu to deadline), ext irqs %llu\n",
+           (unsigned long long)(sim_now / SIM_CPT), (unsigned long long)st_ticks,
+           (unsigned long long)sleeps, (unsigned long long)sleeps_full,
+           (unsigned long long)ext_irqs);
+    printf("tick count: OS %lu, uwTick %lu, true %llu, max |error| %lld\n",
+           (unsigned long)OS_GetTickCount(), (unsigned long)uwTick,
+           (unsigned long long)(sim_now / SIM_CPT), (long long)tick_err_max);
+    printf("tick phase errors: %llu\n", (unsigned long long)phase_errors);
+    printf("delays: runs %u/%u/%u, early %llu, late >= 1 tick %llu, max lateness %llu cycles\n",
+           (unsigned)sleepers[0].runs, (unsigned)sleepers[1].runs, (unsigned)sleepers[2].runs,
+           (unsigned long long)delay_early, (unsigned long long)delay_late,
+           (unsigned long long)late_max);
+    printf("event task: %llu wakes, %llu timeouts, max latency %llu cycles\n",
+           (unsigned long long)ev_runs, (unsigned long long)ev_timeouts,
+           (unsigned long long)ev_lat_max);
+
+    fail = (tick_err_max > 1) || (phase_errors != 0) || (delay_early != 0) || (delay_late != 0);
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file    pid_bank_bench.c
+ * @brief   上位机检查与基准：PID 控制器组 (Core/Algo/pid_bank.c) 与逐个 PID_Update 等价，
+ *          一次四通道更新与四次 PID_Compute 的耗时对比
+ * @note    四个通道取固件跟随的四个回路的量级 (距离、角度、左右速度)，其中一路设置
+ *          抗饱和跟踪时间 aw_tt，经 PID_Bank_Load 装入控制器组：
+ *            1. 等价：20000 步，周期在 1~3ms 与 33ms 之间变化，目标在正负之间切换，
+ *               部分区段加偏置使输出饱和，第 7000 步两边同时复位；给出各通道输出差的
+ *               最大值 (相对限幅)，超过 1e-5 判为不一致
+ *            2. 耗时：四次 PID_Compute 与一次四通道 PID_Bank_Update，各 2e7 次，
+ *               结果为每次 (四个回路) 的平均耗时 (ns)。主机上的绝对值只宜横向比较，
+ *               固件上的周期数由串口命令 PIDBENCH 测量
+ *          检查项不满足时返回非 0。
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Algo -o pid_bank_bench tools/pid_bank_bench.c \
+ *                Core/Algo/pid.c Core/Algo/pid_bank.c -lm
+ *          使用：
+ *            ./pid_bank_bench
+ */
+
+#include "pid_bank.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CHECK_STEPS     20000
+#define CHECK_RESET     7000
+#define CHECK_TOL       1e-5        // 最大输出差 / 限幅
+#define BENCH_ITER      20000000
+
+/* Kp, Ki, Kd, max_out, max_int */
+static const float gains[PID_BANK_MAX][5] = {
+    { 2.0f,  0.1f, 0.5f, 150.0f,  50.0f },      // 距离
+    { 1.5f,  0.2f, 0.3f,  80.0f,  30.0f },      // 角度
+    { 40.0f, 40.0f, 0.0f, 4200.0f, 2000.0f },   // 速度 (1kHz 增益)
+    { 5.0f,  2.5f, 0.1f, 4200.0f, 2000.0f },    // 速度 (Flash 默认增益，另设 aw_tt)
+};
+
+static PID_Controller_t pid[PID_BANK_MAX];
+static PID_Bank_t       bank;
+
+static uint32_t rng_state = 0x1B873593U;
+
+static uint32_t Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void Setup(void)
+{
+    int i;
+
+    PID_Bank_Init(&bank, PID_BANK_MAX);
+    for (i = 0; i < PID_BANK_MAX; i++) {
+        PID_Init(&pid[i], gains[i][0], gains[i][1], gains[i][2], gains[i][3], gains[i][4]);
+    }
+    PID_SetAntiWindup(&pid[3], 0.02f);
+    for (i = 0; i < PID_BANK_MAX; i++) {
+        PID_Bank_Load(&bank, (uint8_t)i, &pid[i]);
+    }
+}
+
+static int Check_Equivalence(void)
+{
+    double max_diff[PID_BANK_MAX] = { 0.0 }, worst = 0.0;
+    float target[PID_BANK_MAX], actual[PID_BANK_MAX];
+    int s, i, sat = 0;
+
+    Setup();
+    for (s = 0; s < CHECK_STEPS; s++) {
+        float dt = (s % 3 == 0) ? 0.033f : 0.001f + 0.0005f * (s % 5);
+
+        if (s == CHECK_RESET) {
+            for (i = 0; i < PID_BANK_MAX; i++) {
+                PID_Reset(&pid[i]);
+            }
+            PID_Bank_Reset(&bank);
+        }
+        for (i = 0; i < PID_BANK_MAX; i++) {
+            float lim = gains[i][3];
+
+            target[i] = (s / 2000 % 2) ? lim * 0.02f : -lim * 0.01f;
+            actual[i] = target[i] * (0.5f + (Rand() % 1000) / 1000.0f) +
+                        (((s / 1500) % 3 == 1) ? lim * 0.05f : 0.0f);
+        }
+        PID_Bank_Update(&bank, target, actual, dt);
+        for (i = 0; i < PID_BANK_MAX; i++) {
+            float u = PID_Update(&pid[i], target[i], actual[i], dt);
+            double d = fabs(u - bank.output[i]) / gains[i][3];
+
+            if (fabsf(u) >= gains[i][3]) sat++;
+            if (d > max_diff[i]) max_diff[i] = d;
+            if (d > worst) worst = d;
+        }
+    }
+    printf("  max |diff| / limit: %.1e %.1e %.1e %.1e, saturated %.0f%% of channel steps\n",
+           max_diff[0], max_diff[1], max_diff[2], max_diff[3],
+           100.0 * sat / (CHECK_STEPS * PID_BANK_MAX));
+    return worst > CHECK_TOL;
+}
+
+static volatile float sink;
+
+static void Bench(void)
+{
+    float target[PID_BANK_MAX], actual[PID_BANK_MAX];
+    double t0, t1, t2;
+    int s, i;
+
+    Setup();
+    for (i = 0; i < PID_BANK_MAX; i++) {
+        target[i] = gains[i][3] * 0.02f;
+        actual[i] = 0.0f;
+    }
+
+    t0 = Now();
+    for (s = 0; s < BENCH_ITER; s++) {
+        actual[s & 3] += 1e-7f;
+        sink += PID_Compute(&pid[0], target[0], actual[0]) + PID_Compute(&pid[1], target[1], actual[1]) +
+                PID_Compute(&pid[2], target[2], actual[2]) + PID_Compute(&pid[3], target[3], actual[3]);
+    }
+    t1 = Now();
+    for (s = 0; s < BENCH_ITER; s++) {
+        actual[s & 3] += 1e-7f;
+        PID_Bank_Update(&bank, target, actual, PID_REF_DT);
+        sink += bank.output[0] + bank.output[1] + bank.output[2] + bank.output[3];
+    }
+    t2 = Now();
+    printf("  4x PID_Compute %.1f ns, PID_Bank_Update %.1f ns\n",
+           (t1 - t0) * 1e9 / BENCH_ITER, (t2 - t1) * 1e9 / BENCH_ITER);
+}
+
+int main(void)
+{
+    int fail;
+
+    printf("== PID_Bank vs PID_Update, %d steps, 4 channels, mixed dt, reset at %d\n",
+           CHECK_STEPS, CHECK_RESET);
+    fail = Check_Equivalence();
+    printf("== time per 4-loop update, %d iterations\n", BENCH_ITER);
+    Bench();
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
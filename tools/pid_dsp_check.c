@@ -0,0 +1,194 @@
+/**
+ * @file    pid_dsp_check.c
+ * @brief   上位机检查：PID 计算后端 (PID_CFG_BACKEND，Core/Algo/pid.c) 的数值精度与闭环效果
+ * @note    后端是编译期选项，每种各编一次：
+ *            1. 精度 (仅 CMSIS-DSP 后端)：同一误差序列 (正弦 + 10% 均匀噪声) 分别送入
+ *               PID_Kernel_Run 和双精度增量式参考实现 (同样的每周期增益、限幅后写回 y[n-1])，
+ *               给出输出差的最大值与 RMS (PWM / 输出单位)。工况取固件的四个回路：
+ *               1kHz 速度环 (不饱和 / 饱和 / 带 Kd)，30 帧/秒的距离环与角度环
+ *            2. 闭环：1kHz 速度环驱动一阶电机 (300 RPM 满量程、时间常数 40ms)，编码器
+ *               2200 CPR 取整后按 10 拍滑动窗口测速 (同 Bsp_Encoder)，目标 100 RPM，
+ *               1s 时加 40 RPM 负载；给出阶跃后的误差 RMS 和最后 200ms 的平均误差，
+ *               增益取 Kp40/Ki40 与 Flash 默认值 Kp5/Ki2.5
+ *          检查项 (最大输出差不超过限幅的 1e-4) 不满足时返回非 0。
+ *          PID_BACKEND_ARM_Q15 编译即报错 (每周期截断，见 pid.h)。
+ *
+ *          编译 (Linux，在仓库根目录执行；BACKEND 取 0..2，见 pid.h，0 为浮点 PID_Update)：
+ *            gcc -O2 -DPID_CFG_BACKEND=BACKEND -ICore/Algo -IDrivers/CMSIS/DSP/Include \
+ *                -IDrivers/CMSIS/Include -o pid_dsp_check tools/pid_dsp_check.c Core/Algo/pid.c \
+ *                Drivers/CMSIS/DSP/Source/ControllerFunctions/arm_pid_{init,reset}_{f32,q31}.c -lm
+ *          使用：
+ *            ./pid_dsp_check
+ */
+
+#include "pid.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SPEED_DT        0.001f      // 速度环周期 (s)，同固件 SAMPLE_TIME_S
+#define VISION_DT       0.033f      // 外环标称周期 (s)，同固件 VISION_DT_NOM
+#define SPEED_MAX_OUT   4200.0f     // 以下限幅同固件 App_Follow_Init
+#define DIST_MAX_OUT    150.0f
+#define ANGLE_MAX_OUT   80.0f
+
+#define ACC_STEPS       4000
+#define ACC_TOL         1e-4        // 最大输出差 / 限幅
+
+#define SIM_SUBSTEPS    20          // 每周期的积分子步
+#define SIM_CPR         2200.0      // 每转编码器计数
+#define SIM_WINDOW      10          // 测速滑动窗口 (周期)
+#define SIM_K           (300.0 / 4200.0)    // 稳态增益 (RPM / PWM)
+#define SIM_TAU         0.040       // 机械时间常数 (s)
+#define SIM_TIME        2.0         // 仿真时长 (s)
+#define SIM_TARGET      100.0f
+#define SIM_LOAD_TIME   1.0
+#define SIM_LOAD        40.0        // 负载 (RPM 当量)
+
+static const char *const backend_name[] = { "FLOAT (PID_Update)", "ARM_F32", "ARM_Q31" };
+
+/* ---------------- 1. 精度 ---------------- */
+
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+/* 双精度增量式参考：y[n] = y[n-1] + A0*e[n] + A1*e[n-1] + A2*e[n-2]，限幅后写回 */
+typedef struct {
+    double a0, a1, a2;
+    double x1, x2, y1;
+    double max;
+} Ref_Pid_t;
+
+static double Ref_Run(Ref_Pid_t *r, double e)
+{
+    double y = r->y1 + r->a0 * e + r->a1 * r->x1 + r->a2 * r->x2;
+
+    if (y > r->max) y = r->max;
+    if (y < -r->max) y = -r->max;
+    r->x2 = r->x1;
+    r->x1 = e;
+    r->y1 = y;
+    return y;
+}
+
+/**
+ * @brief 一种工况：误差幅值 amp，返回最大输出差 / 限幅
+ */
+static double Accuracy_Run(const char *name, float kp, float ki, float kd, float max_out,
+                           float dt, double amp)
+{
+    PID_Controller_t pid;
+    double k_i = ki * dt / PID_REF_DT, k_d = kd * PID_REF_DT / dt;
+    Ref_Pid_t ref = { kp + k_i + k_d, -kp - 2.0 * k_d, k_d, 0.0, 0.0, 0.0, max_out };
+    double max_diff = 0.0, sum2 = 0.0;
+    int i, sat = 0;
+
+    PID_Init(&pid, kp, ki, kd, max_out, max_out);
+    PID_Kernel_Init(&pid, dt);
+    srand(1);
+    for (i = 0; i < ACC_STEPS; i++) {
+        float e = (float)(amp * sin(i * 0.01) + amp * 0.1 * ((rand() % 2001) / 1000.0 - 1.0));
+        float u = PID_Kernel_Run(&pid, 100.0f, 100.0f - e, dt);
+        double y = Ref_Run(&ref, 100.0f - (100.0f - e));    // 与后端相同的单精度误差
+        double d = fabs(u - y);
+
+        if (fabs(y) >= max_out) sat++;
+        if (d > max_diff) max_diff = d;
+        sum2 += d * d;
+    }
+    printf("  %-26s  %9.4f  %9.4f  %8.2e  %5.1f%%\n", name, max_diff, sqrt(sum2 / ACC_STEPS),
+           max_diff / max_out, 100.0 * sat / ACC_STEPS);
+    return max_diff / max_out;
+}
+
+static int Check_Accuracy(void)
+{
+    double worst = 0.0, r;
+
+    printf("  %-26s  %9s  %9s  %8s  %6s\n", "loop", "max|diff|", "rms", "max/lim", "sat");
+    r = Accuracy_Run("speed 1kHz Kp40 Ki40", 40.0f, 40.0f, 0.0f, SPEED_MAX_OUT, SPEED_DT, 1.0);
+    if (r > worst) worst = r;
+    r = Accuracy_Run("speed 1kHz saturated", 40.0f, 40.0f, 0.0f, SPEED_MAX_OUT, SPEED_DT, 40.0);
+    if (r > worst) worst = r;
+    r = Accuracy_Run("speed 1kHz Kd 0.5", 40.0f, 40.0f, 0.5f, SPEED_MAX_OUT, SPEED_DT, 0.5);
+    if (r > worst) worst = r;
+    r = Accuracy_Run("dist 30Hz 2/0.1/0.5", 2.0f, 0.1f, 0.5f, DIST_MAX_OUT, VISION_DT, 3.0);
+    if (r > worst) worst = r;
+    /* 角度误差为图像中心与目标 X 之差，不超过 ±80 像素 (定点后端超出输入满量程的误差被截断) */
+    r = Accuracy_Run("angle 30Hz saturated", 1.5f, 0.0f, 0.3f, ANGLE_MAX_OUT, VISION_DT, 72.0);
+    if (r > worst) worst = r;
+    return worst > ACC_TOL;
+}
+#endif
+
+/* ---------------- 2. 闭环 ---------------- */
+
+typedef struct {
+    double w;                       // 转速 (RPM)
+    double pos;                     // 累计计数
+    long   last_cnt;
+    int    hist[SIM_WINDOW];
+    int    idx;
+    int    sum;
+} Motor_Sim_t;
+
+/**
+ * @brief 推进一个周期，返回测得转速 (RPM)
+ */
+static float Motor_Tick(Motor_Sim_t *s, float u, double load)
+{
+    const double h = SPEED_DT / SIM_SUBSTEPS;
+    int i;
+
+    for (i = 0; i < SIM_SUBSTEPS; i++) {
+        s->w += h * (SIM_K * u - load - s->w) / SIM_TAU;
+        s->pos += s->w / 60.0 * SIM_CPR * h;
+    }
+
+    long cnt = (long)floor(s->pos);
+    int d = (int)(cnt - s->last_cnt);
+    s->last_cnt = cnt;
+    s->sum += d - s->hist[s->idx];
+    s->hist[s->idx] = d;
+    s->idx = (s->idx + 1) % SIM_WINDOW;
+    return (float)(s->sum * 60.0 / (SIM_CPR * SIM_WINDOW * SPEED_DT));
+}
+
+static void Closed_Loop_Run(float kp, float ki)
+{
+    Motor_Sim_t s = { 0 };
+    PID_Controller_t pid;
+    float y = 0.0f;
+    double sum2 = 0.0, tail = 0.0;
+    int i, n = (int)(SIM_TIME / SPEED_DT + 0.5), n_tail = (int)(0.2 / SPEED_DT + 0.5);
+
+    PID_Init(&pid, kp, ki, 0.0f, SPEED_MAX_OUT, 2000.0f);
+    PID_Kernel_Init(&pid, SPEED_DT);
+    for (i = 0; i < n; i++) {
+        double load = (i * SPEED_DT >= SIM_LOAD_TIME) ? SIM_LOAD : 0.0;
+        float u = PID_Kernel_Run(&pid, SIM_TARGET, y, SPEED_DT);
+
+        y = Motor_Tick(&s, u, load);
+        sum2 += (SIM_TARGET - s.w) * (SIM_TARGET - s.w);
+        if (i >= n - n_tail) tail += SIM_TARGET - s.w;
+    }
+    printf("  Kp %4.1f Ki %4.1f   rms error %6.2f rpm, final error %6.2f rpm\n",
+           kp, ki, sqrt(sum2 / n), tail / n_tail);
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    printf("backend %s\n", backend_name[PID_CFG_BACKEND]);
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+    printf("== accuracy vs double velocity-form reference, %d steps\n", ACC_STEPS);
+    fail |= Check_Accuracy();
+#endif
+    printf("== closed loop: 1 kHz speed loop, step to %.0f rpm, %.0f rpm load at %.1f s\n",
+           SIM_TARGET, SIM_LOAD, SIM_LOAD_TIME);
+    Closed_Loop_Run(40.0f, 40.0f);
+    Closed_Loop_Run(5.0f, 2.5f);
+#if PID_CFG_BACKEND != PID_BACKEND_FLOAT
+    printf("%s\n", fail ? "FAIL" : "PASS");
+#endif
+    return fail;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file    pid_update_check.c
+ * @brief   上位机检查：PID_Update (Core/Algo/pid.c) 的兼容性、微分冲击、抗饱和与周期无关性，
+ *          与原 PID_Compute_Dt 实现对比
+ * @note    原实现 (对误差微分、积分只做硬限幅) 按原代码照搬在本文件中。
+ *          被控对象为一阶惯性 y' = (u - y) / PLANT_TAU，以 0.1ms 步长积分，
+ *          控制器按各自周期采样 (零阶保持)，0.1s 时设定值 0 -> 100：
+ *            1. 兼容：PID_Compute 与 dt = PID_REF_DT 的 PID_Update 逐次输出相同
+ *            2. 微分冲击：Kp 1 / Ki 0.5 / Kd 0.5，dt = 10ms，设定值阶跃后的第一次输出
+ *               (原实现对误差微分，输出中含 Kd * Δe / (dt/PID_REF_DT)；新实现对测量值微分)
+ *            3. PID_Reset 之后第一次计算不产生微分冲击
+ *            4. 抗饱和：Kp 1 / Ki 3，dt = 1ms，输出限幅 110 (稳态需要 100)，
+ *               比较超调和进入 ±2% 的调节时间
+ *            5. 周期无关：Kp 1 / Ki 0.5 / Kd 0.05，dt = 1/5/25ms，不限幅，超调与调节时间
+ *          检查项 (1、3 逐位相同；2 第一次输出等于 Kp * 误差；4 超调和调节时间都小于原实现)
+ *          不满足时返回非 0。
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Algo -o pid_update_check tools/pid_update_check.c Core/Algo/pid.c -lm
+ *          使用：
+ *            ./pid_update_check
+ */
+
+#include "pid.h"
+#include <math.h>
+#include <stdio.h>
+
+#define PLANT_TAU       0.05        // 被控对象时间常数 (s)
+#define SIM_H           1e-4        // 积分步长 (s)
+#define SIM_TIME        3.0         // 仿真时长 (s)
+#define STEP_TIME       0.1         // 设定值阶跃时刻 (s)
+#define STEP_TARGET     100.0
+#define SETTLE_BAND     2.0         // 调节时间的误差带 (±2%)
+
+/* ---------------- 原实现 ---------------- */
+
+static float Old_Compute_Dt(PID_Controller_t *pid, float target, float actual, float dt)
+{
+    float k = dt / PID_REF_DT;
+
+    if (k <= 0.0f) {
+        return pid->output;
+    }
+
+    pid->target = target;
+    pid->actual = actual;
+    pid->error = pid->target - pid->actual;
+
+    pid->integral += pid->error * k;
+    if (pid->integral > pid->max_integral) {
+        pid->integral = pid->max_integral;
+    } else if (pid->integral < -pid->max_integral) {
+        pid->integral = -pid->max_integral;
+    }
+
+    float derivative = (pid->error - pid->prev_error) / k;
+
+    pid->output = (pid->Kp * pid->error) +
+                  (pid->Ki * pid->integral) +
+                  (pid->Kd * derivative);
+
+    if (pid->output > pid->max_output) {
+        pid->output = pid->max_output;
+    } else if (pid->output < -pid->max_output) {
+        pid->output = -pid->max_output;
+    }
+
+    pid->prev_error = pid->error;
+    return pid->output;
+}
+
+/* ---------------- 阶跃仿真 ---------------- */
+
+typedef struct {
+    double overshoot;       // 超调
+    double settle;          // 阶跃后进入误差带的时间 (s)
+    double first_u;         // 设定值阶跃后的第一次输出
+} Step_Result_t;
+
+/**
+ * @brief 闭环阶跃，use_new 选择 PID_Update 或原实现
+ */
+static void Step_Run(int use_new, double dt, float kp, float ki, float kd, float umax,
+                     Step_Result_t *res)
+{
+    PID_Controller_t pid;
+    double y = 0.0, u = 0.0, next = 0.0, last_out = 0.0;
+    int i, n = (int)(SIM_TIME / SIM_H), stepped = 0;
+
+    PID_Init(&pid, kp, ki, kd, umax, 2000.0f);
+    res->overshoot = 0.0;
+    res->first_u = 0.0;
+    for (i = 0; i < n; i++) {
+        double t = i * SIM_H;
+        float r = (t < STEP_TIME) ? 0.0f : (float)STEP_TARGET;
+
+        if (t >= next - 0.5 * SIM_H) {
+            next += dt;
+            u = use_new ? PID_Update(&pid, r, (float)y, (float)dt)
+                        : Old_Compute_Dt(&pid, r, (float)y, (float)dt);
+            if (r > 0.0f && !stepped) {
+                res->first_u = u;
+                stepped = 1;
+            }
+        }
+        y += SIM_H * (u - y) / PLANT_TAU;
+        if (y - STEP_TARGET > res->overshoot) res->overshoot = y - STEP_TARGET;
+        if (fabs(y - STEP_TARGET) > SETTLE_BAND * STEP_TARGET / 100.0) last_out = t;
+    }
+    res->settle = last_out - STEP_TIME;
+}
+
+/* ---------------- 检查项 ---------------- */
+
+static int Check_Compat(void)
+{
+    PID_Controller_t a, b;
+    int i, bad = 0;
+
+    PID_Init(&a, 2.0f, 0.3f, 0.5f, 100.0f, 50.0f);
+    PID_Init(&b, 2.0f, 0.3f, 0.5f, 100.0f, 50.0f);
+    for (i = 0; i < 1000; i++) {
+        float r = (i < 500) ? 10.0f : -30.0f;
+        float y = 20.0f * sinf(i * 0.05f);
+
+        bad |= (PID_Compute(&a, r, y) != PID_Update(&b, r, y, PID_REF_DT));
+    }
+    printf("  PID_Compute vs PID_Update(dt = %.0f ms), 1000 steps: %s\n",
+           PID_REF_DT * 1000.0, bad ? "differ" : "identical");
+    return bad;
+}
+
+static int Check_Kick(void)
+{
+    const float kp = 1.0f, ki = 0.5f, kd = 0.5f;
+    Step_Result_t r_old, r_new;
+
+    Step_Run(0, 0.01, kp, ki, kd, 1e6f, &r_old);
+    Step_Run(1, 0.01, kp, ki, kd, 1e6f, &r_new);
+    printf("  first output after the step (Kp*e = %.0f): old %.0f, new %.0f\n",
+           kp * STEP_TARGET, r_old.first_u, r_new.first_u);
+    return fabs(r_new.first_u - kp * STEP_TARGET) > 1e-3;
+}
+
+static int Check_Reset(void)
+{
+    PID_Controller_t pid;
+    float u;
+    int i;
+
+    PID_Init(&pid, 1.0f, 0.0f, 0.5f, 1000.0f, 100.0f);
+    PID_SetDFilter(&pid, 0.02f);
+    for (i = 0; i < 50; i++) {
+        PID_Update(&pid, 0.0f, 20.0f, 0.01f);
+    }
+    PID_Reset(&pid);
+    u = PID_Update(&pid, 0.0f, 80.0f, 0.01f);
+    printf("  first output after PID_Reset at y = 80 (Kp*e = -80): %.3f\n", u);
+    return u != -80.0f;
+}
+
+static int Check_Windup(void)
+{
+    Step_Result_t r_old, r_new;
+
+    Step_Run(0, 0.001, 1.0f, 3.0f, 0.0f, 110.0f, &r_old);
+    Step_Run(1, 0.001, 1.0f, 3.0f, 0.0f, 110.0f, &r_new);
+    printf("  clamp only        : overshoot %5.1f, settle %4.0f ms\n", r_old.overshoot, r_old.settle * 1000.0);
+    printf("  back-calculation  : overshoot %5.1f, settle %4.0f ms\n", r_new.overshoot, r_new.settle * 1000.0);
+    return r_new.overshoot >= r_old.overshoot || r_new.settle >= r_old.settle;
+}
+
+static void Report_Rate(void)
+{
+    static const double dts[] = { 0.001, 0.005, 0.025 };
+    size_t i;
+
+    printf("  dt      old overshoot/settle   new overshoot/settle\n");
+    for (i = 0; i < sizeof(dts) / sizeof(dts[0]); i++) {
+        Step_Result_t r_old, r_new;
+
+        Step_Run(0, dts[i], 1.0f, 0.5f, 0.05f, 1e6f, &r_old);
+        Step_Run(1, dts[i], 1.0f, 0.5f, 0.05f, 1e6f, &r_new);
+        printf("  %2.0f ms  %6.1f / %4.0f ms        %6.1f / %4.0f ms\n", dts[i] * 1000.0,
+               r_old.overshoot, r_old.settle * 1000.0, r_new.overshoot, r_new.settle * 1000.0);
+    }
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    printf("== compatibility\n");
+    fail |= Check_Compat();
+    printf("== derivative kick: setpoint step 0 -> %.0f, Kd 0.5, dt 10 ms\n", STEP_TARGET);
+    fail |= Check_Kick();
+    fail |= Check_Reset();
+    printf("== windup: Kp 1 Ki 3, dt 1 ms, output limit 110\n");
+    fail |= Check_Windup();
+    printf("== loop rate: Kp 1 Ki 0.5 Kd 0.05, unsaturated\n");
+    Report_Rate();
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
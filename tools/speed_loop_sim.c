@@ -0,0 +1,167 @@
+/**
+ * @file    speed_loop_sim.c
+ * @brief   上位机仿真：速度环 50ms (原 TIM14 节拍) 与 1kHz (App_Follow_Speed_Loop) 的阶跃与抗扰对比
+ * @note    电机按一阶惯性建模 (300 RPM 满量程、时间常数 40ms)，负载按 RPM 当量从驱动中扣除，
+ *          以 10us 步长积分；编码器 2200 CPR 计数取整。两种回路都调用 PID_Update (Core/Algo/pid.c)：
+ *            50ms   每 50ms 取一次计数增量测速，dt = 50ms (原做法，PID_Compute)
+ *            1kHz   每 1ms 采样，按 10 拍滑动窗口测速 (同 Bsp_Encoder)，dt = 1ms
+ *          目标轮速直接给定，不经视觉外环；前馈为 0 (Flash 默认)。
+ *          工况：0.2s 目标 0 -> 100 RPM，1.0s 加 40 RPM 负载，1.5s 目标降到 50 RPM，共 2s。
+ *          指标 (按电机真实转速)：
+ *            rise     0.2s 后到达 90 RPM 的时间
+ *            os       1.0s 前的超调
+ *            dip      加负载后 (1.0~1.5s) 的最大跌落
+ *            recover  加负载后回到并保持在 100 RPM ±5% 内的时间
+ *            rms      0.2s 后的转速误差 RMS
+ *          增益按 PID_REF_DT (50ms) 整定，两种节拍下含义相同：Flash 默认 Kp5/Ki2.5、
+ *          50ms 下的较优值 Kp10/Ki10 (再高即振荡)、1kHz 下的 Kp40/Ki40。
+ *          检查项 (1kHz Kp40/Ki40 的 rms 与 dip 都小于 50ms Kp10/Ki10) 不满足时返回非 0。
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Algo -o speed_loop_sim tools/speed_loop_sim.c Core/Algo/pid.c -lm
+ *          使用：
+ *            ./speed_loop_sim [Kp Ki]       另加一组增益在两种节拍下的结果
+ */
+
+#include "pid.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIM_H           1e-5        // 积分步长 (s)
+#define SIM_TIME        2.0         // 仿真时长 (s)
+#define SIM_CPR         2200.0      // 每转编码器计数 (11 * 4 * 50)
+#define SIM_WINDOW      10          // 1kHz 测速滑动窗口 (采样次数)
+#define SIM_PWM_MAX     4200.0f
+#define SIM_INT_MAX     2000.0f     // 同固件 App_Follow_Init
+
+#define MOTOR_K         (300.0 / 4200.0)    // 稳态增益 (RPM / PWM)
+#define MOTOR_TAU       0.040               // 机械时间常数 (s)
+
+#define T_STEP          0.2         // 目标 0 -> 100 RPM
+#define T_LOAD          1.0         // 加负载
+#define T_DOWN          1.5         // 目标 100 -> 50 RPM
+#define LOAD_RPM        40.0
+
+#define N_STEPS         200000      // SIM_TIME / SIM_H
+
+typedef struct {
+    double rise;        // s，< 0 表示未到达
+    double overshoot;   // RPM
+    double dip;         // RPM
+    double recover;     // s，< 0 表示未恢复
+    double rms;         // RPM
+} Result_t;
+
+static double Target(double t)
+{
+    return (t < T_STEP) ? 0.0 : ((t < T_DOWN) ? 100.0 : 50.0);
+}
+
+static double Load(double t)
+{
+    return (t >= T_LOAD) ? LOAD_RPM : 0.0;
+}
+
+static double w_log[N_STEPS];
+
+/**
+ * @brief 运行一种回路，period 为控制周期 (s)，window 为测速窗口 (周期数)
+ */
+static void Run(double period, int window, float kp, float ki, Result_t *res)
+{
+    PID_Controller_t pid;
+    int hist[SIM_WINDOW] = { 0 };
+    int hist_idx = 0, hist_sum = 0;
+    int i, j, every = (int)(period / SIM_H + 0.5);
+    double w = 0.0, pos = 0.0, u = 0.0, se = 0.0;
+    long last_cnt = 0;
+    int n_err = 0;
+
+    PID_Init(&pid, kp, ki, 0.0f, SIM_PWM_MAX, SIM_INT_MAX);
+    for (i = 0; i < N_STEPS; i++) {
+        double t = i * SIM_H;
+
+        if (i % every == 0) {
+            long cnt = (long)floor(pos);
+            int d = (int)(cnt - last_cnt);
+
+            last_cnt = cnt;
+            hist_sum += d - hist[hist_idx];
+            hist[hist_idx] = d;
+            hist_idx = (hist_idx + 1) % window;
+            u = PID_Update(&pid, (float)Target(t),
+                           (float)(hist_sum * 60.0 / (SIM_CPR * period * window)), (float)period);
+        }
+        w += SIM_H * (MOTOR_K * u - Load(t) - w) / MOTOR_TAU;
+        pos += w / 60.0 * SIM_CPR * SIM_H;
+        w_log[i] = w;
+        if (t >= T_STEP) {
+            se += (w - Target(t)) * (w - Target(t));
+            n_err++;
+        }
+    }
+
+    res->rise = -1.0;
+    res->overshoot = 0.0;
+    res->dip = 0.0;
+    res->recover = -1.0;
+    res->rms = sqrt(se / n_err);
+    for (i = (int)(T_STEP / SIM_H); i < (int)(T_LOAD / SIM_H); i++) {
+        if (res->rise < 0.0 && w_log[i] >= 90.0) res->rise = i * SIM_H - T_STEP;
+        if (w_log[i] - 100.0 > res->overshoot) res->overshoot = w_log[i] - 100.0;
+    }
+    for (i = (int)(T_LOAD / SIM_H); i < (int)(T_DOWN / SIM_H); i++) {
+        if (100.0 - w_log[i] > res->dip) res->dip = 100.0 - w_log[i];
+    }
+    /* 从后往前找最后一次超出 ±5% 的时刻 */
+    for (j = (int)(T_DOWN / SIM_H) - 1; j >= (int)(T_LOAD / SIM_H); j--) {
+        if (fabs(w_log[j] - 100.0) > 5.0) break;
+    }
+    if (j < (int)(T_DOWN / SIM_H) - 1) {
+        res->recover = (j + 1) * SIM_H - T_LOAD;
+    }
+}
+
+static void Print(const char *loop, float kp, float ki, const Result_t *r)
+{
+    char rise[16], recover[16];
+
+    if (r->rise < 0.0) snprintf(rise, sizeof(rise), "%7s", "-");
+    else snprintf(rise, sizeof(rise), "%7.0f", r->rise * 1000.0);
+    if (r->recover < 0.0) snprintf(recover, sizeof(recover), "%9s", "> 500");
+    else snprintf(recover, sizeof(recover), "%9.0f", r->recover * 1000.0);
+    printf("  %-5s  %5.1f %5.1f  %s  %6.1f  %6.1f  %s  %7.2f\n",
+           loop, kp, ki, rise, r->overshoot, r->dip, recover, r->rms);
+}
+
+int main(int argc, char **argv)
+{
+    static const float gains[][2] = { { 5.0f, 2.5f }, { 10.0f, 10.0f }, { 40.0f, 40.0f } };
+    Result_t slow[4], fast[4];
+    size_t i, n = sizeof(gains) / sizeof(gains[0]);
+    float kp[4], ki[4];
+
+    for (i = 0; i < n; i++) {
+        kp[i] = gains[i][0];
+        ki[i] = gains[i][1];
+    }
+    if (argc > 2) {
+        kp[n] = (float)atof(argv[1]);
+        ki[n] = (float)atof(argv[2]);
+        n++;
+    }
+
+    printf("step 0 -> 100 rpm at %.1f s, %.0f rpm load at %.1f s, 50 rpm at %.1f s\n",
+           T_STEP, LOAD_RPM, T_LOAD, T_DOWN);
+    printf("  %-5s  %5s %5s  %7s  %6s  %6s  %9s  %7s\n",
+           "loop", "Kp", "Ki", "rise ms", "os", "dip", "recov ms", "rms rpm");
+    for (i = 0; i < n; i++) {
+        Run(0.05, 1, kp[i], ki[i], &slow[i]);
+        Run(0.001, SIM_WINDOW, kp[i], ki[i], &fast[i]);
+        Print("50ms", kp[i], ki[i], &slow[i]);
+        Print("1kHz", kp[i], ki[i], &fast[i]);
+    }
+    /* 1kHz 的 Kp40/Ki40 与 50ms 下的较优值 Kp10/Ki10 比较 */
+    return !(fast[2].rms < slow[1].rms && fast[2].dip < slow[1].dip);
+}
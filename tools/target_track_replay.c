@@ -0,0 +1,295 @@
+/**
+ * @file    target_track_replay.c
+ * @brief   上位机回放测试：视觉目标跟踪器 (Core/Algo/target_track.c) 的跟踪误差对比
+ * @note    按固件 App_Follow_Vision_Loop 的用法逐帧运行跟踪器 (同一份参数)，与两种基线对比：
+ *            raw   直接使用测量值 (跟踪器加入之前的做法)
+ *            rate  测量值 + 一阶低通差分速率外推 (VISION_XRATE_TF)
+ *            kf    卡尔曼跟踪器估计 / 预测
+ *          指标：
+ *            1. 一步预测误差：在帧 k 预测帧 k+1 时刻的位置，与帧 k+1 的测量比较
+ *               (不需要真值，可用于实录日志；测量噪声和野值也计入，只宜横向比较)
+ *            2. 仿真数据另有真值：帧时刻估计误差、超前 LEAD_MS (补偿延迟) 的预测误差
+ *
+ *          实录日志：固件串口命令 VLOG:1 后，每帧输出一条 TR_VISION_FRAME trace，
+ *          用 trace_decode 解码保存即可 (只读取含 "VIS:" 的行，其余忽略)：
+ *            ./trace_decode < /dev/ttyUSB0 > vis.log
+ *          帧时刻：v2 帧用相机时间戳 ts (ms)，v1 帧用 trace 时间减去 age
+ *
+ *          编译 (Linux，在仓库根目录执行)：
+ *            gcc -O2 -ICore/Algo -o target_track_replay tools/target_track_replay.c \
+ *                Core/Algo/target_track.c -lm
+ *          使用：
+ *            ./target_track_replay              仿真数据 (含野值、丢帧)
+ *            ./target_track_replay vis.log      回放实录日志
+ */
+
+#include "target_track.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 基线 rate 的低通时间常数 (跟踪器加入之前固件的做法) */
+#define VISION_XRATE_TF     0.1f
+
+/* 以下与固件 app_follow.c 相同 */
+#define VISION_DT_MAX_MS    200.0
+#define TRACK_COAST_MS      150.0
+static const Track_Cfg_t track_cfg_x    = { 20000.0f, 4.0f, 10000.0f, 9.0f, 3 };
+static const Track_Cfg_t track_cfg_dist = { 400.0f,   4.0f, 400.0f,   9.0f, 3 };
+
+#define MAX_FRAMES      200000
+#define SIM_FRAMES      20000
+#define LEAD_MS         60.0        // 外推量，约为相机处理 + 传输 + 计算的总延迟
+
+/* 一帧视觉数据 */
+typedef struct {
+    double  t_ms;           // 帧时刻
+    float   z[2];           // 测量：X、距离
+    uint8_t conf;           // 0 未找到目标
+    uint8_t has_truth;
+    double  truth[2];       // 帧时刻真值
+    double  truth_lead[2];  // t + LEAD_MS 时刻真值
+} Frame_t;
+
+static Frame_t frames[MAX_FRAMES];
+static int     n_frames;
+
+/* 误差累计 */
+typedef struct {
+    double sum2;
+    double max;
+    int    n;
+} Err_t;
+
+static void Err_Add(Err_t *e, double v)
+{
+    e->sum2 += v * v;
+    if (fabs(v) > e->max) e->max = fabs(v);
+    e->n++;
+}
+
+static double Err_Rms(const Err_t *e)
+{
+    return e->n ? sqrt(e->sum2 / e->n) : 0.0;
+}
+
+/* ---------------- 仿真数据 ---------------- */
+
+static uint32_t rng_state = 0x2468ACE1U;
+
+static double Rand_U(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state >> 8) * (1.0 / 16777216.0);
+}
+
+static double Rand_N(void)
+{
+    double u1 = Rand_U() + 1e-12, u2 = Rand_U();
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+/**
+ * @brief 目标真值：X 在图像中左右摆动并偶尔急转，距离缓慢变化
+ */
+static void Sim_Truth(double t_ms, double out[2])
+{
+    double t = t_ms * 0.001;
+    double turn = fmod(t, 7.0) < 0.6 ? 40.0 * sin(fmod(t, 7.0) / 0.6 * 3.14159265) : 0.0;
+
+    out[0] = 80.0 + 35.0 * sin(0.9 * t) + 12.0 * sin(2.3 * t + 1.0) + turn;
+    out[1] = 45.0 + 20.0 * sin(0.35 * t) + 5.0 * sin(1.7 * t);
+}
+
+/**
+ * @brief 生成仿真帧：约 30 帧/秒带抖动，量化到整数，X 噪声 1.5 像素、距离 2cm，
+ *        3% 野值 (误检)，5% 丢帧 (conf = 0)
+ */
+static void Sim_Generate(void)
+{
+    double t = 0.0;
+    int i, k;
+
+    for (i = 0; i < SIM_FRAMES; i++) {
+        Frame_t *f = &frames[i];
+
+        t += 33.3 + 3.0 * Rand_N();
+        f->t_ms = t;
+        f->has_truth = 1;
+        Sim_Truth(t, f->truth);
+        Sim_Truth(t + LEAD_MS, f->truth_lead);
+        f->conf = (Rand_U() < 0.05) ? 0 : 200;
+        f->z[0] = (float)floor(f->truth[0] + 1.5 * Rand_N() + 0.5);
+        f->z[1] = (float)floor(f->truth[1] + 2.0 * Rand_N() + 0.5);
+        if (Rand_U() < 0.03) {
+            k = (Rand_U() < 0.5) ? 0 : 1;
+            f->z[k] = (float)floor(Rand_U() * (k == 0 ? 160.0 : 200.0));
+        }
+    }
+    n_frames = SIM_FRAMES;
+}
+
+/* ---------------- 日志读取 ---------------- */
+
+static int Load_Log(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    double ts_base = 0.0;
+    int have_ts = 0;
+    unsigned last_ts = 0;
+
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    n_frames = 0;
+    while (fgets(line, sizeof(line), fp) && n_frames < MAX_FRAMES) {
+        const char *p = strstr(line, "VIS:");
+        unsigned ver, seq, ts, x, dist, conf, age;
+        double t_line = 0.0;
+        Frame_t *f = &frames[n_frames];
+
+        if (p == NULL ||
+            sscanf(p, "VIS: v%u seq=%u ts=%u x=%u dist=%u conf=%u age=%u",
+                   &ver, &seq, &ts, &x, &dist, &conf, &age) != 7) {
+            continue;
+        }
+        (void)seq;
+        sscanf(line, "[%lf]", &t_line);
+
+        if (ver >= 2) {
+            /* 展开 16 位毫秒时间戳 */
+            if (have_ts) {
+                ts_base += (double)(uint16_t)(ts - last_ts);
+            }
+            have_ts = 1;
+            last_ts = ts;
+            f->t_ms = ts_base;
+        } else {
+            f->t_ms = t_line * 1000.0 - age;
+        }
+        f->z[0] = (float)x;
+        f->z[1] = (float)dist;
+        f->conf = (uint8_t)conf;
+        f->has_truth = 0;
+        n_frames++;
+    }
+    fclose(fp);
+    return n_frames;
+}
+
+/* ---------------- 回放 ---------------- */
+
+/**
+ * @brief 按固件的方式运行三种估计器并统计误差
+ */
+static void Replay(const char *title)
+{
+    static const char *const axis_name[2] = { "x (px)", "dist (cm)" };
+    Track_1D_t trk[2];
+    Err_t step[3][2], now[3][2], lead[3][2];
+    float rate[2] = { 0.0f, 0.0f }, last_z[2] = { 0.0f, 0.0f };
+    double last_t = 0.0;
+    int have_last = 0, i, a, m, coast = 0, stops = 0;
+
+    memset(step, 0, sizeof(step));
+    memset(now, 0, sizeof(now));
+    memset(lead, 0, sizeof(lead));
+    Track_Init(&trk[0], &track_cfg_x);
+    Track_Init(&trk[1], &track_cfg_dist);
+
+    for (i = 0; i < n_frames; i++) {
+        const Frame_t *f = &frames[i];
+        double dt_ms = f->t_ms - last_t;
+        float est[3][2];
+
+        if (f->conf == 0) {
+            /* 丢帧：跟踪器在 TRACK_COAST_MS 内按预测继续，否则停车 */
+            if (have_last && dt_ms <= TRACK_COAST_MS && trk[0].valid && trk[1].valid) {
+                coast++;
+            } else {
+                stops++;
+            }
+            continue;
+        }
+
+        /* 1. 一步预测误差 (用上一帧结束时的状态预测本帧) */
+        if (have_last && dt_ms < VISION_DT_MAX_MS) {
+            for (a = 0; a < 2; a++) {
+                Err_Add(&step[0][a], last_z[a] - f->z[a]);
+                Err_Add(&step[1][a], last_z[a] + rate[a] * dt_ms * 0.001 - f->z[a]);
+                Err_Add(&step[2][a], Track_Predict_At(&trk[a], (float)(dt_ms * 0.001)) - f->z[a]);
+            }
+        }
+
+        /* 2. 更新估计器 (与 App_Follow_Latency_Update 相同) */
+        for (a = 0; a < 2; a++) {
+            if (!have_last || dt_ms >= VISION_DT_MAX_MS) {
+                Track_Reset(&trk[a]);
+                rate[a] = 0.0f;
+            } else {
+                float dt = (float)(dt_ms * 0.001);
+                float raw = (f->z[a] - last_z[a]) / dt;
+                rate[a] += dt / (VISION_XRATE_TF + dt) * (raw - rate[a]);
+                Track_Predict(&trk[a], dt);
+            }
+            Track_Update(&trk[a], f->z[a]);
+            last_z[a] = f->z[a];
+        }
+        last_t = f->t_ms;
+        have_last = 1;
+
+        /* 3. 与真值比较 */
+        if (!f->has_truth) {
+            continue;
+        }
+        for (a = 0; a < 2; a++) {
+            est[0][a] = f->z[a];
+            est[1][a] = f->z[a];
+            est[2][a] = trk[a].p;
+            for (m = 0; m < 3; m++) {
+                Err_Add(&now[m][a], est[m][a] - f->truth[a]);
+            }
+            Err_Add(&lead[0][a], f->z[a] - f->truth_lead[a]);
+            Err_Add(&lead[1][a], f->z[a] + rate[a] * LEAD_MS * 0.001 - f->truth_lead[a]);
+            Err_Add(&lead[2][a], Track_Predict_At(&trk[a], (float)(LEAD_MS * 0.001)) - f->truth_lead[a]);
+        }
+    }
+
+    printf("== %s: %d frames, coast %d, stop %d\n", title, n_frames, coast, stops);
+    for (a = 0; a < 2; a++) {
+        printf("  %-9s  kf: updates %u rejects %u inits %u\n", axis_name[a],
+               (unsigned)trk[a].updates, (unsigned)trk[a].rejects, (unsigned)trk[a].inits);
+        printf("    %-28s %9s %9s %9s\n", "RMS / max", "raw", "rate", "kf");
+        printf("    %-28s %4.2f/%-4.0f %4.2f/%-4.0f %4.2f/%-4.0f\n", "next-frame prediction",
+               Err_Rms(&step[0][a]), step[0][a].max, Err_Rms(&step[1][a]), step[1][a].max,
+               Err_Rms(&step[2][a]), step[2][a].max);
+        if (now[0][a].n) {
+            printf("    %-28s %4.2f/%-4.0f %4.2f/%-4.0f %4.2f/%-4.0f\n", "estimate vs truth",
+                   Err_Rms(&now[0][a]), now[0][a].max, Err_Rms(&now[1][a]), now[1][a].max,
+                   Err_Rms(&now[2][a]), now[2][a].max);
+            printf("    %-28s %4.2f/%-4.0f %4.2f/%-4.0f %4.2f/%-4.0f\n", "prediction +60ms vs truth",
+                   Err_Rms(&lead[0][a]), lead[0][a].max, Err_Rms(&lead[1][a]), lead[1][a].max,
+                   Err_Rms(&lead[2][a]), lead[2][a].max);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        if (Load_Log(argv[1]) <= 0) {
+            fprintf(stderr, "no VIS frames in %s\n", argv[1]);
+            return 1;
+        }
+        Replay(argv[1]);
+    } else {
+        Sim_Generate();
+        Replay("simulated");
+    }
+    return 0;
+}
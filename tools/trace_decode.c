@@ -0,0 +1,218 @@
+/**
+ * @file    trace_decode.c
+ * @brief   上位机 trace 解码工具：把 USART1 上的二进制 trace 帧还原成文本
+ * @note    与固件共用 Core/App/app_trace_fmt.h 中的格式串表，帧格式见 app_trace.h。
+ *          非 trace 帧的字节 (printf / App_Log 文本) 原样输出。
+ *
+ *          编译 (Linux)：
+ *            gcc -O2 -ICore/App -o trace_decode tools/trace_decode.c   (在仓库根目录执行)
+ *          使用：
+ *            stty -F /dev/ttyUSB0 115200 raw -echo
+ *            ./trace_decode [-c 内核频率Hz] [-n] < /dev/ttyUSB0
+ *          -c 默认 168000000，用于把 DWT 周期数换算成秒；-n 不打印时间戳
+ */
+
+#include "app_trace_fmt.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_SYNC          0xA5U
+#define TRACE_MAX_ARGS      8
+#define TRACE_FRAME_LEN(n)  (9U + 4U * (n))
+
+#define TRACE_FMT_STR(id, fmt) fmt,
+static const char *const trace_fmt[] = {
+    TRACE_FMT_TABLE(TRACE_FMT_STR)
+};
+#undef TRACE_FMT_STR
+
+#define TRACE_FMT_COUNT     (sizeof(trace_fmt) / sizeof(trace_fmt[0]))
+
+static uint8_t  frame[TRACE_FRAME_LEN(TRACE_MAX_ARGS)];
+static uint32_t frame_len;
+
+static double   core_hz    = 168000000.0;
+static int      show_time  = 1;
+static int      have_time  = 0;
+static uint32_t last_cyc;
+static uint64_t total_cyc;          // 展开 32 位 CYCCNT 回绕后的累计周期数
+
+static uint32_t Get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float Bits2Float(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief 按格式串输出一帧的参数
+ */
+static void Render(const char *fmt, const uint32_t *argv, uint32_t argc)
+{
+    uint32_t k = 0;
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            putchar(*fmt++);
+            continue;
+        }
+        if (fmt[1] == '%') {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        /* 取出一个转换说明，去掉长度修饰符 (参数一律是 32 位) */
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && n < sizeof(spec) - 3) {
+            spec[n++] = *fmt++;
+        }
+        while (*fmt && strchr("hlLjzt", *fmt)) {
+            fmt++;
+        }
+        char conv = *fmt;
+        if (conv == '\0') {
+            break;
+        }
+        fmt++;
+        spec[n++] = conv;
+        spec[n]   = '\0';
+
+        if (k >= argc) {
+            fputs("<?>", stdout);
+            continue;
+        }
+        uint32_t v = argv[k++];
+
+        switch (conv) {
+        case 'd': case 'i': case 'c':
+            printf(spec, (int)(int32_t)v);
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            printf(spec, (unsigned)v);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            printf(spec, (double)Bits2Float(v));
+            break;
+        default:
+            printf("<%%%c?>", conv);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 输出一条完整且校验通过的帧
+ */
+static void Emit(void)
+{
+    uint16_t id   = (uint16_t)(frame[1] | (frame[2] << 8));
+    uint32_t argc = frame[3];
+    uint32_t cyc  = Get32(&frame[4]);
+    uint32_t argv[TRACE_MAX_ARGS];
+    uint32_t i;
+
+    for (i = 0; i < argc; i++) {
+        argv[i] = Get32(&frame[8 + 4 * i]);
+    }
+
+    if (have_time) {
+        total_cyc += (uint32_t)(cyc - last_cyc);    // 两帧间隔须小于一次回绕 (168MHz 下约 25s)
+    }
+    have_time = 1;
+    last_cyc  = cyc;
+
+    if (show_time) {
+        printf("[%12.6f] ", (double)total_cyc / core_hz);
+    }
+    Render(trace_fmt[id], argv, argc);
+}
+
+static void Feed(uint8_t b);
+
+/**
+ * @brief 当前缓存的不是合法帧：把同步字节当文本输出，其余字节重新解析
+ */
+static void Resync(void)
+{
+    uint8_t  rest[sizeof(frame)];
+    uint32_t n = frame_len - 1U;
+    uint32_t i;
+
+    memcpy(rest, &frame[1], n);
+    frame_len = 0;
+    putchar(frame[0]);
+    for (i = 0; i < n; i++) {
+        Feed(rest[i]);
+    }
+}
+
+static void Feed(uint8_t b)
+{
+    if (frame_len == 0 && b != TRACE_SYNC) {
+        putchar(b);
+        return;
+    }
+    frame[frame_len++] = b;
+
+    if (frame_len == 3 && (uint32_t)(frame[1] | (frame[2] << 8)) >= TRACE_FMT_COUNT) {
+        Resync();
+        return;
+    }
+    if (frame_len == 4 && frame[3] > TRACE_MAX_ARGS) {
+        Resync();
+        return;
+    }
+    if (frame_len >= 4 && frame_len == TRACE_FRAME_LEN(frame[3])) {
+        uint8_t  sum = 0;
+        uint32_t i;
+        for (i = 1; i < frame_len - 1U; i++) {
+            sum += frame[i];
+        }
+        if (sum == frame[frame_len - 1U]) {
+            frame_len = 0;
+            Emit();
+        } else {
+            Resync();
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int i, c;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            core_hz = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            show_time = 0;
+        } else {
+            fprintf(stderr, "usage: %s [-c core_hz] [-n] < stream\n", argv[0]);
+            return 1;
+        }
+    }
+    if (core_hz <= 0.0) {
+        core_hz = 168000000.0;
+    }
+
+    /* 逐字节解析，串口实时查看时不缓冲输出 */
+    setvbuf(stdout, NULL, _IONBF, 0);
+    while ((c = getchar()) != EOF) {
+        Feed((uint8_t)c);
+    }
+    /* 流结束时残留的半帧按文本输出 */
+    while (frame_len > 0) {
+        Resync();
+    }
+    return 0;
+}